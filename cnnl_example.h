@@ -41,6 +41,41 @@ typedef enum {
   CNNL_LOG_10 = 2, /*!< The base 10 is used.*/
 } cnnlLogBase_t;
 
+/*!
+ * @brief
+ *
+ * Enumeration variables describe the result of ::cnnlDivEps where the divisor \b y + \b eps
+ * is zero.
+ *
+ */
+typedef enum {
+  CNNL_DIV_ZERO_NONE    = 0, /*!< The result is the same as ::cnnlDiv.*/
+  CNNL_DIV_ZERO_AS_ZERO = 1, /*!< The result is 0.*/
+} cnnlDivZeroMode_t;
+
+/*!
+ * @brief
+ *
+ * Enumeration variables describe the rounding of the integer quotient of ::cnnlDivRound.
+ *
+ */
+typedef enum {
+  CNNL_DIV_ROUND_TRUNC = 0, /*!< The quotient is rounded toward zero, as C.*/
+  CNNL_DIV_ROUND_FLOOR = 1, /*!< The quotient is rounded toward negative infinity, as Python.*/
+} cnnlDivRoundMode_t;
+
+/*!
+ * @brief
+ *
+ * Enumeration variables describe the reduction of ::cnnlReduceLastDim.
+ *
+ */
+typedef enum {
+  CNNL_REDUCE_LAST_DIM_SUM       = 0, /*!< The sum of the elements.*/
+  CNNL_REDUCE_LAST_DIM_MAX       = 1, /*!< The max of the elements.*/
+  CNNL_REDUCE_LAST_DIM_LOGSUMEXP = 2, /*!< The log of the sum of the exp of the elements.*/
+} cnnlReduceLastDimOp_t;
+
 /*!
  * @brief Computes the absolute value for every element of the input tensor \b x and returns in \b
  y.
@@ -67,8 +102,12 @@ typedef enum {
  * @par Data Type
  * - Date types of input tensor and output tensor should be the same.
  * - The supported data types of input and output tensors are as follows:
- *   - input tensor: half, float.
- *   - output tensor: half, float.
+ *   - input tensor: half, float, int8, int16, int32.
+ *   - output tensor: half, float, int8, int16, int32.
+ *
+ * @note
+ * - int8 and int16 are computed in float, int32 on its 16-bit halves. All are exact.
+ * - The absolute value of the minimum of an integer type saturates to its maximum.
  *
  * @par Requirements
  * - None.
@@ -96,6 +135,68 @@ cnnlStatus_t CNNL_WIN_API cnnlAbs(cnnlHandle_t handle,
                                   const cnnlTensorDescriptor_t y_desc,
                                   void *y);
 
+/*!
+ * @brief Computes the absolute value and the sign of every element of the input tensor \b x,
+ * and returns them in \b y and \b sign. The input is read once, e.g. for the backward of the L1
+ * and Huber losses.
+ *
+ * @param[in] handle
+ *   Input. Handle to a CNNL context that is used to manage MLU devices and
+ *   queues in the abs sign operation. For detailed information, see ::cnnlHandle_t.
+ * @param[in] x_desc
+ *   Input. The descriptor of the input tensor. For detailed information,
+ *   see ::cnnlTensorDescriptor_t.
+ * @param[in] x
+ *   Input. Pointer to the MLU memory that stores the input tensor.
+ * @param[in] y_desc
+ *   Input. The descriptor of the absolute value tensor. For detailed information,
+ *   see ::cnnlTensorDescriptor_t.
+ * @param[out] y
+ *   Output. Pointer to the MLU memory that stores the absolute value tensor.
+ * @param[in] sign_desc
+ *   Input. The descriptor of the sign tensor. For detailed information,
+ *   see ::cnnlTensorDescriptor_t.
+ * @param[out] sign
+ *   Output. Pointer to the MLU memory that stores the sign tensor.
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM, ::CNNL_STATUS_ARCH_MISMATCH
+ *
+ * @par Formula
+ * - y = |x|, sign = 1 where x > 0, -1 where x < 0, 0 where x is 0, nan where x is nan as
+ *   torch.sign. An int8 sign can not hold nan, it is 0 where x is nan.
+ *
+ * @par Data Type
+ * - Date types of input tensor and \b y should be the same.
+ * - The supported data types of input and output tensors are as follows:
+ *   - input tensor: half, float.
+ *   - y tensor: half, float.
+ *   - sign tensor: the data type of the input tensor, or int8.
+ *
+ * @par Requirements
+ * - The shapes of \b y and \b sign should be the shape of \b x.
+ *
+ * @par Example
+ * - The example of the abs sign operation is as follows:
+     @verbatim
+      input array by 1 * 2 * 3 -->
+          input: [[[5, -11, 0], [-0.5, 1, 6]]]
+
+      output arrays by 1 * 2 * 3 -->
+          y: [[[5, 11, 0], [0.5, 1, 6]]]
+          sign: [[[1, -1, 0], [-1, 1, 1]]]
+     @endverbatim
+ *
+ * @par Reference
+ * - https://www.tensorflow.google.cn/api_docs/python/tf/math/sign
+ */
+cnnlStatus_t CNNL_WIN_API cnnlAbsSign(cnnlHandle_t handle,
+                                      const cnnlTensorDescriptor_t x_desc,
+                                      const void *x,
+                                      const cnnlTensorDescriptor_t y_desc,
+                                      void *y,
+                                      const cnnlTensorDescriptor_t sign_desc,
+                                      void *sign);
+
 /*!
  * @brief Computes logarithm of input tensor \b x, and returns the results in the output tensor \b
  * y.
@@ -138,9 +239,13 @@ cnnlStatus_t CNNL_WIN_API cnnlAbs(cnnlHandle_t handle,
  *   the following input data range:
  *   - float: [1e-20, 2e5].
  *   - half: [1, 60000].
+ * - With ::CNNL_COMPUTATION_APPROX the range is every positive float, subnormal ones included,
+ *   and every positive half. Zero gives -inf, a negative input gives nan, +inf and nan are
+ *   returned as is.
  *
  * @note
- * - None.
+ * - ::CNNL_COMPUTATION_APPROX computes a polynomial of the mantissa instead of the active
+ *   function, the max error is 2.5 ulp for float and 1 ulp for half.
  *
  * @par Requirements
  * - None.
@@ -196,13 +301,14 @@ cnnlStatus_t CNNL_WIN_API cnnlLog(cnnlHandle_t handle,
  * @par Data Type
  * - Data type of input tensors and output tensor must be the same.
  * - The supported data types of input and output tensors are as follows:
- *   - input tensor: half, float.
- *   - output tensor: half, float.
+ *   - input tensor: half, float, int8, int16, int32.
+ *   - output tensor: half, float, int8, int16, int32.
  *
  * @par Scale Limitation
  * - The input tensors and output tensor must have the same shape.
  *
  * @note
+ * - The integer types are divided as ::cnnlDivRound with ::CNNL_DIV_ROUND_TRUNC.
  * - The inputs \b x and \b y are multi-dimensional array, supporting up to CNNL_DIM_MAX dimensions.
  * - When input \b y data type is float, \b y data range is [-1e10,-1e-20] & [1e-20,1e10]. When \b y
  * data type is
@@ -226,6 +332,411 @@ cnnlStatus_t CNNL_WIN_API cnnlDiv(cnnlHandle_t handle,
                                   const cnnlTensorDescriptor_t z_desc,
                                   void *z);
 
+/*!
+ * @brief Computes the reciprocal of input tensor \b x, and returns the results in the output
+ *        tensor \b y.
+ *
+ * The reciprocal uses the same range scaling as ::cnnlDiv, but only reads \b x instead of a
+ * tensor of ones and \b x.
+ *
+ * @param[in] handle
+ *   Input. Handle to a CNNL context that is used to manage MLU devices and queues in the
+ *   reciprocal operation. For detailed information, see ::cnnlHandle_t.
+ * @param[in] prefer
+ *   Input. The \b prefer modes defined in ::cnnlComputationPreference_t enum.
+ * @param[in] x_desc
+ *   Input. The descriptor of the input tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in] x
+ *   Input. Pointer to the MLU memory that stores the input tensor.
+ * @param[in] y_desc
+ *   Input. The descriptor of the output tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[out] y
+ *   Output. Pointer to the MLU memory that stores the output tensor.
+ *
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM, ::CNNL_STATUS_ARCH_MISMATCH
+ *
+ * @par Formula
+ * - y = 1 / x.
+ *
+ * @par Data Type
+ * - Data type of input tensor and output tensor must be the same.
+ * - The supported data types of input and output tensors are as follows:
+ *   - input tensor: half, float.
+ *   - output tensor: half, float.
+ *
+ * @par Scale Limitation
+ * - The input tensor and output tensor must have the same shape.
+ *
+ * @note
+ * - The input \b x has the data range of the divisor of ::cnnlDiv.
+ *
+ * @par Requirements
+ * - None.
+ *
+ * @par Example
+ * - None.
+ *
+ * @par Reference
+ * - https://www.tensorflow.google.cn/api_docs/python/tf/math/reciprocal
+ */
+cnnlStatus_t CNNL_WIN_API cnnlReciprocal(cnnlHandle_t handle,
+                                         const cnnlComputationPreference_t prefer,
+                                         const cnnlTensorDescriptor_t x_desc,
+                                         const void *x,
+                                         const cnnlTensorDescriptor_t y_desc,
+                                         void *y);
+
+/*!
+ * @brief Computes division on input tensor \b x and \b y plus the scalar \b eps, and returns
+ *        the results in the output tensor \b z.
+ *
+ * \b eps is added to \b y on chip, no tensor of \b y + \b eps is read. \b zero_mode sets the
+ * result where \b y + \b eps is zero.
+ *
+ * @param[in] handle
+ *   Input. Handle to a CNNL context that is used to manage MLU devices and queues in the
+ *   division operation. For detailed information, see ::cnnlHandle_t.
+ * @param[in] prefer
+ *   Input. The \b prefer modes defined in ::cnnlComputationPreference_t enum.
+ * @param[in] eps
+ *   Input. The scalar added to the divisor.
+ * @param[in] zero_mode
+ *   Input. The zero divisor policy defined in ::cnnlDivZeroMode_t enum.
+ * @param[in] x_desc
+ *   Input. The descriptor of the input tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in] x
+ *   Input. Pointer to the MLU memory that stores the dividend tensor.
+ * @param[in] y_desc
+ *   Input. The descriptor of the input tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in] y
+ *   Input. Pointer to the MLU memory that stores the divisor tensor.
+ * @param[in] z_desc
+ *   Input. The descriptor of the output tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[out] z
+ *   Output. Pointer to the MLU memory that stores the output tensor.
+ *
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM, ::CNNL_STATUS_ARCH_MISMATCH
+ *
+ * @par Formula
+ * - z = x / (y + eps), z = 0 where y + eps is 0 with ::CNNL_DIV_ZERO_AS_ZERO.
+ *
+ * @par Data Type
+ * - Data type of input tensors and output tensor must be the same.
+ * - The supported data types of input and output tensors are as follows:
+ *   - input tensor: half, float.
+ *   - output tensor: half, float.
+ *
+ * @par Scale Limitation
+ * - The input tensors and output tensor must have the same shape.
+ *
+ * @note
+ * - \b y + \b eps has the data range of the divisor of ::cnnlDiv, except the zeros with
+ *   ::CNNL_DIV_ZERO_AS_ZERO.
+ * - With half data, \b y + \b eps and its reciprocal are computed in float, so an \b eps below
+ *   the half range, such as 1e-8, is not rounded to 0.
+ *
+ * @par Requirements
+ * - None.
+ *
+ * @par Example
+ * - None.
+ *
+ * @par Reference
+ * - None.
+ */
+cnnlStatus_t CNNL_WIN_API cnnlDivEps(cnnlHandle_t handle,
+                                     const cnnlComputationPreference_t prefer,
+                                     const float eps,
+                                     const cnnlDivZeroMode_t zero_mode,
+                                     const cnnlTensorDescriptor_t x_desc,
+                                     const void *x,
+                                     const cnnlTensorDescriptor_t y_desc,
+                                     const void *y,
+                                     const cnnlTensorDescriptor_t z_desc,
+                                     void *z);
+
+/*!
+ * @brief Computes the integer division of input tensor \b x by \b y rounded as \b round_mode,
+ *        and returns the results in the output tensor \b z.
+ *
+ * @param[in] handle
+ *   Input. Handle to a CNNL context that is used to manage MLU devices and queues in the
+ *   division operation. For detailed information, see ::cnnlHandle_t.
+ * @param[in] round_mode
+ *   Input. The rounding of the quotient defined in ::cnnlDivRoundMode_t enum.
+ * @param[in] x_desc
+ *   Input. The descriptor of the input tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in] x
+ *   Input. Pointer to the MLU memory that stores the dividend tensor.
+ * @param[in] y_desc
+ *   Input. The descriptor of the input tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in] y
+ *   Input. Pointer to the MLU memory that stores the divisor tensor.
+ * @param[in] z_desc
+ *   Input. The descriptor of the output tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[out] z
+ *   Output. Pointer to the MLU memory that stores the output tensor.
+ *
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM, ::CNNL_STATUS_ARCH_MISMATCH
+ *
+ * @par Formula
+ * - z = trunc(x / y) with ::CNNL_DIV_ROUND_TRUNC, z = floor(x / y) with
+ *   ::CNNL_DIV_ROUND_FLOOR, z = 0 where y is 0.
+ *
+ * @par Data Type
+ * - Data type of input tensors and output tensor must be the same.
+ * - The supported data types of input and output tensors are as follows:
+ *   - input tensor: int8, int16, int32.
+ *   - output tensor: int8, int16, int32.
+ *
+ * @par Scale Limitation
+ * - The input tensors and output tensor must have the same shape.
+ *
+ * @note
+ * - The division is computed in float and corrected to the exact quotient, exact for all the
+ *   inputs. int32 is divided in 16-bit digits, whose products are exact in float.
+ * - The minimum of the data type divided by -1 saturates to its maximum.
+ *
+ * @par Requirements
+ * - None.
+ *
+ * @par Example
+ * - x = [7, -7, 7, -7], y = [2, 2, -2, 0]:
+ *   - ::CNNL_DIV_ROUND_TRUNC: z = [3, -3, -3, 0].
+ *   - ::CNNL_DIV_ROUND_FLOOR: z = [3, -4, -4, 0].
+ *
+ * @par Reference
+ * - https://www.tensorflow.google.cn/api_docs/python/tf/math/floordiv
+ */
+cnnlStatus_t CNNL_WIN_API cnnlDivRound(cnnlHandle_t handle,
+                                       const cnnlDivRoundMode_t round_mode,
+                                       const cnnlTensorDescriptor_t x_desc,
+                                       const void *x,
+                                       const cnnlTensorDescriptor_t y_desc,
+                                       const void *y,
+                                       const cnnlTensorDescriptor_t z_desc,
+                                       void *z);
+
+/*!
+ * @brief Applies one Adam step to the parameter tensor \b param with the gradient \b grad,
+ *        updating \b param and the moment tensors \b m and \b v in place.
+ *
+ * The moments, the square root and the division are fused in one pass, every tensor is read
+ * once and \b param, \b m and \b v are written once. half tensors are computed in float.
+ *
+ * @param[in] handle
+ *   Input. Handle to a CNNL context that is used to manage MLU devices and queues in the
+ *   adam update operation. For detailed information, see ::cnnlHandle_t.
+ * @param[in] lr
+ *   Input. The learning rate.
+ * @param[in] beta1
+ *   Input. The decay of the first moment, in [0, 1).
+ * @param[in] beta2
+ *   Input. The decay of the second moment, in [0, 1).
+ * @param[in] eps
+ *   Input. The positive scalar added to the denominator.
+ * @param[in] step
+ *   Input. The step number of the update for the bias corrections, starting at 1.
+ * @param[in] param_desc
+ *   Input. The descriptor of the parameter tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in,out] param
+ *   Input and output. Pointer to the MLU memory that stores the parameter tensor.
+ * @param[in] grad_desc
+ *   Input. The descriptor of the gradient tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in] grad
+ *   Input. Pointer to the MLU memory that stores the gradient tensor.
+ * @param[in] m_desc
+ *   Input. The descriptor of the first moment tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in,out] m
+ *   Input and output. Pointer to the MLU memory that stores the first moment tensor.
+ * @param[in] v_desc
+ *   Input. The descriptor of the second moment tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in,out] v
+ *   Input and output. Pointer to the MLU memory that stores the second moment tensor.
+ *
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM, ::CNNL_STATUS_ARCH_MISMATCH
+ *
+ * @par Formula
+ * - m = beta1 * m + (1 - beta1) * grad, v = beta2 * v + (1 - beta2) * grad * grad.
+ * - param = param - lr_t * m / (sqrt(v) + eps_t), where
+ *   lr_t = lr * sqrt(1 - beta2^step) / (1 - beta1^step) and eps_t = eps * sqrt(1 - beta2^step).
+ *
+ * @par Data Type
+ * - Data type of all the tensors must be the same.
+ * - The supported data types of the tensors are half and float.
+ *
+ * @par Scale Limitation
+ * - All the tensors must have the same shape.
+ *
+ * @note
+ * - sqrt(v) + eps_t has the data range of the divisor of ::cnnlDiv.
+ *
+ * @par Requirements
+ * - None.
+ *
+ * @par Example
+ * - None.
+ *
+ * @par Reference
+ * - https://pytorch.org/docs/stable/generated/torch.optim.Adam.html
+ */
+cnnlStatus_t CNNL_WIN_API cnnlAdamUpdate(cnnlHandle_t handle,
+                                         const float lr,
+                                         const float beta1,
+                                         const float beta2,
+                                         const float eps,
+                                         const int step,
+                                         const cnnlTensorDescriptor_t param_desc,
+                                         void *param,
+                                         const cnnlTensorDescriptor_t grad_desc,
+                                         const void *grad,
+                                         const cnnlTensorDescriptor_t m_desc,
+                                         void *m,
+                                         const cnnlTensorDescriptor_t v_desc,
+                                         void *v);
+
+/*!
+ * @brief Applies one RMSProp step to the parameter tensor \b param with the gradient \b grad,
+ *        updating \b param and the mean square tensor \b ms in place.
+ *
+ * Fused in one pass as ::cnnlAdamUpdate. half tensors are computed in float.
+ *
+ * @param[in] handle
+ *   Input. Handle to a CNNL context that is used to manage MLU devices and queues in the
+ *   rmsprop update operation. For detailed information, see ::cnnlHandle_t.
+ * @param[in] lr
+ *   Input. The learning rate.
+ * @param[in] rho
+ *   Input. The decay of the mean square, in [0, 1).
+ * @param[in] eps
+ *   Input. The positive scalar added to the denominator.
+ * @param[in] param_desc
+ *   Input. The descriptor of the parameter tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in,out] param
+ *   Input and output. Pointer to the MLU memory that stores the parameter tensor.
+ * @param[in] grad_desc
+ *   Input. The descriptor of the gradient tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in] grad
+ *   Input. Pointer to the MLU memory that stores the gradient tensor.
+ * @param[in] ms_desc
+ *   Input. The descriptor of the mean square tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in,out] ms
+ *   Input and output. Pointer to the MLU memory that stores the mean square tensor.
+ *
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM, ::CNNL_STATUS_ARCH_MISMATCH
+ *
+ * @par Formula
+ * - ms = rho * ms + (1 - rho) * grad * grad, param = param - lr * grad / (sqrt(ms) + eps).
+ *
+ * @par Data Type
+ * - Data type of all the tensors must be the same.
+ * - The supported data types of the tensors are half and float.
+ *
+ * @par Scale Limitation
+ * - All the tensors must have the same shape.
+ *
+ * @note
+ * - sqrt(ms) + eps has the data range of the divisor of ::cnnlDiv.
+ *
+ * @par Requirements
+ * - None.
+ *
+ * @par Example
+ * - None.
+ *
+ * @par Reference
+ * - https://pytorch.org/docs/stable/generated/torch.optim.RMSprop.html
+ */
+cnnlStatus_t CNNL_WIN_API cnnlRmspropUpdate(cnnlHandle_t handle,
+                                            const float lr,
+                                            const float rho,
+                                            const float eps,
+                                            const cnnlTensorDescriptor_t param_desc,
+                                            void *param,
+                                            const cnnlTensorDescriptor_t grad_desc,
+                                            const void *grad,
+                                            const cnnlTensorDescriptor_t ms_desc,
+                                            void *ms);
+
+/*!
+ * @brief Reduces the last dimension of the input tensor \b x, and returns the results in the
+ *        output tensor \b y.
+ *
+ * The cores of a cluster reduce the parts of a row and combine their partial results on chip,
+ * logsumexp takes the max and the sum of exp in one pass over \b x.
+ *
+ * @param[in] handle
+ *   Input. Handle to a CNNL context that is used to manage MLU devices and queues in the
+ *   reduction. For detailed information, see ::cnnlHandle_t.
+ * @param[in] reduce_op
+ *   Input. The reduction defined in ::cnnlReduceLastDimOp_t enum.
+ * @param[in] x_desc
+ *   Input. The descriptor of the input tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[in] x
+ *   Input. Pointer to the MLU memory that stores the input tensor.
+ * @param[in] y_desc
+ *   Input. The descriptor of the output tensor. For detailed information, see
+ * ::cnnlTensorDescriptor_t.
+ * @param[out] y
+ *   Output. Pointer to the MLU memory that stores the output tensor.
+ *
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM, ::CNNL_STATUS_ARCH_MISMATCH
+ *
+ * @par Formula
+ * - sum: y = sum(x), max: y = max(x), logsumexp: y = max(x) + log(sum(exp(x - max(x)))),
+ *   over the last dimension.
+ *
+ * @par Data Type
+ * - Data type of input tensor and output tensor must be the same.
+ * - The supported data types of input and output tensors are half and float, half is
+ *   accumulated in float.
+ *
+ * @par Scale Limitation
+ * - The output tensor has the shape of the input tensor with a last dimension of 1.
+ * - The last dimension of the input tensor is not 0 when the output has elements.
+ * - The input tensor has less than 2^31 elements.
+ *
+ * @note
+ * - The input tensor has no inf or nan.
+ *
+ * @par Requirements
+ * - None.
+ *
+ * @par Example
+ * - None.
+ *
+ * @par Reference
+ * - https://pytorch.org/docs/stable/generated/torch.logsumexp.html
+ */
+cnnlStatus_t CNNL_WIN_API cnnlReduceLastDim(cnnlHandle_t handle,
+                                            const cnnlReduceLastDimOp_t reduce_op,
+                                            const cnnlTensorDescriptor_t x_desc,
+                                            const void *x,
+                                            const cnnlTensorDescriptor_t y_desc,
+                                            void *y);
+
 /*!
  * @brief Computes sqrt on input tensor \b x, and returns the results in the output tensor \b y.
  *
@@ -265,6 +776,13 @@ cnnlStatus_t CNNL_WIN_API cnnlDiv(cnnlHandle_t handle,
  *   the following input data range:
  *   - float: [1e-10,1e10].
  *   - half: [1e-3,1e-2] & [1e-1,60000].
+ * - With ::CNNL_COMPUTATION_APPROX the range is zero, every positive float, subnormal ones
+ *   included, and every positive half. A negative input gives nan, +-0, +inf and nan are
+ *   returned as is.
+ *
+ * @note
+ * - ::CNNL_COMPUTATION_APPROX computes a Newton refined polynomial of the mantissa instead of
+ *   the active function, the max error is 1.5 ulp for float and 1 ulp for half.
  *
  * @par Requirements
  * - None.
@@ -339,6 +857,210 @@ cnnlStatus_t CNNL_WIN_API cnnlSqrtBackward(cnnlHandle_t handle,
                                            const cnnlTensorDescriptor_t dx_desc,
                                            void *diff_x);
 
+/*!
+ * @brief The maximum number of operations and of kernels per operation counted by
+ * ::cnnlGetHandleStatistics.
+ */
+#define CNNL_STATS_MAX_OPS 32
+#define CNNL_STATS_MAX_KERNELS 8
+
+/*!
+ * @brief The number of launches of one kernel of an operation.
+ */
+typedef struct {
+  const char *kernel_name;  /*!< The name of the kernel.*/
+  uint64_t launches;        /*!< The number of launches.*/
+} cnnlKernelStatistics_t;
+
+/*!
+ * @brief The counters of one operation called with a handle.
+ */
+typedef struct {
+  const char *op_name;                /*!< The name of the operation, such as "cnnlAbs".*/
+  uint64_t calls;                     /*!< The number of calls.*/
+  uint64_t param_check_failures;      /*!< Calls returned by the parameter check with an error.*/
+  uint64_t zero_element_calls;        /*!< Calls returned early for a zero-element tensor.*/
+  uint64_t arch_mismatches;           /*!< Calls returned ::CNNL_STATUS_ARCH_MISMATCH, no kernel
+                                           of the data type runs on the device.*/
+  uint64_t launches;                  /*!< The number of kernel launches.*/
+  uint64_t elements;                  /*!< The number of elements processed by the launches.*/
+  uint64_t bytes;                     /*!< The bytes read and written by the launches.*/
+  uint64_t three_stage_launches;      /*!< Launches of 3-stage pipeline kernels.*/
+  uint64_t five_stage_launches;       /*!< Launches of 5-stage pipeline kernels.*/
+  uint64_t fast_launches;             /*!< Launches of kernels with ::CNNL_COMPUTATION_FAST.*/
+  uint64_t high_precision_launches;   /*!< Launches of kernels with
+                                           ::CNNL_COMPUTATION_HIGH_PRECISION.*/
+  uint64_t approx_launches;           /*!< Launches of kernels with ::CNNL_COMPUTATION_APPROX.*/
+  int kernel_num;                     /*!< The number of valid entries in \b kernels.*/
+  cnnlKernelStatistics_t kernels[CNNL_STATS_MAX_KERNELS]; /*!< Launches of each kernel.*/
+} cnnlOpStatistics_t;
+
+/*!
+ * @brief The counters of the operations called with a handle.
+ */
+typedef struct {
+  int op_num;                                /*!< The number of valid entries in \b ops.*/
+  cnnlOpStatistics_t ops[CNNL_STATS_MAX_OPS]; /*!< The counters of each operation.*/
+} cnnlHandleStatistics_t;
+
+/*!
+ * @brief Retrieves the counters of the operations called with \b handle since it was
+ * created or since the last ::cnnlResetHandleStatistics, merged over all host threads.
+ *
+ * @param[in] handle
+ *   Input. Handle to a CNNL context. For detailed information, see ::cnnlHandle_t.
+ * @param[out] stats
+ *   Output. Pointer to the host memory that receives the counters. Operations never called
+ *   with \b handle are not listed.
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM
+ *
+ * @par Note
+ * - The counters are kept per handle address, call ::cnnlReleaseHandleStatistics before
+ *   ::cnnlDestroy so that a later handle at the same address starts from zero.
+ * - Counters updated by other threads during the call may be partly included.
+ */
+cnnlStatus_t CNNL_WIN_API cnnlGetHandleStatistics(cnnlHandle_t handle,
+                                                  cnnlHandleStatistics_t *stats);
+
+/*!
+ * @brief Sets the counters of \b handle returned by ::cnnlGetHandleStatistics to zero.
+ *
+ * @param[in] handle
+ *   Input. Handle to a CNNL context. For detailed information, see ::cnnlHandle_t.
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM
+ */
+cnnlStatus_t CNNL_WIN_API cnnlResetHandleStatistics(cnnlHandle_t handle);
+
+/*!
+ * @brief Drops the counters of \b handle, the memory they hold is freed.
+ *
+ * @param[in] handle
+ *   Input. Handle to a CNNL context. For detailed information, see ::cnnlHandle_t.
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM
+ *
+ * @par Note
+ * - Call it before ::cnnlDestroy, which belongs to libcnnl_core.so and can not drop them.
+ *   No other thread may call an operation with \b handle meanwhile.
+ */
+cnnlStatus_t CNNL_WIN_API cnnlReleaseHandleStatistics(cnnlHandle_t handle);
+
+/*!
+ * @brief What the operation timing collector records, see also the CNNL_OP_TIMING
+ * environment variables. Each mode also records what the previous one records.
+ */
+typedef enum {
+  CNNL_OP_TIMING_OFF       = 0, /*!< Nothing is recorded.*/
+  CNNL_OP_TIMING_HOST      = 1, /*!< The host time from the api entry to the kernel launch.*/
+  CNNL_OP_TIMING_HARDWARE  = 2, /*!< The hardware time of the kernel, between two notifiers
+                                     placed around the launch.*/
+  CNNL_OP_TIMING_BANDWIDTH = 3, /*!< The bandwidth achieved by each kernel launch, logged.*/
+} cnnlOpTimingMode_t;
+
+/*!
+ * @brief The maximum number of entries returned by ::cnnlGetOpTimingStatistics, and the
+ * size of the names in an entry, longer names are truncated.
+ */
+#define CNNL_OP_TIMING_MAX_ENTRIES 256
+#define CNNL_OP_TIMING_NAME_LEN 128
+
+/*!
+ * @brief The distribution of the latencies of some calls, in nanoseconds. The percentiles
+ * are read from a log-linear histogram, about 6% relative error.
+ */
+typedef struct {
+  uint64_t count; /*!< The number of calls.*/
+  double mean;    /*!< The mean latency.*/
+  uint64_t min;   /*!< The minimum latency.*/
+  uint64_t p50;   /*!< The median latency.*/
+  uint64_t p99;   /*!< The 99th percentile latency.*/
+  uint64_t p999;  /*!< The 99.9th percentile latency.*/
+  uint64_t max;   /*!< The maximum latency.*/
+} cnnlLatencySummary_t;
+
+/*!
+ * @brief The timing of the calls of one operation launching one kernel on tensors of one
+ * size bucket.
+ */
+typedef struct {
+  char op_name[CNNL_OP_TIMING_NAME_LEN];     /*!< The name of the operation, such as
+                                                 "cnnlAbs".*/
+  char kernel_name[CNNL_OP_TIMING_NAME_LEN]; /*!< The name of the kernel launched.*/
+  int size_bucket;                           /*!< floor(log2) of the number of elements.*/
+  cnnlLatencySummary_t host;                 /*!< The host time from the api entry to the
+                                                 kernel launch.*/
+  cnnlLatencySummary_t device;               /*!< The hardware time, empty below
+                                                 ::CNNL_OP_TIMING_HARDWARE.*/
+  uint64_t bytes;                            /*!< The bytes read and written by the calls
+                                                 having hardware time.*/
+  double bandwidth;                          /*!< GB/s, \b bytes divided by their hardware
+                                                 time.*/
+  double peak_bandwidth;                     /*!< GB/s, the peak bandwidth of the device.*/
+  double efficiency;                         /*!< \b bandwidth in percent of
+                                                 \b peak_bandwidth.*/
+} cnnlOpTimingEntry_t;
+
+/*!
+ * @brief The timing of the operations called in the process.
+ */
+typedef struct {
+  uint64_t dropped; /*!< Calls not recorded because a per-thread buffer was full.*/
+  int entry_num;    /*!< The number of valid entries in \b entries.*/
+  cnnlOpTimingEntry_t entries[CNNL_OP_TIMING_MAX_ENTRIES]; /*!< The timing of each operation,
+                                                                kernel and size bucket.*/
+} cnnlOpTimingStatistics_t;
+
+/*!
+ * @brief Sets what the operation timing collector records, in place of the mode read from
+ * the CNNL_OP_TIMING, CNNL_OP_TIMING_HW and CNNL_OP_BANDWIDTH environment variables.
+ *
+ * @param[in] mode
+ *   Input. The records to collect. For detailed information, see ::cnnlOpTimingMode_t.
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM
+ *
+ * @par Note
+ * - The mode applies to the operations called after it returns, for the whole process.
+ */
+cnnlStatus_t CNNL_WIN_API cnnlSetOpTimingMode(cnnlOpTimingMode_t mode);
+
+/*!
+ * @brief Retrieves the timing of the operations called since the process started or since
+ * the last ::cnnlResetOpTimingStatistics, merged over all host threads and handles.
+ *
+ * @param[out] stats
+ *   Output. Pointer to the host memory that receives the timing.
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM
+ *
+ * @par Note
+ * - Waits until the kernels recorded with hardware time have finished.
+ * - Entries beyond ::CNNL_OP_TIMING_MAX_ENTRIES are not returned, ::cnnlDumpOpTimingStatistics
+ *   writes all of them.
+ */
+cnnlStatus_t CNNL_WIN_API cnnlGetOpTimingStatistics(cnnlOpTimingStatistics_t *stats);
+
+/*!
+ * @brief Drops the timing returned by ::cnnlGetOpTimingStatistics.
+ *
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS
+ */
+cnnlStatus_t CNNL_WIN_API cnnlResetOpTimingStatistics(void);
+
+/*!
+ * @brief Writes the timing returned by ::cnnlGetOpTimingStatistics to a file, in CSV if
+ * \b file_name ends with ".csv", in JSON otherwise.
+ *
+ * @param[in] file_name
+ *   Input. The path of the file, overwritten.
+ * @par Return
+ * - ::CNNL_STATUS_SUCCESS, ::CNNL_STATUS_BAD_PARAM, ::CNNL_STATUS_EXECUTION_FAILED
+ */
+cnnlStatus_t CNNL_WIN_API cnnlDumpOpTimingStatistics(const char *file_name);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,377 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <limits>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include "include/logging.h"
+#include "include/async_log.h"
+
+namespace cnnl {
+namespace internal {
+
+std::atomic<int> vlog_max_level(std::numeric_limits<int>::max());
+
+// "file1=level1,file2=level2", returns the max level.
+static int maxVmoduleLevel(const char *vmodule) {
+  int max_level = 0;
+  const char *item = vmodule;
+  while (item != NULL && *item != '\0') {
+    const char *sep = strchr(item, '=');
+    if (sep == NULL) {
+      break;
+    }
+    max_level = std::max(max_level, atoi(sep + 1));
+    item      = strchr(sep, ',');
+    item      = item == NULL ? NULL : item + 1;
+  }
+  return max_level;
+}
+
+struct VlogLevelInitializer {
+  VlogLevelInitializer() {
+    int level = (int)LogMessage::MinVLogLevel();
+    const char *vmodule = getenv("CNNL_CPP_VMODULE");
+    if (vmodule != NULL) {
+      level = std::max(level, maxVmoduleLevel(vmodule));
+    }
+    vlog_max_level.store(level, std::memory_order_relaxed);
+  }
+};
+static VlogLevelInitializer vlog_level_initializer;
+
+}  // namespace internal
+
+namespace async_log {
+
+#define ASYNC_LOG_MAX_PENDING (64 * 1024)
+#define ASYNC_LOG_IDLE_WAIT_MS 10
+#define ASYNC_LOG_DEFAULT_MAX_SIZE_MB 64
+#define ASYNC_LOG_DEFAULT_MAX_FILES 5
+#define ASYNC_LOG_CNLOG_FILE "cnnl_auto_log"  // the file cnlog saves to
+
+struct LogNode {
+  std::atomic<LogNode *> next;
+  uint64_t time_us;
+  const char *fname;
+  int line;
+  int severity;
+  std::string text;
+};
+
+// Intrusive multi-producer single-consumer queue (D. Vyukov). push() is wait-free, the
+// consumer may briefly see an empty queue while a push is half done.
+class MpscQueue {
+ public:
+  MpscQueue() : head_(&stub_), tail_(&stub_) { stub_.next.store(NULL); }
+
+  void push(LogNode *node) {
+    node->next.store(NULL, std::memory_order_relaxed);
+    LogNode *prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  // Returns the oldest node, to be deleted by the caller, or NULL.
+  LogNode *pop() {
+    LogNode *tail = tail_;
+    LogNode *next = tail->next.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == NULL) {
+        return NULL;
+      }
+      tail_ = next;
+      tail  = next;
+      next  = next->next.load(std::memory_order_acquire);
+    }
+    if (next != NULL) {
+      tail_ = next;
+      return tail;
+    }
+    if (tail != head_.load(std::memory_order_acquire)) {
+      return NULL;  // a producer is between exchange and link
+    }
+    // tail is the last node, put the stub behind it so it can be returned.
+    push(&stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != NULL) {
+      tail_ = next;
+      return tail;
+    }
+    return NULL;
+  }
+
+ private:
+  LogNode stub_;
+  std::atomic<LogNode *> head_;
+  LogNode *tail_;
+};
+
+static const char *severityName(int severity) {
+  static const char *names[] = {"Info", "Warning", "Error", "Fatal", "Vlog", "Cnpapi"};
+  return severity >= 0 && severity < 6 ? names[severity] : "Unknown";
+}
+
+static void closeAsyncLog();
+
+class AsyncLogger {
+ public:
+  static AsyncLogger *instance() {
+    // intentionally leaked, messages may be logged during static destruction.
+    static AsyncLogger *logger = new AsyncLogger();
+    return logger;
+  }
+
+  bool enabled() const { return enabled_; }
+
+  // Returns false when the message is not queued and must be written by the caller.
+  bool push(LogNode *node) {
+    if (stopped_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    if (pending_.fetch_add(1, std::memory_order_relaxed) >= ASYNC_LOG_MAX_PENDING) {
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      delete node;
+      return true;
+    }
+    // the node belongs to the writer once pushed
+    bool urgent = node->severity == LOG_ERROR || node->severity == LOG_WARNING;
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    queue_.push(node);
+    if (urgent) {
+      cv_.notify_one();
+    }
+    return true;
+  }
+
+  void flush() {
+    uint64_t target = pushed_.load();
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.notify_all();
+    written_cv_.wait_for(lock, std::chrono::seconds(5), [&] { return written_ >= target; });
+  }
+
+  void stop() {
+    stopped_.store(true, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    if (file_ != NULL) {
+      fclose(file_);
+      file_ = NULL;
+    }
+  }
+
+  // Formats and writes a message without a prefix cache, used once stopped.
+  static void writeDirect(LogNode *node) {
+    char prefix[32];
+    time_t sec = node->time_us / 1000000;
+    struct tm tm_time;
+    localtime_r(&sec, &tm_time);
+    strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &tm_time);
+    fprintf(stderr, "[%s.%06d] [CNNL] [%s]: %s:%d %s\n", prefix, (int)(node->time_us % 1000000),
+            severityName(node->severity), node->fname, node->line, node->text.c_str());
+  }
+
+  std::atomic<uint64_t> dropped;
+
+ private:
+  AsyncLogger() : dropped(0), pending_(0), pushed_(0), stopped_(false) {
+    enabled_ = cnlog::getBoolEnvVar("CNNL_LOG_ASYNC", false);
+    if (!enabled_) {
+      return;
+    }
+    // CNNL_LOG_ASYNC_FILE replaces both sinks, otherwise they are the ones of cnlog: the
+    // screen unless CNNL_LOG_PRINT is off, and cnnl_auto_log when CNNL_LOG_ONLY_SHOW is off.
+    const char *file_name = getenv("CNNL_LOG_ASYNC_FILE");
+    if (file_name != NULL && strlen(file_name) > 0) {
+      file_name_ = file_name;
+    } else {
+      show_ = cnlog::getBoolEnvVar("CNNL_LOG_PRINT", true);
+      if (!cnlog::getBoolEnvVar("CNNL_LOG_ONLY_SHOW", true)) {
+        file_name_ = ASYNC_LOG_CNLOG_FILE;
+        append_    = true;  // cnlog has opened it, and still writes the FATAL messages
+      }
+    }
+    const char *max_size = getenv("CNNL_LOG_ASYNC_MAX_SIZE");
+    max_bytes_ = (uint64_t)(max_size != NULL && atoi(max_size) > 0 ? atoi(max_size)
+                                                                    : ASYNC_LOG_DEFAULT_MAX_SIZE_MB)
+                 << 20;
+    const char *max_files = getenv("CNNL_LOG_ASYNC_MAX_FILES");
+    max_files_ =
+        max_files != NULL && atoi(max_files) > 0 ? atoi(max_files) : ASYNC_LOG_DEFAULT_MAX_FILES;
+    openFile();
+    thread_ = std::thread(&AsyncLogger::loop, this);
+    atexit(closeAsyncLog);
+  }
+
+  void openFile() {
+    file_ = NULL;
+    if (!file_name_.empty()) {
+      file_ = fopen(file_name_.c_str(), append_ ? "a" : "w");
+      if (file_ == NULL) {
+        fprintf(stderr, "[CNNL] [Warning]: open %s failed, log to stderr.\n", file_name_.c_str());
+        file_name_.clear();
+        show_ = true;
+      }
+    }
+    file_bytes_ = 0;
+  }
+
+  // path -> path.1 -> path.2 ... the oldest one is overwritten.
+  void rotate() {
+    fclose(file_);
+    append_ = false;
+    for (int i = max_files_ - 1; i >= 1; --i) {
+      std::string from = file_name_ + "." + std::to_string(i);
+      std::string to   = file_name_ + "." + std::to_string(i + 1);
+      rename(from.c_str(), to.c_str());
+    }
+    rename(file_name_.c_str(), (file_name_ + ".1").c_str());
+    openFile();
+  }
+
+  void write(const LogNode *node) {
+    time_t sec = node->time_us / 1000000;
+    if (sec != prefix_sec_) {
+      struct tm tm_time;
+      localtime_r(&sec, &tm_time);
+      strftime(prefix_, sizeof(prefix_), "%Y-%m-%d %H:%M:%S", &tm_time);
+      prefix_sec_ = sec;
+    }
+    const char *base_name = strrchr(node->fname, '/');
+    base_name             = base_name == NULL ? node->fname : base_name + 1;
+    if (show_) {
+      fprintf(stderr, "[%s.%06d] [CNNL] [%s]: %s:%d %s\n", prefix_,
+              (int)(node->time_us % 1000000), severityName(node->severity), base_name,
+              node->line, node->text.c_str());
+    }
+    if (file_ != NULL) {
+      int bytes = fprintf(file_, "[%s.%06d] [CNNL] [%s]: %s:%d %s\n", prefix_,
+                          (int)(node->time_us % 1000000), severityName(node->severity),
+                          base_name, node->line, node->text.c_str());
+      file_bytes_ += bytes > 0 ? bytes : 0;
+      if (file_bytes_ >= max_bytes_) {
+        rotate();
+      }
+    }
+  }
+
+  // Returns the number of messages written.
+  uint64_t drain() {
+    uint64_t count = 0;
+    LogNode *node  = NULL;
+    while ((node = queue_.pop()) != NULL) {
+      write(node);
+      delete node;
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      count++;
+    }
+    if (count > 0 && file_ != NULL) {
+      fflush(file_);
+    }
+    return count;
+  }
+
+  void loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      lock.unlock();
+      uint64_t count = drain();
+      lock.lock();
+      written_ += count;
+      written_cv_.notify_all();
+      if (stop_) {
+        break;
+      }
+      if (count == 0) {
+        cv_.wait_for(lock, std::chrono::milliseconds(ASYNC_LOG_IDLE_WAIT_MS));
+      }
+    }
+    // messages pushed before stopped_ was set but after the last drain
+    written_ += drain();
+    written_cv_.notify_all();
+  }
+
+  bool enabled_ = false;
+  MpscQueue queue_;
+  std::atomic<uint64_t> pending_;
+  std::atomic<uint64_t> pushed_;
+  std::atomic<bool> stopped_;
+  std::mutex mutex_;  // guards stop_ and written_, never taken by a push
+  std::condition_variable cv_;
+  std::condition_variable written_cv_;
+  bool stop_         = false;
+  uint64_t written_  = 0;
+  std::thread thread_;
+  bool show_   = false;  // to stderr
+  bool append_ = false;
+  FILE *file_  = NULL;
+  std::string file_name_;
+  uint64_t file_bytes_ = 0;
+  uint64_t max_bytes_  = 0;
+  int max_files_       = 0;
+  time_t prefix_sec_   = 0;
+  char prefix_[32]     = {0};
+};
+
+bool isAsyncLogOn() {
+  static bool async_log_on = AsyncLogger::instance()->enabled();
+  return async_log_on;
+}
+
+void flushAsyncLog() {
+  if (isAsyncLogOn()) {
+    AsyncLogger::instance()->flush();
+  }
+}
+
+uint64_t getAsyncLogDropped() {
+  return AsyncLogger::instance()->dropped.load();
+}
+
+// LOG has dropped the messages below the level of cnlog before they are formatted.
+AsyncLogMessage::~AsyncLogMessage() {
+  LogNode *node  = new LogNode();
+  node->time_us  = std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+  node->fname    = fname_;
+  node->line     = line_;
+  node->severity = severity_;
+  node->text     = stream_.str();
+  if (!AsyncLogger::instance()->push(node)) {
+    AsyncLogger::writeDirect(node);
+    delete node;
+  }
+}
+
+// Write the queued messages at exit, from an atexit hook registered with the writer thread
+// rather than a static destructor, so that the thread is joined while the process is whole.
+static void closeAsyncLog() {
+  AsyncLogger::instance()->stop();
+}
+
+}  // namespace async_log
+}  // namespace cnnl
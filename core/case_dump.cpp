@@ -0,0 +1,726 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "include/case_dump.h"
+#include "include/gen_case.h"
+#include "include/logging.h"
+#include "include/type.h"
+
+namespace cnnl {
+namespace case_dump {
+
+#define CASE_DUMP_DEFAULT_QUEUE_MB 256
+
+/******************************************************************************
+ * serialization
+ ******************************************************************************/
+class ByteWriter {
+ public:
+  template <typename T>
+  void put(const T &value) {
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+  void putString(const std::string &value) {
+    put<uint32_t>(value.size());
+    buffer.append(value);
+  }
+  std::string buffer;
+};
+
+class ByteReader {
+ public:
+  ByteReader(const char *data, size_t size) : data_(data), size_(size) {}
+  template <typename T>
+  bool get(T *value) {
+    if (offset_ + sizeof(T) > size_) {
+      return false;
+    }
+    memcpy(value, data_ + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return true;
+  }
+  bool getString(std::string *value) {
+    uint32_t len = 0;
+    if (!get(&len) || offset_ + len > size_) {
+      return false;
+    }
+    value->assign(data_ + offset_, len);
+    offset_ += len;
+    return true;
+  }
+
+ private:
+  const char *data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+static uint64_t alignUp(uint64_t value) {
+  return (value + CASE_DUMP_ALIGN - 1) / CASE_DUMP_ALIGN * CASE_DUMP_ALIGN;
+}
+
+bool writeCaseFile(const std::string &file_name,
+                   const CaseInfo &info,
+                   const std::vector<std::vector<char>> &payloads) {
+  ByteWriter meta;
+  meta.putString(info.op_name);
+  meta.putString(info.op_type);
+  for (int i = 0; i < 3; ++i) {
+    meta.put<uint8_t>(info.test_param.is_diff[i]);
+    meta.put<float>(info.test_param.threshold[i]);
+  }
+  // tensor records have a fixed size once the ids are known, so the payload offsets can
+  // be computed before they are written.
+  uint64_t meta_size = meta.buffer.size();
+  for (auto &tensor : info.tensors) {
+    meta_size += sizeof(uint32_t) + tensor.id.size() + sizeof(uint8_t) + 3 * sizeof(int32_t) +
+                 tensor.dims.size() * sizeof(int32_t) + 2 * sizeof(float) + 2 * sizeof(uint64_t);
+  }
+  ByteWriter param_meta;
+  for (auto &param : info.params) {
+    param_meta.putString(param.op_name);
+    param_meta.putString(param.param_name);
+    param_meta.put<uint8_t>(param.kind);
+    param_meta.putString(param.str_value);
+    param_meta.put<uint32_t>(param.float_values.size());
+    for (auto value : param.float_values) {
+      param_meta.put<float>(value);
+    }
+    param_meta.put<uint32_t>(param.int_values.size());
+    for (auto value : param.int_values) {
+      param_meta.put<int32_t>(value);
+    }
+  }
+  meta_size += param_meta.buffer.size();
+
+  uint64_t payload_offset = alignUp(sizeof(CaseFileHeader) + meta_size);
+  uint64_t offset         = payload_offset;
+  for (size_t i = 0; i < info.tensors.size(); ++i) {
+    const CaseTensor &tensor = info.tensors[i];
+    uint64_t size            = i < payloads.size() ? payloads[i].size() : 0;
+    meta.putString(tensor.id);
+    meta.put<uint8_t>(tensor.is_input);
+    meta.put<int32_t>(tensor.dtype);
+    meta.put<int32_t>(tensor.layout);
+    meta.put<int32_t>(tensor.dims.size());
+    for (auto dim : tensor.dims) {
+      meta.put<int32_t>(dim);
+    }
+    meta.put<float>(tensor.upper_bound);
+    meta.put<float>(tensor.lower_bound);
+    meta.put<uint64_t>(size > 0 ? offset : 0);
+    meta.put<uint64_t>(size);
+    if (size > 0) {
+      offset = alignUp(offset + size);
+    }
+  }
+  meta.buffer.append(param_meta.buffer);
+
+  CaseFileHeader header;
+  memcpy(header.magic, CASE_DUMP_MAGIC, sizeof(header.magic));
+  header.version        = CASE_DUMP_VERSION;
+  header.tensor_num     = info.tensors.size();
+  header.param_num      = info.params.size();
+  header.meta_size      = meta.buffer.size();
+  header.payload_offset = payload_offset;
+  header.file_size      = offset;
+
+  FILE *fp = fopen(file_name.c_str(), "wb");
+  if (fp == NULL) {
+    LOG(ERROR) << "[gen_case] open " << file_name << " failed.";
+    return false;
+  }
+  static const char zeros[CASE_DUMP_ALIGN] = {0};
+  bool ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+            fwrite(meta.buffer.data(), 1, meta.buffer.size(), fp) == meta.buffer.size();
+  uint64_t written = sizeof(header) + meta.buffer.size();
+  for (size_t i = 0; ok && i < payloads.size(); ++i) {
+    if (payloads[i].empty()) {
+      continue;
+    }
+    uint64_t pad = alignUp(written) - written;
+    ok = fwrite(zeros, 1, pad, fp) == pad &&
+         fwrite(payloads[i].data(), 1, payloads[i].size(), fp) == payloads[i].size();
+    written += pad + payloads[i].size();
+  }
+  uint64_t pad = header.file_size - written;
+  ok           = ok && fwrite(zeros, 1, pad, fp) == pad;
+  ok           = fclose(fp) == 0 && ok;
+  if (!ok) {
+    LOG(ERROR) << "[gen_case] write " << file_name << " failed.";
+  }
+  return ok;
+}
+
+bool CaseReader::open(const std::string &file_name) {
+  close();
+  int fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LOG(ERROR) << "[gen_case] open " << file_name << " failed.";
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CaseFileHeader)) {
+    LOG(ERROR) << "[gen_case] " << file_name << " is not a case file.";
+    ::close(fd);
+    return false;
+  }
+  size_ = st.st_size;
+  base_ = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (base_ == MAP_FAILED) {
+    LOG(ERROR) << "[gen_case] mmap " << file_name << " failed.";
+    base_ = NULL;
+    return false;
+  }
+
+  const char *data = static_cast<const char *>(base_);
+  CaseFileHeader header;
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic, CASE_DUMP_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != CASE_DUMP_VERSION || header.file_size > size_ ||
+      sizeof(header) + header.meta_size > size_) {
+    LOG(ERROR) << "[gen_case] " << file_name << " has a bad header.";
+    close();
+    return false;
+  }
+  ByteReader reader(data + sizeof(header), header.meta_size);
+  bool ok = reader.getString(&info_.op_name) && reader.getString(&info_.op_type);
+  for (int i = 0; ok && i < 3; ++i) {
+    uint8_t is_diff = 0;
+    ok = reader.get(&is_diff) && reader.get(&info_.test_param.threshold[i]);
+    info_.test_param.is_diff[i] = is_diff;
+  }
+  for (uint32_t i = 0; ok && i < header.tensor_num; ++i) {
+    CaseTensor tensor;
+    uint8_t is_input = 0;
+    int32_t dtype = 0, layout = 0, dim = 0;
+    ok = reader.getString(&tensor.id) && reader.get(&is_input) && reader.get(&dtype) &&
+         reader.get(&layout) && reader.get(&dim) && dim >= 0;
+    for (int32_t j = 0; ok && j < dim; ++j) {
+      int32_t value = 0;
+      ok            = reader.get(&value);
+      tensor.dims.push_back(value);
+    }
+    ok = ok && reader.get(&tensor.upper_bound) && reader.get(&tensor.lower_bound) &&
+         reader.get(&tensor.payload_offset) && reader.get(&tensor.payload_size) &&
+         tensor.payload_offset + tensor.payload_size <= size_;
+    tensor.is_input = is_input;
+    tensor.dtype    = (cnnlDataType_t)dtype;
+    tensor.layout   = (cnnlTensorLayout_t)layout;
+    tensor.data     = tensor.payload_size > 0 ? data + tensor.payload_offset : NULL;
+    info_.tensors.push_back(tensor);
+  }
+  for (uint32_t i = 0; ok && i < header.param_num; ++i) {
+    CaseParam param;
+    uint8_t kind       = 0;
+    uint32_t float_num = 0, int_num = 0;
+    ok = reader.getString(&param.op_name) && reader.getString(&param.param_name) &&
+         reader.get(&kind) && reader.getString(&param.str_value) && reader.get(&float_num);
+    for (uint32_t j = 0; ok && j < float_num; ++j) {
+      float value = 0;
+      ok          = reader.get(&value);
+      param.float_values.push_back(value);
+    }
+    ok = ok && reader.get(&int_num);
+    for (uint32_t j = 0; ok && j < int_num; ++j) {
+      int32_t value = 0;
+      ok            = reader.get(&value);
+      param.int_values.push_back(value);
+    }
+    param.kind = (CaseParamKind)kind;
+    info_.params.push_back(param);
+  }
+  if (!ok) {
+    LOG(ERROR) << "[gen_case] " << file_name << " is truncated.";
+    close();
+    return false;
+  }
+  return true;
+}
+
+void CaseReader::close() {
+  if (base_ != NULL) {
+    munmap(base_, size_);
+    base_ = NULL;
+  }
+  size_ = 0;
+  info_ = CaseInfo();
+}
+
+/******************************************************************************
+ * prototxt
+ ******************************************************************************/
+static const char *dtypeName(cnnlDataType_t dtype) {
+  switch (dtype) {
+    case CNNL_DTYPE_HALF: return "DTYPE_HALF";
+    case CNNL_DTYPE_FLOAT: return "DTYPE_FLOAT";
+    case CNNL_DTYPE_INT8: return "DTYPE_INT8";
+    case CNNL_DTYPE_INT16: return "DTYPE_INT16";
+    case CNNL_DTYPE_INT31: return "DTYPE_INT31";
+    case CNNL_DTYPE_INT32: return "DTYPE_INT32";
+    case CNNL_DTYPE_UINT8: return "DTYPE_UINT8";
+    case CNNL_DTYPE_BOOL: return "DTYPE_BOOL";
+    default: return "DTYPE_INVALID";
+  }
+}
+
+static const char *layoutName(cnnlTensorLayout_t layout) {
+  switch (layout) {
+    case CNNL_LAYOUT_NCHW: return "LAYOUT_NCHW";
+    case CNNL_LAYOUT_NHWC: return "LAYOUT_NHWC";
+    case CNNL_LAYOUT_HWCN: return "LAYOUT_HWCN";
+    case CNNL_LAYOUT_NDHWC: return "LAYOUT_NDHWC";
+    case CNNL_LAYOUT_ARRAY: return "LAYOUT_ARRAY";
+    case CNNL_LAYOUT_TNC: return "LAYOUT_TNC";
+    case CNNL_LAYOUT_NTC: return "LAYOUT_NTC";
+    case CNNL_LAYOUT_NLC: return "LAYOUT_NLC";
+    case CNNL_LAYOUT_NC: return "LAYOUT_NC";
+    default: return "LAYOUT_INVALID";
+  }
+}
+
+static void writeValues(const CaseTensor &tensor, std::ostream &out) {
+  size_t count = tensor.payload_size / getSizeOfDataType(tensor.dtype);
+  for (size_t i = 0; i < count; ++i) {
+    switch (tensor.dtype) {
+      case CNNL_DTYPE_HALF:
+        out << "  value_f: "
+            << cnnl::gen_case::cvtHalfToFloat(((const int16_t *)tensor.data)[i]) << "\n";
+        break;
+      case CNNL_DTYPE_FLOAT: out << "  value_f: " << ((const float *)tensor.data)[i] << "\n"; break;
+      case CNNL_DTYPE_INT8: out << "  value_i: " << (int)((const int8_t *)tensor.data)[i] << "\n"; break;
+      case CNNL_DTYPE_UINT8:
+      case CNNL_DTYPE_BOOL:
+        out << "  value_i: " << (int)((const uint8_t *)tensor.data)[i] << "\n";
+        break;
+      case CNNL_DTYPE_INT16: out << "  value_i: " << ((const int16_t *)tensor.data)[i] << "\n"; break;
+      default: out << "  value_i: " << ((const int32_t *)tensor.data)[i] << "\n"; break;
+    }
+  }
+}
+
+void caseToPrototxt(const CaseInfo &info, std::ostream &out) {
+  out << "op_name: \"" << info.op_name << "\"\n";
+  out << "op_type: " << info.op_type << "\n";
+  for (auto &tensor : info.tensors) {
+    out << (tensor.is_input ? "input {\n" : "output {\n");
+    out << "  id: \"" << tensor.id << "\"\n";
+    out << "  shape: {\n";
+    for (auto dim : tensor.dims) {
+      out << "    dims: " << dim << "\n";
+    }
+    out << "  }\n";
+    out << "  layout: " << layoutName(tensor.layout) << "\n";
+    out << "  dtype: " << dtypeName(tensor.dtype) << "\n";
+    if (tensor.is_input) {
+      if (tensor.data != NULL) {
+        writeValues(tensor, out);
+      } else {
+        out << "  random_data: {\n    seed: 233\n    upper_bound: " << tensor.upper_bound
+            << "\n    lower_bound: " << tensor.lower_bound
+            << "\n    distribution: UNIFORM\n  }\n";
+      }
+    }
+    out << "}\n";
+  }
+  // params of the same op_name share one block, in the order they were added.
+  std::vector<std::string> blocks;
+  for (auto &param : info.params) {
+    if (std::find(blocks.begin(), blocks.end(), param.op_name) == blocks.end()) {
+      blocks.push_back(param.op_name);
+    }
+  }
+  for (auto &block : blocks) {
+    out << block << "_param: {\n";
+    for (auto &param : info.params) {
+      if (param.op_name != block) {
+        continue;
+      }
+      switch (param.kind) {
+        case CASE_PARAM_STRING: out << "  " << param.param_name << ": " << param.str_value << "\n"; break;
+        case CASE_PARAM_INT_ARRAY:
+          for (auto value : param.int_values) {
+            out << "  " << param.param_name << ": " << value << "\n";
+          }
+          break;
+        default:
+          for (auto value : param.float_values) {
+            out << "  " << param.param_name << ": " << value << "\n";
+          }
+          break;
+      }
+    }
+    out << "}\n";
+  }
+  out << "test_param: {\n";
+  for (int i = 0; i < 3; ++i) {
+    if (info.test_param.is_diff[i]) {
+      out << "  error_func: DIFF" << i + 1 << "\n";
+    }
+  }
+  for (int i = 0; i < 3; ++i) {
+    if (info.test_param.is_diff[i]) {
+      out << "  error_threshold: " << info.test_param.threshold[i] << "\n";
+    }
+  }
+  out << "  baseline_device: CPU\n}\n";
+}
+
+/******************************************************************************
+ * async writer
+ ******************************************************************************/
+struct PendingCase {
+  std::string file_name;
+  CaseInfo info;
+  std::vector<std::vector<char>> payloads;
+  uint64_t bytes;
+};
+
+static void closeCaseDump();
+
+class CaseWriter {
+ public:
+  static CaseWriter *instance() {
+    // intentionally leaked, the writer thread may outlive statics.
+    static CaseWriter *writer = new CaseWriter();
+    return writer;
+  }
+
+  bool enabled() const { return enabled_; }
+
+  // Applies the op filter, the sampling and the budget.
+  bool accept(const std::string &op_name) {
+    const std::string op_filter = cnnl::gen_case::getStringEnvVar("CNNL_GEN_CASE_OP_NAME", "all");
+    if (!cnnl::gen_case::getBoolOpName(op_filter, op_name)) {
+      return false;
+    }
+    if (budget_bytes_ > 0 && written_bytes_.load() + queued_bytes_.load() >= budget_bytes_) {
+      skipped.fetch_add(1);
+      return false;
+    }
+    if (sample_ > 1) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (sample_counts_[op_name]++ % sample_ != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Reserves queue memory for a payload, false if the queue or the budget is full.
+  bool reserve(uint64_t bytes) {
+    uint64_t queued = queued_bytes_.fetch_add(bytes) + bytes;
+    if (queued > queue_bytes_ ||
+        (budget_bytes_ > 0 && written_bytes_.load() + queued > budget_bytes_)) {
+      queued_bytes_.fetch_sub(bytes);
+      return false;
+    }
+    return true;
+  }
+
+  void release(uint64_t bytes) { queued_bytes_.fetch_sub(bytes); }
+
+  void submit(std::unique_ptr<PendingCase> pending) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!thread_.joinable()) {
+      thread_ = std::thread(&CaseWriter::loop, this);
+      atexit(closeCaseDump);
+    }
+    queue_.push_back(std::move(pending));
+    cv_.notify_one();
+  }
+
+  std::string nextFileName(const std::string &op_name) {
+    std::string folder = "gen_case/" + op_name;
+    mkdir("gen_case", 0755);
+    mkdir(folder.c_str(), 0755);
+    char time_str[32];
+    time_t now = time(NULL);
+    struct tm tm_time;
+    localtime_r(&now, &tm_time);
+    strftime(time_str, sizeof(time_str), "%Y%m%d_%H_%M_%S", &tm_time);
+    return folder + "/" + op_name + "_" + time_str + "_" + std::to_string(syscall(SYS_gettid)) +
+           "_" + std::to_string(sequence_.fetch_add(1)) + CASE_DUMP_SUFFIX;
+  }
+
+  void flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [&] { return queue_.empty() && !busy_; });
+  }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  std::atomic<uint64_t> skipped;
+
+ private:
+  CaseWriter() : skipped(0), queued_bytes_(0), written_bytes_(0), sequence_(0) {
+    enabled_ = cnnl::gen_case::getBoolEnvVar("CNNL_GEN_CASE_BINARY", false);
+    int queue_mb = cnnl::gen_case::getIntEnvVar("CNNL_GEN_CASE_BINARY_QUEUE_MB",
+                                                CASE_DUMP_DEFAULT_QUEUE_MB);
+    queue_bytes_  = (uint64_t)(queue_mb > 0 ? queue_mb : CASE_DUMP_DEFAULT_QUEUE_MB) << 20;
+    int budget_mb = cnnl::gen_case::getIntEnvVar("CNNL_GEN_CASE_BINARY_BUDGET_MB", 0);
+    budget_bytes_ = (uint64_t)(budget_mb > 0 ? budget_mb : 0) << 20;
+    sample_       = cnnl::gen_case::getIntEnvVar("CNNL_GEN_CASE_SAMPLE", 1);
+  }
+
+  void loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        break;  // stopped and drained
+      }
+      std::unique_ptr<PendingCase> pending = std::move(queue_.front());
+      queue_.pop_front();
+      busy_ = true;
+      lock.unlock();
+      if (writeCaseFile(pending->file_name, pending->info, pending->payloads)) {
+        written_bytes_.fetch_add(pending->bytes);
+        LOG(INFO) << "[gen_case] Generate " << pending->file_name;
+      }
+      release(pending->bytes);
+      pending.reset();
+      lock.lock();
+      busy_ = false;
+      done_cv_.notify_all();
+    }
+  }
+
+  bool enabled_ = false;
+  uint64_t queue_bytes_  = 0;
+  uint64_t budget_bytes_ = 0;
+  int sample_            = 1;
+  std::atomic<uint64_t> queued_bytes_;
+  std::atomic<uint64_t> written_bytes_;
+  std::atomic<uint64_t> sequence_;
+  std::map<std::string, uint64_t> sample_counts_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable done_cv_;
+  std::deque<std::unique_ptr<PendingCase>> queue_;
+  bool busy_ = false;
+  bool stop_ = false;
+  std::thread thread_;
+};
+
+bool isCaseDumpOn() {
+  static bool case_dump_on = CaseWriter::instance()->enabled();
+  return case_dump_on;
+}
+
+void flushCaseDump() {
+  if (isCaseDumpOn()) {
+    CaseWriter::instance()->flush();
+  }
+}
+
+uint64_t getCaseDumpSkipped() {
+  return CaseWriter::instance()->skipped.load();
+}
+
+/******************************************************************************
+ * CaseBuilder
+ ******************************************************************************/
+CaseBuilder::CaseBuilder(const std::string &op_name, const std::string &op_type) {
+  if (!isCaseDumpOn()) {
+    mode_ = MODE_TEXT;
+    return;
+  }
+  mode_ = CaseWriter::instance()->accept(op_name) ? MODE_BINARY : MODE_SKIP;
+  info_.op_name = op_name;
+  info_.op_type = op_type;
+}
+
+CaseBuilder::~CaseBuilder() {
+  if (mode_ != MODE_BINARY) {
+    CaseWriter::instance()->release(reserved_bytes_);
+    return;
+  }
+  std::unique_ptr<PendingCase> pending(new PendingCase());
+  pending->file_name = CaseWriter::instance()->nextFileName(info_.op_name);
+  pending->info      = std::move(info_);
+  pending->payloads  = std::move(payloads_);
+  pending->bytes     = reserved_bytes_;
+  CaseWriter::instance()->submit(std::move(pending));
+}
+
+void CaseBuilder::addData(bool is_input,
+                          const std::string &id,
+                          const void *device_data,
+                          const int dim,
+                          const std::vector<int> &dims,
+                          cnnlDataType_t dtype,
+                          cnnlTensorLayout_t layout,
+                          const float upper_bound,
+                          const float lower_bound) {
+  if (mode_ != MODE_BINARY) {
+    return;
+  }
+  CaseTensor tensor;
+  tensor.id          = id;
+  tensor.is_input    = is_input;
+  tensor.dtype       = dtype;
+  tensor.layout      = layout;
+  tensor.dims        = std::vector<int>(dims.begin(), dims.begin() + dim);
+  tensor.upper_bound = upper_bound;
+  tensor.lower_bound = lower_bound;
+  info_.tensors.push_back(tensor);
+  payloads_.push_back(std::vector<char>());
+
+  if (!is_input || device_data == NULL) {
+    return;
+  }
+  uint64_t count = 1;
+  for (int i = 0; i < dim; ++i) {
+    count *= dims[i];
+  }
+  uint64_t bytes = count * getSizeOfDataType(dtype);
+  if (bytes == 0) {
+    return;
+  }
+  if (!CaseWriter::instance()->reserve(bytes)) {
+    LOG_FIRST_N(WARNING, 1) << "[gen_case] binary case queue or budget is full, skip cases.";
+    CaseWriter::instance()->skipped.fetch_add(1);
+    mode_ = MODE_SKIP;
+    return;
+  }
+  reserved_bytes_ += bytes;
+  payloads_.back().resize(bytes);
+  if (cnrtMemcpy(payloads_.back().data(), (void *)device_data, bytes,
+                 CNRT_MEM_TRANS_DIR_DEV2HOST) != CNRT_RET_SUCCESS) {
+    LOG(ERROR) << "[gen_case] Dump data failed! cnrtMemcpy data size is " << bytes << " byte.";
+    mode_ = MODE_SKIP;
+  }
+}
+
+void CaseBuilder::addData(bool is_input,
+                          const std::string &id,
+                          const void *device_data,
+                          const cnnlTensorDescriptor_t desc,
+                          const float upper_bound,
+                          const float lower_bound) {
+  addData(is_input, id, device_data, desc->dim, desc->dims, desc->dtype, desc->layout,
+          upper_bound, lower_bound);
+}
+
+void CaseBuilder::addParam(const int flag,
+                           const std::string &op_name,
+                           const std::string &param_name,
+                           const float value) {
+  if (mode_ != MODE_BINARY) {
+    return;
+  }
+  CaseParam param;
+  param.op_name    = op_name;
+  param.param_name = param_name;
+  param.kind       = CASE_PARAM_FLOAT;
+  param.float_values.push_back(value);
+  info_.params.push_back(param);
+}
+
+void CaseBuilder::addParam(const int flag,
+                           const std::string &op_name,
+                           const std::string &param_name,
+                           const std::string &value) {
+  if (mode_ != MODE_BINARY) {
+    return;
+  }
+  CaseParam param;
+  param.op_name    = op_name;
+  param.param_name = param_name;
+  param.kind       = CASE_PARAM_STRING;
+  param.str_value  = value;
+  info_.params.push_back(param);
+}
+
+void CaseBuilder::addParam(const int flag,
+                           const std::string &op_name,
+                           const std::string &param_name,
+                           const int *value,
+                           const int num) {
+  if (mode_ != MODE_BINARY) {
+    return;
+  }
+  CaseParam param;
+  param.op_name    = op_name;
+  param.param_name = param_name;
+  param.kind       = CASE_PARAM_INT_ARRAY;
+  param.int_values.assign(value, value + num);
+  info_.params.push_back(param);
+}
+
+void CaseBuilder::addParam(const int flag,
+                           const std::string &op_name,
+                           const std::string &param_name,
+                           const float *value,
+                           const int num) {
+  if (mode_ != MODE_BINARY) {
+    return;
+  }
+  CaseParam param;
+  param.op_name    = op_name;
+  param.param_name = param_name;
+  param.kind       = CASE_PARAM_FLOAT_ARRAY;
+  param.float_values.assign(value, value + num);
+  info_.params.push_back(param);
+}
+
+void CaseBuilder::setTestParam(bool is_diff1,
+                               bool is_diff2,
+                               bool is_diff3,
+                               const float diff1_threshold,
+                               const float diff2_threshold,
+                               const float diff3_threshold) {
+  info_.test_param.is_diff[0]   = is_diff1;
+  info_.test_param.is_diff[1]   = is_diff2;
+  info_.test_param.is_diff[2]   = is_diff3;
+  info_.test_param.threshold[0] = diff1_threshold;
+  info_.test_param.threshold[1] = diff2_threshold;
+  info_.test_param.threshold[2] = diff3_threshold;
+}
+
+// Write the queued cases at exit, from an atexit hook registered with the writer thread
+// rather than a static destructor, so that the thread is joined while the process is whole.
+static void closeCaseDump() {
+  CaseWriter::instance()->stop();
+}
+
+}  // namespace case_dump
+}  // namespace cnnl
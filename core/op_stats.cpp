@@ -0,0 +1,254 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <string.h>
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+#include "include/logging.h"
+#include "include/macros.h"
+#include "include/op_stats.h"
+
+namespace cnnl {
+namespace op_stats {
+
+struct HandleCounters {
+  OpCounters ops[CNNL_STATS_MAX_OPS];
+};
+
+struct ThreadCounters {
+  std::mutex mutex;  // guards handles, taken by the owner only when it meets a new handle
+  std::unordered_map<const void *, HandleCounters *> handles;
+};
+
+static inline uint64_t read(const Counter &counter) {
+  return counter.value.load(std::memory_order_relaxed);
+}
+
+// Adds or subtracts the counters of src to dst, kernels are matched by name.
+static void accumulate(const cnnlOpStatistics_t &src, cnnlOpStatistics_t *dst, bool subtract) {
+  uint64_t sign = subtract ? (uint64_t)-1 : 1;
+  dst->calls += sign * src.calls;
+  dst->param_check_failures += sign * src.param_check_failures;
+  dst->zero_element_calls += sign * src.zero_element_calls;
+  dst->arch_mismatches += sign * src.arch_mismatches;
+  dst->launches += sign * src.launches;
+  dst->elements += sign * src.elements;
+  dst->bytes += sign * src.bytes;
+  for (int i = 0; i < src.kernel_num; ++i) {
+    int j = 0;
+    while (j < dst->kernel_num && strcmp(dst->kernels[j].kernel_name, src.kernels[i].kernel_name)) {
+      j++;
+    }
+    if (j == dst->kernel_num) {
+      if (j == CNNL_STATS_MAX_KERNELS) {
+        continue;
+      }
+      dst->kernels[j].kernel_name = src.kernels[i].kernel_name;
+      dst->kernels[j].launches    = 0;
+      dst->kernel_num++;
+    }
+    dst->kernels[j].launches += sign * src.kernels[i].launches;
+  }
+}
+
+class StatsRegistry {
+ public:
+  static StatsRegistry *instance() {
+    // intentionally leaked, operations may be called during static destruction.
+    static StatsRegistry *registry = new StatsRegistry();
+    return registry;
+  }
+
+  int registerOp(const char *op_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < op_names_.size(); ++i) {
+      if (strcmp(op_names_[i], op_name) == 0) {
+        return i;
+      }
+    }
+    if (op_names_.size() >= CNNL_STATS_MAX_OPS) {
+      LOG_FIRST_N(WARNING, 1) << "[op_stats] more than " << CNNL_STATS_MAX_OPS
+                              << " operations, " << op_name << " is not counted.";
+      return -1;
+    }
+    op_names_.push_back(op_name);
+    return op_names_.size() - 1;
+  }
+
+  ThreadCounters *threadCounters() {
+    static thread_local ThreadCounters *counters = NULL;
+    if (CNNL_PREDICT_FALSE(counters == NULL)) {
+      counters = new ThreadCounters();
+      std::lock_guard<std::mutex> lock(mutex_);
+      threads_.push_back(counters);
+    }
+    return counters;
+  }
+
+  // Counters of handle since its last reset, indexed by operation id.
+  std::vector<cnnlOpStatistics_t> collect(cnnlHandle_t handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<cnnlOpStatistics_t> totals = sum(handle);
+    auto baseline = baselines_.find(handle);
+    if (baseline != baselines_.end()) {
+      for (size_t i = 0; i < baseline->second.size(); ++i) {
+        accumulate(baseline->second[i], &totals[i], true);
+      }
+    }
+    return totals;
+  }
+
+  void reset(cnnlHandle_t handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    baselines_[handle] = sum(handle);
+  }
+
+  // Frees the counters of handle in every thread, the caches of threadOpCounters are
+  // invalidated so a handle created later at the same address gets new counters.
+  void release(cnnlHandle_t handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto thread : threads_) {
+      std::lock_guard<std::mutex> thread_lock(thread->mutex);
+      auto found = thread->handles.find(handle);
+      if (found != thread->handles.end()) {
+        delete found->second;
+        thread->handles.erase(found);
+      }
+    }
+    baselines_.erase(handle);
+    generation.fetch_add(1, std::memory_order_release);
+  }
+
+  std::atomic<uint64_t> generation{0};  // releases so far
+
+ private:
+  // Called with mutex_ held.
+  std::vector<cnnlOpStatistics_t> sum(cnnlHandle_t handle) {
+    cnnlOpStatistics_t zero;
+    memset(&zero, 0, sizeof(zero));
+    std::vector<cnnlOpStatistics_t> totals(op_names_.size(), zero);
+    for (size_t i = 0; i < totals.size(); ++i) {
+      totals[i].op_name = op_names_[i];
+    }
+    for (auto thread : threads_) {
+      std::lock_guard<std::mutex> lock(thread->mutex);
+      auto found = thread->handles.find(handle);
+      if (found == thread->handles.end()) {
+        continue;
+      }
+      for (size_t i = 0; i < totals.size(); ++i) {
+        const OpCounters &counters = found->second->ops[i];
+        cnnlOpStatistics_t op;
+        memset(&op, 0, sizeof(op));
+        op.calls                = read(counters.calls);
+        op.param_check_failures = read(counters.param_check_failures);
+        op.zero_element_calls   = read(counters.zero_element_calls);
+        op.arch_mismatches      = read(counters.arch_mismatches);
+        op.launches             = read(counters.launches);
+        op.elements             = read(counters.elements);
+        op.bytes                = read(counters.bytes);
+        for (int k = 0; k < CNNL_STATS_MAX_KERNELS; ++k) {
+          const char *name = counters.kernels[k].kernel_name.load(std::memory_order_acquire);
+          if (name == NULL) {
+            break;
+          }
+          op.kernels[k].kernel_name = name;
+          op.kernels[k].launches    = read(counters.kernels[k].launches);
+          op.kernel_num++;
+        }
+        accumulate(op, &totals[i], false);
+      }
+    }
+    return totals;
+  }
+
+  std::mutex mutex_;
+  std::vector<const char *> op_names_;  // literals of OP_STATS_START
+  std::vector<ThreadCounters *> threads_;  // counters of exited threads are kept
+  std::unordered_map<const void *, std::vector<cnnlOpStatistics_t>> baselines_;
+};
+
+int registerOp(const char *op_name) {
+  return StatsRegistry::instance()->registerOp(op_name);
+}
+
+OpCounters *threadOpCounters(cnnlHandle_t handle, int op_id) {
+  if (op_id < 0) {
+    return NULL;
+  }
+  static thread_local cnnlHandle_t last_handle        = NULL;
+  static thread_local HandleCounters *last_counters = NULL;
+  static thread_local uint64_t last_generation       = 0;
+  StatsRegistry *registry = StatsRegistry::instance();
+  uint64_t generation     = registry->generation.load(std::memory_order_acquire);
+  if (CNNL_PREDICT_FALSE(handle != last_handle || generation != last_generation)) {
+    ThreadCounters *thread = registry->threadCounters();
+    std::lock_guard<std::mutex> lock(thread->mutex);
+    HandleCounters *&counters = thread->handles[handle];
+    if (counters == NULL) {
+      counters = new HandleCounters();
+    }
+    last_handle     = handle;
+    last_counters   = counters;
+    last_generation = generation;
+  }
+  return &last_counters->ops[op_id];
+}
+
+}  // namespace op_stats
+}  // namespace cnnl
+
+cnnlStatus_t CNNL_WIN_API cnnlGetHandleStatistics(cnnlHandle_t handle,
+                                                  cnnlHandleStatistics_t *stats) {
+  PARAM_CHECK("[cnnlGetHandleStatistics]", handle != NULL);
+  PARAM_CHECK("[cnnlGetHandleStatistics]", stats != NULL);
+  memset(stats, 0, sizeof(*stats));
+  std::vector<cnnlOpStatistics_t> totals =
+      cnnl::op_stats::StatsRegistry::instance()->collect(handle);
+  for (auto &op : totals) {
+    if (op.calls == 0) {
+      continue;
+    }
+    // the variant is encoded in the kernel names, e.g. MLUBlockKernel5StagePipelineAbsfloatFast
+    for (int i = 0; i < op.kernel_num; ++i) {
+      const char *name  = op.kernels[i].kernel_name;
+      uint64_t launches = op.kernels[i].launches;
+      if (strstr(name, "3Stage") != NULL) {
+        op.three_stage_launches += launches;
+      } else if (strstr(name, "5Stage") != NULL) {
+        op.five_stage_launches += launches;
+      }
+      if (strstr(name, "HighAcc") != NULL) {
+        op.high_precision_launches += launches;
+      } else if (strstr(name, "Approx") != NULL) {
+        op.approx_launches += launches;
+      } else if (strstr(name, "Fast") != NULL) {
+        op.fast_launches += launches;
+      }
+    }
+    stats->ops[stats->op_num++] = op;
+  }
+  return CNNL_STATUS_SUCCESS;
+}
+
+cnnlStatus_t CNNL_WIN_API cnnlResetHandleStatistics(cnnlHandle_t handle) {
+  PARAM_CHECK("[cnnlResetHandleStatistics]", handle != NULL);
+  cnnl::op_stats::StatsRegistry::instance()->reset(handle);
+  return CNNL_STATUS_SUCCESS;
+}
+
+cnnlStatus_t CNNL_WIN_API cnnlReleaseHandleStatistics(cnnlHandle_t handle) {
+  PARAM_CHECK("[cnnlReleaseHandleStatistics]", handle != NULL);
+  cnnl::op_stats::StatsRegistry::instance()->release(handle);
+  return CNNL_STATUS_SUCCESS;
+}
@@ -0,0 +1,616 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <fstream>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <tuple>
+#include <vector>
+#include "include/logging.h"
+#include "include/op_timing.h"
+#include "cnnl_example.h"
+
+namespace cnnl {
+namespace op_timing {
+
+#define OP_TIMING_RING_SIZE 1024
+#define OP_TIMING_DRAIN_INTERVAL_MS 100
+
+/******************************************************************************
+ * LatencyHistogram
+ ******************************************************************************/
+void LatencyHistogram::reset() {
+  memset(counts_, 0, sizeof(counts_));
+  count_ = 0;
+  sum_   = 0;
+  min_   = UINT64_MAX;
+  max_   = 0;
+}
+
+int LatencyHistogram::bucketIndex(uint64_t value) {
+  if (value < 2 * kSubBucketCount) {
+    return (int)value;
+  }
+  int msb = 63 - __builtin_clzll(value);
+  if (msb > kMaxMsb) {
+    return kBucketNum - 1;
+  }
+  int shift = msb - kSubBucketBits;
+  int top   = (int)(value >> shift);  // in [kSubBucketCount, 2 * kSubBucketCount)
+  return 2 * kSubBucketCount + (msb - kSubBucketBits - 1) * kSubBucketCount +
+         (top - kSubBucketCount);
+}
+
+uint64_t LatencyHistogram::bucketValue(int index) {
+  if (index < 2 * kSubBucketCount) {
+    return (uint64_t)index;
+  }
+  int msb   = (index - 2 * kSubBucketCount) / kSubBucketCount + kSubBucketBits + 1;
+  int top   = (index - 2 * kSubBucketCount) % kSubBucketCount + kSubBucketCount;
+  int shift = msb - kSubBucketBits;
+  // the middle of [top << shift, (top + 1) << shift)
+  return ((uint64_t)top << shift) + ((1ULL << shift) >> 1);
+}
+
+void LatencyHistogram::record(uint64_t value) {
+  counts_[bucketIndex(value)]++;
+  count_++;
+  sum_ += value;
+  min_ = value < min_ ? value : min_;
+  max_ = value > max_ ? value : max_;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+  for (int i = 0; i < kBucketNum; ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  min_ = other.min_ < min_ ? other.min_ : min_;
+  max_ = other.max_ > max_ ? other.max_ : max_;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  uint64_t rank = (uint64_t)(q * count_ + 0.5);
+  rank          = rank < 1 ? 1 : (rank > count_ ? count_ : rank);
+  uint64_t seen = 0;
+  for (int i = 0; i < kBucketNum; ++i) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      uint64_t value = bucketValue(i);
+      value          = value < min_ ? min_ : value;
+      return value > max_ ? max_ : value;
+    }
+  }
+  return max_;
+}
+
+/******************************************************************************
+ * per-thread ring buffer
+ ******************************************************************************/
+struct TimingRecord {
+  const char *op_name;
+  const char *kernel_name;
+  int size_bucket;
+  uint64_t host_ns;
+  bool has_notifier;
+  size_t bytes;
+  int used_cores;
+  int total_cores;
+  double peak_bandwidth;
+};
+
+// Single producer (the thread calling cnnl operations), single consumer (the aggregator,
+// serialized by Collector::mutex). Each slot owns its notifier pair, so notifiers are
+// reused with the slot and never cross threads, except a pair lent to the trace, which
+// skips the hardware time of the launches getting its slot until the trace releases it.
+struct TimingRing {
+  TimingRing() : head(0), tail(0) {
+    memset(notifier_start, 0, sizeof(notifier_start));
+    memset(notifier_end, 0, sizeof(notifier_end));
+    for (int i = 0; i < OP_TIMING_RING_SIZE; ++i) {
+      lent[i].store(false, std::memory_order_relaxed);
+    }
+  }
+  TimingRecord records[OP_TIMING_RING_SIZE];
+  cnrtNotifier_t notifier_start[OP_TIMING_RING_SIZE];
+  cnrtNotifier_t notifier_end[OP_TIMING_RING_SIZE];
+  std::atomic<bool> lent[OP_TIMING_RING_SIZE];
+  std::atomic<uint64_t> head;
+  std::atomic<uint64_t> tail;
+};
+
+struct TimingEntry {
+  LatencyHistogram host;
+  LatencyHistogram device;
+  uint64_t bytes        = 0;  // of the calls having hardware time
+  uint64_t device_ns    = 0;
+  double min_efficiency = 0;
+  int used_cores        = 0;
+  int total_cores       = 0;
+  double peak_bandwidth = 0;
+};
+
+typedef std::tuple<std::string, std::string, int> TimingKey;
+
+static void exitDump();
+
+class Collector {
+ public:
+  static Collector *instance() {
+    // intentionally leaked, the aggregator thread and the exit dump may outlive statics.
+    static Collector *collector = new Collector();
+    return collector;
+  }
+
+  TimingRing *threadRing() {
+    static thread_local TimingRing *ring = NULL;
+    if (CNNL_PREDICT_FALSE(ring == NULL)) {
+      ring = new TimingRing();
+      std::lock_guard<std::mutex> lock(mutex_);
+      rings_.push_back(ring);
+      if (!aggregator_.joinable()) {
+        aggregator_ = std::thread(&Collector::aggregatorLoop, this);
+        // The first ring comes with the first timed operation, after the runtime is up, so
+        // the hook runs before the runtime is torn down and can still wait for notifiers.
+        atexit(exitDump);
+      }
+    }
+    return ring;
+  }
+
+  // Moves finished records of every ring into the histograms. Records whose notifiers
+  // are not reached yet stay in the ring unless wait_device is true.
+  void drain(bool wait_device) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto ring : rings_) {
+      uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+      uint64_t head = ring->head.load(std::memory_order_acquire);
+      for (; tail < head; ++tail) {
+        int slot                   = tail % OP_TIMING_RING_SIZE;
+        const TimingRecord &record = ring->records[slot];
+        float device_us            = -1;
+        if (record.has_notifier) {
+          if (wait_device) {
+            cnrtWaitNotifier(ring->notifier_end[slot]);
+          } else if (cnrtQueryNotifier(ring->notifier_end[slot]) != CNRT_RET_SUCCESS) {
+            break;  // keep the order, retry on the next round
+          }
+          cnrtNotifierDuration(ring->notifier_start[slot], ring->notifier_end[slot], &device_us);
+        }
+        TimingEntry &entry =
+            entries_[std::make_tuple(record.op_name, record.kernel_name, record.size_bucket)];
+        entry.host.record(record.host_ns);
+        if (device_us >= 0) {
+          uint64_t device_ns = (uint64_t)(device_us * 1000);
+          entry.device.record(device_ns);
+          if (record.bytes > 0 && device_ns > 0) {
+            recordTraffic(record, device_ns, &entry);
+          }
+        }
+      }
+      ring->tail.store(tail, std::memory_order_release);
+    }
+  }
+
+  void snapshot(std::vector<OpTimingStats> *stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats->clear();
+    for (auto &it : entries_) {
+      OpTimingStats item;
+      item.op_name     = std::get<0>(it.first);
+      item.kernel_name = std::get<1>(it.first);
+      item.size_bucket = std::get<2>(it.first);
+      summarize(it.second.host, &item.host);
+      summarize(it.second.device, &item.device);
+      const TimingEntry &entry = it.second;
+      if (entry.device_ns > 0) {
+        item.bytes          = entry.bytes;
+        item.bandwidth      = (double)entry.bytes / entry.device_ns;
+        item.peak_bandwidth = entry.peak_bandwidth;
+        item.efficiency =
+            entry.peak_bandwidth > 0 ? item.bandwidth / entry.peak_bandwidth * 100 : 0;
+        item.min_efficiency = entry.min_efficiency;
+        item.used_cores     = entry.used_cores;
+        item.total_cores    = entry.total_cores;
+      }
+      stats->push_back(item);
+    }
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    dropped.store(0);
+  }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    if (aggregator_.joinable()) {
+      aggregator_.join();
+    }
+  }
+
+  std::atomic<uint64_t> dropped;
+
+ private:
+  Collector() : dropped(0) {}
+
+  static void summarize(const LatencyHistogram &hist, LatencySummary *summary) {
+    summary->count = hist.count();
+    summary->mean  = hist.mean();
+    summary->min   = hist.min();
+    summary->p50   = hist.percentile(0.5);
+    summary->p99   = hist.percentile(0.99);
+    summary->p999  = hist.percentile(0.999);
+    summary->max   = hist.max();
+  }
+
+  // bytes per nanosecond is GB/s.
+  static void recordTraffic(const TimingRecord &record, uint64_t device_ns, TimingEntry *entry) {
+    double bandwidth  = (double)record.bytes / device_ns;
+    double efficiency = record.peak_bandwidth > 0 ? bandwidth / record.peak_bandwidth * 100 : 0;
+    if (entry->device_ns == 0 || efficiency < entry->min_efficiency) {
+      entry->min_efficiency = efficiency;
+    }
+    entry->bytes += record.bytes;
+    entry->device_ns += device_ns;
+    entry->used_cores     = record.used_cores;
+    entry->total_cores    = record.total_cores;
+    entry->peak_bandwidth = record.peak_bandwidth;
+    if (isOpBandwidthOn()) {
+      LOG(INFO) << "[op_bandwidth] " << record.op_name << " " << record.kernel_name << " "
+                << record.bytes << " bytes in " << device_ns / 1000.0 << " us, " << bandwidth
+                << " GB/s, " << efficiency << "% of " << record.peak_bandwidth << " GB/s, "
+                << record.used_cores << "/" << record.total_cores << " cores.";
+    }
+  }
+
+  void aggregatorLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+      cv_.wait_for(lock, std::chrono::milliseconds(OP_TIMING_DRAIN_INTERVAL_MS));
+      if (stop_) {
+        break;
+      }
+      lock.unlock();
+      drain(false);
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread aggregator_;
+  bool stop_ = false;
+  std::vector<TimingRing *> rings_;  // rings of exited threads are kept and still drained
+  std::map<TimingKey, TimingEntry> entries_;
+};
+
+/******************************************************************************
+ * mode and api
+ ******************************************************************************/
+#define OP_TIMING_MODE_UNSET -1
+#define OP_TIMING_MODE_HOST 1
+#define OP_TIMING_MODE_HW 2
+#define OP_TIMING_MODE_BANDWIDTH 4
+
+static std::atomic<int> op_timing_mode(OP_TIMING_MODE_UNSET);
+
+static int loadMode() {
+  int mode = op_timing_mode.load(std::memory_order_relaxed);
+  if (CNNL_PREDICT_FALSE(mode == OP_TIMING_MODE_UNSET)) {
+    mode = 0;
+    if (cnlog::getBoolEnvVar("CNNL_OP_TIMING", false)) {
+      mode |= OP_TIMING_MODE_HOST;
+    }
+    if (cnlog::getBoolEnvVar("CNNL_OP_TIMING_HW", false)) {
+      mode |= OP_TIMING_MODE_HOST | OP_TIMING_MODE_HW;
+    }
+    if (cnlog::getBoolEnvVar("CNNL_OP_BANDWIDTH", false)) {
+      mode |= OP_TIMING_MODE_HOST | OP_TIMING_MODE_HW | OP_TIMING_MODE_BANDWIDTH;
+    }
+    op_timing_mode.store(mode, std::memory_order_relaxed);
+  }
+  return mode;
+}
+
+bool isOpTimingOn() {
+  return loadMode() & OP_TIMING_MODE_HOST;
+}
+
+bool isOpTimingHwOn() {
+  return loadMode() & OP_TIMING_MODE_HW;
+}
+
+bool isOpBandwidthOn() {
+  return loadMode() & OP_TIMING_MODE_BANDWIDTH;
+}
+
+void setOpTimingMode(bool host_on, bool hw_on, bool bandwidth_on) {
+  int mode = 0;
+  if (host_on || hw_on || bandwidth_on) {
+    mode |= OP_TIMING_MODE_HOST;
+  }
+  if (hw_on || bandwidth_on) {
+    mode |= OP_TIMING_MODE_HW;
+  }
+  if (bandwidth_on) {
+    mode |= OP_TIMING_MODE_BANDWIDTH;
+  }
+  op_timing_mode.store(mode, std::memory_order_relaxed);
+}
+
+uint64_t nowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int sizeBucket(size_t element_num) {
+  return element_num == 0 ? 0 : 63 - __builtin_clzll((unsigned long long)element_num);
+}
+
+void OpTimer::placeStart(cnrtQueue_t queue) {
+  if (!isOpTimingHwOn()) {
+    return;
+  }
+  TimingRing *ring = Collector::instance()->threadRing();
+  uint64_t head    = ring->head.load(std::memory_order_relaxed);
+  if (head - ring->tail.load(std::memory_order_acquire) >= OP_TIMING_RING_SIZE) {
+    return;  // full, commit() counts the drop
+  }
+  slot_ = head % OP_TIMING_RING_SIZE;
+  if (ring->lent[slot_].load(std::memory_order_acquire)) {
+    slot_ = -1;  // the trace still reads the pair of an earlier launch
+    return;
+  }
+  if (ring->notifier_start[slot_] == NULL) {
+    if (cnrtCreateNotifier(&ring->notifier_start[slot_]) != CNRT_RET_SUCCESS ||
+        cnrtCreateNotifier(&ring->notifier_end[slot_]) != CNRT_RET_SUCCESS) {
+      LOG_FIRST_N(WARNING, 1) << "[op_timing] create notifier failed, skip hardware time.";
+      ring->notifier_start[slot_] = NULL;
+      slot_ = -1;
+      return;
+    }
+  }
+  cnrtPlaceNotifier(ring->notifier_start[slot_], queue);
+}
+
+bool OpTimer::lendNotifiers(NotifierLease *lease) {
+  if (!active_ || slot_ < 0) {
+    return false;
+  }
+  TimingRing *ring = Collector::instance()->threadRing();
+  ring->lent[slot_].store(true, std::memory_order_release);
+  lease->start = ring->notifier_start[slot_];
+  lease->end   = ring->notifier_end[slot_];
+  lease->lent  = &ring->lent[slot_];
+  return true;
+}
+
+void releaseNotifiers(const NotifierLease &lease) {
+  if (lease.lent != NULL) {
+    lease.lent->store(false, std::memory_order_release);
+  }
+}
+
+void OpTimer::commit(cnrtQueue_t queue, const char *kernel_name, size_t element_num) {
+  ended_               = true;
+  Collector *collector = Collector::instance();
+  TimingRing *ring     = collector->threadRing();
+  uint64_t head        = ring->head.load(std::memory_order_relaxed);
+  if (head - ring->tail.load(std::memory_order_acquire) >= OP_TIMING_RING_SIZE) {
+    collector->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  int slot             = head % OP_TIMING_RING_SIZE;
+  TimingRecord &record = ring->records[slot];
+  record.op_name       = op_name_;
+  record.kernel_name   = kernel_name == NULL ? "" : kernel_name;
+  record.size_bucket   = sizeBucket(element_num);
+  record.host_ns       = nowNanos() - start_ns_;
+  record.has_notifier  = slot_ == slot;
+  record.bytes          = bytes_;
+  record.used_cores     = used_cores_;
+  record.total_cores    = total_cores_;
+  record.peak_bandwidth = peak_bandwidth_;
+  if (record.has_notifier) {
+    cnrtPlaceNotifier(ring->notifier_end[slot], queue);
+  }
+  ring->head.store(head + 1, std::memory_order_release);
+}
+
+void getOpTimingStats(std::vector<OpTimingStats> *stats) {
+  Collector::instance()->drain(true);
+  Collector::instance()->snapshot(stats);
+}
+
+uint64_t getOpTimingDropped() {
+  return Collector::instance()->dropped.load();
+}
+
+void resetOpTiming() {
+  Collector::instance()->drain(true);
+  Collector::instance()->reset();
+}
+
+static void writeSummaryJson(std::ofstream &out, const LatencySummary &summary) {
+  out << "{\"count\": " << summary.count << ", \"mean\": " << summary.mean
+      << ", \"min\": " << summary.min << ", \"p50\": " << summary.p50
+      << ", \"p99\": " << summary.p99 << ", \"p999\": " << summary.p999
+      << ", \"max\": " << summary.max << "}";
+}
+
+bool dumpOpTimingJson(const std::string &file_name) {
+  std::vector<OpTimingStats> stats;
+  getOpTimingStats(&stats);
+  std::ofstream out(file_name.c_str());
+  if (!out.is_open()) {
+    LOG(ERROR) << "[op_timing] open " << file_name << " failed.";
+    return false;
+  }
+  out << "{\n  \"unit\": \"ns\",\n  \"dropped\": " << getOpTimingDropped()
+      << ",\n  \"ops\": [";
+  for (size_t i = 0; i < stats.size(); ++i) {
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\"op\": \"" << stats[i].op_name << "\", \"kernel\": \"" << stats[i].kernel_name
+        << "\", \"size_bucket\": " << stats[i].size_bucket << ", \"host\": ";
+    writeSummaryJson(out, stats[i].host);
+    out << ", \"device\": ";
+    writeSummaryJson(out, stats[i].device);
+    out << ", \"bytes\": " << stats[i].bytes << ", \"bandwidth_gbps\": " << stats[i].bandwidth
+        << ", \"peak_bandwidth_gbps\": " << stats[i].peak_bandwidth
+        << ", \"efficiency\": " << stats[i].efficiency
+        << ", \"min_efficiency\": " << stats[i].min_efficiency
+        << ", \"used_cores\": " << stats[i].used_cores
+        << ", \"total_cores\": " << stats[i].total_cores << "}";
+  }
+  out << "\n  ]\n}\n";
+  return true;
+}
+
+static void writeSummaryCsv(std::ofstream &out, const LatencySummary &summary) {
+  out << summary.count << "," << summary.mean << "," << summary.min << "," << summary.p50 << ","
+      << summary.p99 << "," << summary.p999 << "," << summary.max;
+}
+
+bool dumpOpTimingCsv(const std::string &file_name) {
+  std::vector<OpTimingStats> stats;
+  getOpTimingStats(&stats);
+  std::ofstream out(file_name.c_str());
+  if (!out.is_open()) {
+    LOG(ERROR) << "[op_timing] open " << file_name << " failed.";
+    return false;
+  }
+  out << "op,kernel,size_bucket,host_count,host_mean_ns,host_min_ns,host_p50_ns,host_p99_ns,"
+         "host_p999_ns,host_max_ns,device_count,device_mean_ns,device_min_ns,device_p50_ns,"
+         "device_p99_ns,device_p999_ns,device_max_ns,bytes,bandwidth_gbps,peak_bandwidth_gbps,"
+         "efficiency,min_efficiency,used_cores,total_cores\n";
+  for (auto &item : stats) {
+    out << item.op_name << "," << item.kernel_name << "," << item.size_bucket << ",";
+    writeSummaryCsv(out, item.host);
+    out << ",";
+    writeSummaryCsv(out, item.device);
+    out << "," << item.bytes << "," << item.bandwidth << "," << item.peak_bandwidth << ","
+        << item.efficiency << "," << item.min_efficiency << "," << item.used_cores << ","
+        << item.total_cores << "\n";
+  }
+  return true;
+}
+
+bool dumpOpTiming(const std::string &file_name) {
+  if (file_name.size() > 4 && file_name.compare(file_name.size() - 4, 4, ".csv") == 0) {
+    return dumpOpTimingCsv(file_name);
+  }
+  return dumpOpTimingJson(file_name);
+}
+
+// One line per kernel variant, the variants not using every core are marked.
+static void logBandwidthSummary() {
+  std::vector<OpTimingStats> stats;
+  getOpTimingStats(&stats);
+  for (auto &item : stats) {
+    if (item.bytes == 0) {
+      continue;
+    }
+    LOG(INFO) << "[op_bandwidth] " << item.op_name << " " << item.kernel_name << " size 2^"
+              << item.size_bucket << ": " << item.device.count << " calls, " << item.bandwidth
+              << " GB/s, " << item.efficiency << "% of " << item.peak_bandwidth
+              << " GB/s (slowest call " << item.min_efficiency << "%), " << item.used_cores << "/"
+              << item.total_cores << " cores"
+              << (item.used_cores < item.total_cores ? " [under-used]" : "") << ".";
+  }
+}
+
+// Dump the statistics to CNNL_OP_TIMING_FILE at exit. An atexit hook rather than a static
+// destructor, which could run after the runtime owning the notifiers is unloaded.
+static void exitDump() {
+  if (op_timing_mode.load() <= 0) {
+    Collector::instance()->stop();
+    return;
+  }
+  if (isOpBandwidthOn()) {
+    logBandwidthSummary();
+  }
+  const char *file_name = getenv("CNNL_OP_TIMING_FILE");
+  if (file_name != NULL && strlen(file_name) > 0) {
+    dumpOpTiming(file_name);
+  }
+  Collector::instance()->stop();
+}
+
+}  // namespace op_timing
+}  // namespace cnnl
+
+static void copySummary(const cnnl::op_timing::LatencySummary &from, cnnlLatencySummary_t *to) {
+  to->count = from.count;
+  to->mean  = from.mean;
+  to->min   = from.min;
+  to->p50   = from.p50;
+  to->p99   = from.p99;
+  to->p999  = from.p999;
+  to->max   = from.max;
+}
+
+cnnlStatus_t CNNL_WIN_API cnnlSetOpTimingMode(cnnlOpTimingMode_t mode) {
+  PARAM_CHECK("[cnnlSetOpTimingMode]", mode >= CNNL_OP_TIMING_OFF);
+  PARAM_CHECK("[cnnlSetOpTimingMode]", mode <= CNNL_OP_TIMING_BANDWIDTH);
+  cnnl::op_timing::setOpTimingMode(mode >= CNNL_OP_TIMING_HOST, mode >= CNNL_OP_TIMING_HARDWARE,
+                                   mode >= CNNL_OP_TIMING_BANDWIDTH);
+  return CNNL_STATUS_SUCCESS;
+}
+
+cnnlStatus_t CNNL_WIN_API cnnlGetOpTimingStatistics(cnnlOpTimingStatistics_t *stats) {
+  PARAM_CHECK("[cnnlGetOpTimingStatistics]", stats != NULL);
+  memset(stats, 0, sizeof(*stats));
+  std::vector<cnnl::op_timing::OpTimingStats> items;
+  cnnl::op_timing::getOpTimingStats(&items);
+  stats->dropped = cnnl::op_timing::getOpTimingDropped();
+  for (size_t i = 0; i < items.size() && i < CNNL_OP_TIMING_MAX_ENTRIES; ++i) {
+    cnnlOpTimingEntry_t &entry = stats->entries[stats->entry_num++];
+    snprintf(entry.op_name, sizeof(entry.op_name), "%s", items[i].op_name.c_str());
+    snprintf(entry.kernel_name, sizeof(entry.kernel_name), "%s", items[i].kernel_name.c_str());
+    entry.size_bucket = items[i].size_bucket;
+    copySummary(items[i].host, &entry.host);
+    copySummary(items[i].device, &entry.device);
+    entry.bytes          = items[i].bytes;
+    entry.bandwidth      = items[i].bandwidth;
+    entry.peak_bandwidth = items[i].peak_bandwidth;
+    entry.efficiency     = items[i].efficiency;
+  }
+  return CNNL_STATUS_SUCCESS;
+}
+
+cnnlStatus_t CNNL_WIN_API cnnlResetOpTimingStatistics(void) {
+  cnnl::op_timing::resetOpTiming();
+  return CNNL_STATUS_SUCCESS;
+}
+
+cnnlStatus_t CNNL_WIN_API cnnlDumpOpTimingStatistics(const char *file_name) {
+  PARAM_CHECK("[cnnlDumpOpTimingStatistics]", file_name != NULL && strlen(file_name) > 0);
+  return cnnl::op_timing::dumpOpTiming(file_name) ? CNNL_STATUS_SUCCESS
+                                                  : CNNL_STATUS_EXECUTION_FAILED;
+}
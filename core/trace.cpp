@@ -0,0 +1,398 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "include/logging.h"
+#include "include/op_timing.h"
+#include "include/trace.h"
+
+namespace cnnl {
+namespace trace {
+
+#define TRACE_FLUSH_INTERVAL_MS 200
+// Bound of the events buffered by one thread between two flushes, newer events are dropped.
+#define TRACE_MAX_BUFFERED_EVENTS (64 * 1024)
+// Device tracks are shown as thread id + TRACE_DEVICE_TID_OFFSET.
+#define TRACE_DEVICE_TID_OFFSET 100000
+
+struct TraceEvent {
+  const char *name;
+  const char *cat;
+  uint64_t ts_ns;  // the host launch time of a device event, used when there is no anchor
+  uint64_t dur_ns;
+  // start is not NULL for a device event waiting for its duration
+  cnnl::op_timing::NotifierLease notifiers;
+};
+
+struct ThreadBuffer {
+  std::mutex mutex;  // only contended while the writer swaps the events out
+  int tid;
+  std::vector<TraceEvent> events;
+  std::vector<cnrtNotifier_t> free_notifiers;
+  uint64_t dropped = 0;
+  // Device spans start at anchor_ns plus the elapsed time from the anchor notifier.
+  cnrtNotifier_t anchor = NULL;
+  uint64_t anchor_ns    = 0;
+  bool anchor_tried     = false;  // only read and written by the owner thread
+};
+
+// Gives back the pair of a device event, to op_timing when it was lent. buffer->mutex is held.
+static void recycleNotifiers(ThreadBuffer *buffer, const TraceEvent &event) {
+  if (event.notifiers.lent != NULL) {
+    cnnl::op_timing::releaseNotifiers(event.notifiers);
+  } else {
+    buffer->free_notifiers.push_back(event.notifiers.start);
+    buffer->free_notifiers.push_back(event.notifiers.end);
+  }
+}
+
+struct PendingEvent {
+  ThreadBuffer *owner;
+  TraceEvent event;
+};
+
+static void closeTrace();
+
+class TraceWriter {
+ public:
+  static TraceWriter *instance() {
+    // intentionally leaked, the writer thread may outlive statics.
+    static TraceWriter *writer = new TraceWriter();
+    return writer;
+  }
+
+  bool enabled() const { return file_ != NULL; }
+
+  ThreadBuffer *threadBuffer() {
+    static thread_local ThreadBuffer *buffer = NULL;
+    if (CNNL_PREDICT_FALSE(buffer == NULL)) {
+      buffer = new ThreadBuffer();
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffer->tid = buffers_.size();
+      buffers_.push_back(buffer);
+      if (!thread_.joinable()) {
+        thread_ = std::thread(&TraceWriter::loop, this);
+        // The first buffer comes with the first traced call, after the runtime is up, so the
+        // hook runs before the runtime is torn down and can still wait for notifiers.
+        atexit(closeTrace);
+      }
+    }
+    return buffer;
+  }
+
+  // Writes everything buffered so far. Pending device events are written once their end
+  // notifier is reached, or immediately when wait_device is true.
+  void flush(bool wait_device) {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+    if (file_ == NULL) {
+      return;
+    }
+    std::vector<ThreadBuffer *> buffers;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffers = buffers_;
+    }
+    std::vector<TraceEvent> events;
+    for (auto buffer : buffers) {
+      uint64_t dropped = 0;
+      {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        events.swap(buffer->events);
+        dropped = buffer->dropped;
+        buffer->dropped = 0;
+      }
+      if (dropped > 0) {
+        LOG_FIRST_N(WARNING, 1) << "[trace] events dropped, the trace file is written too slowly.";
+      }
+      if (buffer->tid >= (int)described_.size()) {
+        described_.resize(buffer->tid + 1, false);
+      }
+      if (!described_[buffer->tid]) {
+        writeThreadName(buffer->tid);
+        described_[buffer->tid] = true;
+      }
+      for (auto &event : events) {
+        if (event.notifiers.start != NULL) {
+          pending_.push_back({buffer, event});
+        } else {
+          writeEvent(event, buffer->tid);
+        }
+      }
+      events.clear();
+    }
+    while (!pending_.empty()) {
+      PendingEvent &pending = pending_.front();
+      TraceEvent &event     = pending.event;
+      if (wait_device) {
+        cnrtWaitNotifier(event.notifiers.end);
+      } else if (cnrtQueryNotifier(event.notifiers.end) != CNRT_RET_SUCCESS) {
+        break;
+      }
+      float duration_us = 0;
+      cnrtNotifierDuration(event.notifiers.start, event.notifiers.end, &duration_us);
+      event.dur_ns = (uint64_t)(duration_us * 1000);
+      float since_anchor_us = 0;
+      if (pending.owner->anchor != NULL &&
+          cnrtNotifierDuration(pending.owner->anchor, event.notifiers.start, &since_anchor_us) ==
+              CNRT_RET_SUCCESS) {
+        event.ts_ns = pending.owner->anchor_ns + (uint64_t)(since_anchor_us * 1000);
+      }
+      writeEvent(event, pending.owner->tid + TRACE_DEVICE_TID_OFFSET);
+      {
+        std::lock_guard<std::mutex> lock(pending.owner->mutex);
+        recycleNotifiers(pending.owner, event);
+      }
+      pending_.pop_front();
+    }
+    fflush(file_);
+  }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    if (enabled()) {
+      flush(true);
+      destroyNotifiers();
+      // the last event has no trailing comma
+      fprintf(file_,
+              "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+              "\"args\":{\"name\":\"cnnl\"}}\n]\n",
+              pid_);
+      fclose(file_);
+      file_ = NULL;
+    }
+  }
+
+ private:
+  TraceWriter() {
+    const char *file_name = getenv("CNNL_TRACE_FILE");
+    if (file_name == NULL || strlen(file_name) == 0) {
+      return;
+    }
+    file_ = fopen(file_name, "w");
+    if (file_ == NULL) {
+      LOG(ERROR) << "[trace] open " << file_name << " failed, trace is disabled.";
+      return;
+    }
+    // 1MB stdio buffer, the writer thread is the only user of the file.
+    setvbuf(file_, NULL, _IOFBF, 1 << 20);
+    pid_ = getpid();
+    fprintf(file_, "[\n");
+  }
+
+  void loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+      cv_.wait_for(lock, std::chrono::milliseconds(TRACE_FLUSH_INTERVAL_MS));
+      if (stop_) {
+        break;
+      }
+      lock.unlock();
+      flush(false);
+      lock.lock();
+    }
+  }
+
+  // Destroys the pairs kept for reuse and the anchors, once every device event is written.
+  void destroyNotifiers() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto buffer : buffers_) {
+      std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+      for (auto &notifier : buffer->free_notifiers) {
+        cnrtDestroyNotifier(&notifier);
+      }
+      buffer->free_notifiers.clear();
+      if (buffer->anchor != NULL) {
+        cnrtDestroyNotifier(&buffer->anchor);
+        buffer->anchor = NULL;
+      }
+    }
+  }
+
+  void writeThreadName(int tid) {
+    fprintf(file_,
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+            "\"args\":{\"name\":\"host thread %d\"}},\n",
+            pid_, tid, tid);
+    fprintf(file_,
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+            "\"args\":{\"name\":\"MLU of host thread %d\"}},\n",
+            pid_, tid + TRACE_DEVICE_TID_OFFSET, tid);
+  }
+
+  void writeEvent(const TraceEvent &event, int tid) {
+    fprintf(file_,
+            "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+            "\"ts\":%.3f,\"dur\":%.3f},\n",
+            event.name, event.cat, pid_, tid, event.ts_ns / 1000.0, event.dur_ns / 1000.0);
+  }
+
+  FILE *file_ = NULL;
+  int pid_    = 0;
+  std::mutex mutex_;
+  std::mutex flush_mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+  bool stop_ = false;
+  std::vector<ThreadBuffer *> buffers_;  // buffers of exited threads are kept and still flushed
+  std::deque<PendingEvent> pending_;
+  std::vector<bool> described_;  // thread_name metadata written
+};
+
+static void pushEvent(const TraceEvent &event) {
+  ThreadBuffer *buffer = TraceWriter::instance()->threadBuffer();
+  std::lock_guard<std::mutex> lock(buffer->mutex);
+  if (buffer->events.size() >= TRACE_MAX_BUFFERED_EVENTS) {
+    buffer->dropped++;
+    if (event.notifiers.start != NULL) {
+      recycleNotifiers(buffer, event);
+    }
+    return;
+  }
+  buffer->events.push_back(event);
+}
+
+bool isTraceOn() {
+  static bool trace_on = TraceWriter::instance()->enabled();
+  return trace_on;
+}
+
+void flushTrace() {
+  if (isTraceOn()) {
+    TraceWriter::instance()->flush(true);
+  }
+}
+
+ApiTracer::ApiTracer(const char *api_name) : api_name_(api_name), active_(isTraceOn()) {
+  if (CNNL_PREDICT_FALSE(active_)) {
+    start_ns_ = cnnl::op_timing::nowNanos();
+  }
+}
+
+void ApiTracer::switchPhase(const char *phase_name) {
+  uint64_t now = cnnl::op_timing::nowNanos();
+  if (phase_name_ != NULL) {
+    pushEvent({phase_name_, "phase", phase_start_ns_, now - phase_start_ns_});
+  }
+  phase_name_     = phase_name;
+  phase_start_ns_ = now;
+}
+
+// Places the anchor of the device spans of the thread on its first traced launch. Waiting
+// for it drains queue once, so its host time is the time the device reaches it.
+static void placeAnchor(ThreadBuffer *buffer, cnrtQueue_t queue) {
+  buffer->anchor_tried = true;
+  cnrtNotifier_t anchor = NULL;
+  if (cnrtCreateNotifier(&anchor) != CNRT_RET_SUCCESS) {
+    LOG_FIRST_N(WARNING, 1) << "[trace] create notifier failed, device spans start at launch.";
+    return;
+  }
+  if (cnrtPlaceNotifier(anchor, queue) != CNRT_RET_SUCCESS ||
+      cnrtWaitNotifier(anchor) != CNRT_RET_SUCCESS) {
+    cnrtDestroyNotifier(&anchor);
+    return;
+  }
+  uint64_t anchor_ns = cnnl::op_timing::nowNanos();
+  std::lock_guard<std::mutex> lock(buffer->mutex);
+  buffer->anchor    = anchor;
+  buffer->anchor_ns = anchor_ns;
+}
+
+void ApiTracer::placeStart(cnrtQueue_t queue, cnnl::op_timing::OpTimer *op_timer) {
+  ThreadBuffer *buffer = TraceWriter::instance()->threadBuffer();
+  if (!buffer->anchor_tried) {
+    placeAnchor(buffer, queue);
+  }
+  launch_ns_ = cnnl::op_timing::nowNanos();
+  // op_timer placed its pair just before, its end is placed after placeEnd
+  if (op_timer->lendNotifiers(&notifiers_)) {
+    op_timer_ = op_timer;
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    if (buffer->free_notifiers.size() >= 2) {
+      notifiers_.end = buffer->free_notifiers.back();
+      buffer->free_notifiers.pop_back();
+      notifiers_.start = buffer->free_notifiers.back();
+      buffer->free_notifiers.pop_back();
+    }
+  }
+  if (notifiers_.start == NULL) {
+    if (cnrtCreateNotifier(&notifiers_.start) != CNRT_RET_SUCCESS) {
+      notifiers_.start = NULL;
+      return;
+    }
+    if (cnrtCreateNotifier(&notifiers_.end) != CNRT_RET_SUCCESS) {
+      cnrtDestroyNotifier(&notifiers_.start);
+      notifiers_.start = NULL;
+      notifiers_.end   = NULL;
+      return;
+    }
+  }
+  cnrtPlaceNotifier(notifiers_.start, queue);
+}
+
+void ApiTracer::placeEnd(cnrtQueue_t queue, const char *kernel_name) {
+  kernel_name_ = kernel_name == NULL ? api_name_ : kernel_name;
+  if (notifiers_.start == NULL || op_timer_ != NULL) {
+    return;
+  }
+  cnrtPlaceNotifier(notifiers_.end, queue);
+  pushEvent({kernel_name_, "kernel", launch_ns_, 0, notifiers_});
+  notifiers_ = cnnl::op_timing::NotifierLease();
+}
+
+void ApiTracer::finish() {
+  uint64_t now = cnnl::op_timing::nowNanos();
+  if (op_timer_ != NULL) {
+    // a lent pair without its end, e.g. after an early return, is given back unused
+    if (op_timer_->ended() && kernel_name_ != NULL) {
+      pushEvent({kernel_name_, "kernel", launch_ns_, 0, notifiers_});
+    } else {
+      cnnl::op_timing::releaseNotifiers(notifiers_);
+    }
+  } else if (notifiers_.start != NULL) {
+    // the launch returned before placeEnd, the start may be placed, the end never is
+    cnrtDestroyNotifier(&notifiers_.start);
+    cnrtDestroyNotifier(&notifiers_.end);
+  }
+  if (phase_name_ != NULL) {
+    pushEvent({phase_name_, "phase", phase_start_ns_, now - phase_start_ns_});
+  }
+  pushEvent({api_name_, "api", start_ns_, now - start_ns_});
+}
+
+// Close the json array at exit. An atexit hook rather than a static destructor, which could
+// run after the runtime owning the notifiers is unloaded.
+static void closeTrace() {
+  TraceWriter::instance()->stop();
+}
+
+}  // namespace trace
+}  // namespace cnnl
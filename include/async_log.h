@@ -0,0 +1,68 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef INCLUDE_ASYNC_LOG_H_
+#define INCLUDE_ASYNC_LOG_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <sstream>
+#include <string>
+
+/* Asynchronous backend of LOG and VLOG.
+ *
+ * Environment variables:
+ * - CNNL_LOG_ASYNC=ON: format the message in the calling thread only, then push it into
+ *   a lock-free queue written by a background thread. FATAL messages stay synchronous.
+ * - CNNL_LOG_ASYNC_FILE=path: write to the file only. Without it the messages go where cnlog
+ *   puts them: stderr unless CNNL_LOG_PRINT=OFF, and cnnl_auto_log with CNNL_LOG_ONLY_SHOW=OFF.
+ * - CNNL_LOG_ASYNC_MAX_SIZE=n: rotate the file after n MB, 64 by default. path.1 is the
+ *   newest rotated file, at most CNNL_LOG_ASYNC_MAX_FILES (5 by default) are kept.
+ *
+ * Messages below the level of cnlog (CNNL_MIN_LOG_LEVEL or cnlog::setLevel) are dropped
+ * by LOG before they are formatted. Messages are also dropped and counted when more than
+ * 64K of them wait in the queue.
+ */
+
+namespace cnnl {
+namespace async_log {
+
+bool isAsyncLogOn();
+// Blocks until every message pushed before the call is written.
+void flushAsyncLog();
+uint64_t getAsyncLogDropped();
+
+class AsyncLogMessage {
+ public:
+  AsyncLogMessage(const char *fname, int line, int severity)
+      : fname_(fname), line_(line), severity_(severity) {}
+  ~AsyncLogMessage();
+  std::ostream &stream() { return stream_; }
+
+ private:
+  const char *fname_;
+  int line_;
+  int severity_;
+  std::ostringstream stream_;
+};
+
+}  // namespace async_log
+
+namespace internal {
+
+// Max of CNNL_MIN_VLOG_LEVEL and the levels in CNNL_CPP_VMODULE, computed once at load
+// time. VLOG above it is skipped with a single compare; INT32_MAX until computed.
+extern std::atomic<int> vlog_max_level;
+
+}  // namespace internal
+}  // namespace cnnl
+
+#endif  // INCLUDE_ASYNC_LOG_H_
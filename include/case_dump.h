@@ -0,0 +1,199 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef INCLUDE_CASE_DUMP_H_
+#define INCLUDE_CASE_DUMP_H_
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "include/cnnl_core.h"
+#include "include/tensor.h"
+
+/* Binary gen_case format, used by the GEN_CASE_* macros when CNNL_GEN_CASE is on.
+ *
+ * Environment variables:
+ * - CNNL_GEN_CASE_BINARY=ON: write gen_case/<op_name>/<op_name>_<time>_<tid>_<seq>.cnnlcase
+ *   instead of the prototxt. The caller only copies the inputs to host, the file is
+ *   written by a background thread.
+ * - CNNL_GEN_CASE_BINARY_QUEUE_MB=n: bound of the payloads waiting for the writer, 256
+ *   by default. A case that does not fit is skipped, the caller never waits.
+ * - CNNL_GEN_CASE_BINARY_BUDGET_MB=n: stop dumping after n MB written, unlimited by default.
+ * - CNNL_GEN_CASE_SAMPLE=n: dump one of every n calls of each operation.
+ * CNNL_GEN_CASE_OP_NAME filters the operations as for the prototxt.
+ *
+ * File layout, little-endian:
+ *   CaseFileHeader
+ *   meta section of meta_size bytes: op_name, op_type, test param, tensors, op params
+ *   payloads of the input tensors, each at a CASE_DUMP_ALIGN aligned file offset,
+ *   so a mapped file can be used in place.
+ * Strings are a uint32_t length followed by the characters.
+ */
+#define CASE_DUMP_MAGIC "CNNLCASE"
+#define CASE_DUMP_VERSION 1
+#define CASE_DUMP_ALIGN 64
+#define CASE_DUMP_SUFFIX ".cnnlcase"
+
+namespace cnnl {
+namespace case_dump {
+
+struct CaseFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t tensor_num;
+  uint32_t param_num;
+  uint32_t meta_size;
+  uint64_t payload_offset;
+  uint64_t file_size;
+};
+
+typedef enum {
+  CASE_PARAM_FLOAT       = 0,
+  CASE_PARAM_STRING      = 1,
+  CASE_PARAM_INT_ARRAY   = 2,
+  CASE_PARAM_FLOAT_ARRAY = 3,
+} CaseParamKind;
+
+struct CaseTensor {
+  std::string id;
+  bool is_input = true;
+  cnnlDataType_t dtype      = CNNL_DTYPE_FLOAT;
+  cnnlTensorLayout_t layout = CNNL_LAYOUT_ARRAY;
+  std::vector<int> dims;
+  float upper_bound       = 0;
+  float lower_bound       = 0;
+  uint64_t payload_offset = 0;  // 0 when the data is not dumped
+  uint64_t payload_size   = 0;
+  const void *data        = NULL;  // payload in the mapped file, set by CaseReader
+};
+
+struct CaseParam {
+  std::string op_name;  // name of the <op_name>_param block
+  std::string param_name;
+  CaseParamKind kind = CASE_PARAM_FLOAT;
+  std::string str_value;
+  std::vector<float> float_values;  // a single value for CASE_PARAM_FLOAT
+  std::vector<int> int_values;
+};
+
+struct CaseTestParam {
+  bool is_diff[3]    = {false, false, false};
+  float threshold[3] = {0, 0, 0};
+};
+
+struct CaseInfo {
+  std::string op_name;
+  std::string op_type;
+  CaseTestParam test_param;
+  std::vector<CaseTensor> tensors;
+  std::vector<CaseParam> params;
+};
+
+bool isCaseDumpOn();
+// Blocks until the queued cases are written.
+void flushCaseDump();
+// Cases skipped because the queue was full or the byte budget was spent.
+uint64_t getCaseDumpSkipped();
+
+// Collects one call between GEN_CASE_START and the end of its scope, then hands it to
+// the writer. isText() tells the macros to use the prototxt path instead.
+class CaseBuilder {
+ public:
+  CaseBuilder(const std::string &op_name, const std::string &op_type);
+  ~CaseBuilder();
+  bool isText() const { return mode_ == MODE_TEXT; }
+
+  void addData(bool is_input,
+               const std::string &id,
+               const void *device_data,
+               const cnnlTensorDescriptor_t desc,
+               const float upper_bound,
+               const float lower_bound);
+  void addData(bool is_input,
+               const std::string &id,
+               const void *device_data,
+               const int dim,
+               const std::vector<int> &dims,
+               cnnlDataType_t dtype,
+               cnnlTensorLayout_t layout,
+               const float upper_bound,
+               const float lower_bound);
+  void addData(bool is_input,
+               const std::string &id,
+               const void *device_data,
+               const int dim,
+               const int *dims,
+               cnnlDataType_t dtype,
+               cnnlTensorLayout_t layout,
+               const float upper_bound,
+               const float lower_bound) {
+    addData(is_input, id, device_data, dim, std::vector<int>(dims, dims + dim), dtype, layout,
+            upper_bound, lower_bound);
+  }
+  void addParam(const int flag,
+                const std::string &op_name,
+                const std::string &param_name,
+                const float value);
+  void addParam(const int flag,
+                const std::string &op_name,
+                const std::string &param_name,
+                const std::string &value);
+  void addParam(const int flag,
+                const std::string &op_name,
+                const std::string &param_name,
+                const int *value,
+                const int num);
+  void addParam(const int flag,
+                const std::string &op_name,
+                const std::string &param_name,
+                const float *value,
+                const int num);
+  void setTestParam(bool is_diff1,
+                    bool is_diff2,
+                    bool is_diff3,
+                    const float diff1_threshold,
+                    const float diff2_threshold,
+                    const float diff3_threshold);
+
+ private:
+  enum { MODE_TEXT, MODE_BINARY, MODE_SKIP } mode_;
+  CaseInfo info_;
+  std::vector<std::vector<char>> payloads_;  // host copies, in the order of info_.tensors
+  uint64_t reserved_bytes_ = 0;             // queue bytes reserved by the payloads
+};
+
+// Maps a .cnnlcase file read-only, tensor data points into the mapping.
+class CaseReader {
+ public:
+  CaseReader() {}
+  ~CaseReader() { close(); }
+  bool open(const std::string &file_name);
+  void close();
+  const CaseInfo &info() const { return info_; }
+
+ private:
+  CaseReader(const CaseReader &) = delete;
+  CaseReader &operator=(const CaseReader &) = delete;
+  CaseInfo info_;
+  void *base_  = NULL;
+  size_t size_ = 0;
+};
+
+bool writeCaseFile(const std::string &file_name,
+                   const CaseInfo &info,
+                   const std::vector<std::vector<char>> &payloads);
+// Writes the case in the prototxt format of the text gen_case.
+void caseToPrototxt(const CaseInfo &info, std::ostream &out);
+
+}  // namespace case_dump
+}  // namespace cnnl
+#endif  // INCLUDE_CASE_DUMP_H_
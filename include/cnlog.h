@@ -184,6 +184,12 @@ void endLog(void);
  */
 void setLevel(int log_level);
 
+/*
+ * @brief: the level set by setLevel, CNNL_MIN_LOG_LEVEL at load time.
+ *         the message level lower than this is dropped.
+ */
+extern int logLevel;
+
 /// get environment variable, return true or false
 /// if default_para is true, the true case: 1, on, yes, true, nullptr;
 /// if default_para is false, the true case: 1, on. yes, true;
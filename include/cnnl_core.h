@@ -136,6 +136,9 @@ typedef enum {
   /*!< Implementation with the fastest algorithm and lower precision.*/
   CNNL_COMPUTATION_HIGH_PRECISION = 1,
   /*!< Implementation with the high-precision algorithm regardless the performance.*/
+  CNNL_COMPUTATION_APPROX = 2,
+  /*!< Implementation with polynomial approximations of a documented max ULP error and
+       larger chunks. Operations without such an implementation use their default one.*/
 } cnnlComputationPreference_t;
 
 /******************************************************************************
@@ -26,25 +26,42 @@
 #include "include/tensor.h"
 #include "include/type.h"
 #include "include/logging.h"
+#include "include/case_dump.h"
 
+// The macros write the binary case of include/case_dump.h when CNNL_GEN_CASE_BINARY is on.
 #define CNNL_GEN_CASE_ON cnnl::gen_case::isGenCaseOn()
-#define GEN_CASE_START(op_name, op_type) \
-  std::string gen_case_file_name = cnnl::gen_case::genCaseStart(op_name, op_type)
-#define GEN_CASE_DATA(is_input, id, data, data_desc, upper_bound, lower_bound)                 \
-  cnnl::gen_case::genCaseData(&gen_case_file_name, is_input, id, data, data_desc, upper_bound, \
-                              lower_bound)
+#define GEN_CASE_START(op_name, op_type)                                \
+  cnnl::case_dump::CaseBuilder gen_case_builder(op_name, op_type);      \
+  std::string gen_case_file_name = gen_case_builder.isText()            \
+                                       ? cnnl::gen_case::genCaseStart(op_name, op_type) \
+                                       : std::string()
+#define GEN_CASE_DATA(is_input, id, data, data_desc, upper_bound, lower_bound)                   \
+  gen_case_builder.isText()                                                                      \
+      ? cnnl::gen_case::genCaseData(&gen_case_file_name, is_input, id, data, data_desc,          \
+                                    upper_bound, lower_bound)                                    \
+      : gen_case_builder.addData(is_input, id, data, data_desc, upper_bound, lower_bound)
 #define GEN_CASE_DATA_UNFOLD(is_input, id, data, dim, dims, dtype, layout, upper_bound,          \
                              lower_bound)                                                        \
-  cnnl::gen_case::genCaseData(&gen_case_file_name, is_input, id, data, dim, dims, dtype, layout, \
-                              upper_bound, lower_bound)
-#define GEN_CASE_OP_PARAM_SINGLE(flag, op_name, param_name, value) \
-  cnnl::gen_case::genCaseOpParam(flag, &gen_case_file_name, op_name, param_name, value)
-#define GEN_CASE_OP_PARAM_ARRAY(flag, op_name, param_name, value, num) \
-  cnnl::gen_case::genCaseOpParam(flag, &gen_case_file_name, op_name, param_name, value, num)
-#define GEN_CASE_TEST_PARAM(is_diff1, is_diff2, is_diff3, diff1_threshold, diff2_threshold, \
-                            diff3_threshold)                                                \
-  cnnl::gen_case::genCaseTestParam(&gen_case_file_name, is_diff1, is_diff2, is_diff3,       \
-                                   diff1_threshold, diff2_threshold, diff3_threshold)
+  gen_case_builder.isText()                                                                      \
+      ? cnnl::gen_case::genCaseData(&gen_case_file_name, is_input, id, data, dim, dims, dtype,   \
+                                    layout, upper_bound, lower_bound)                            \
+      : gen_case_builder.addData(is_input, id, data, dim, dims, dtype, layout, upper_bound,      \
+                                 lower_bound)
+#define GEN_CASE_OP_PARAM_SINGLE(flag, op_name, param_name, value)                              \
+  gen_case_builder.isText()                                                                     \
+      ? cnnl::gen_case::genCaseOpParam(flag, &gen_case_file_name, op_name, param_name, value)   \
+      : gen_case_builder.addParam(flag, op_name, param_name, value)
+#define GEN_CASE_OP_PARAM_ARRAY(flag, op_name, param_name, value, num)                              \
+  gen_case_builder.isText()                                                                         \
+      ? cnnl::gen_case::genCaseOpParam(flag, &gen_case_file_name, op_name, param_name, value, num) \
+      : gen_case_builder.addParam(flag, op_name, param_name, value, num)
+#define GEN_CASE_TEST_PARAM(is_diff1, is_diff2, is_diff3, diff1_threshold, diff2_threshold,   \
+                            diff3_threshold)                                                  \
+  gen_case_builder.isText()                                                                   \
+      ? cnnl::gen_case::genCaseTestParam(&gen_case_file_name, is_diff1, is_diff2, is_diff3,   \
+                                         diff1_threshold, diff2_threshold, diff3_threshold)   \
+      : gen_case_builder.setTestParam(is_diff1, is_diff2, is_diff3, diff1_threshold,          \
+                                      diff2_threshold, diff3_threshold)
 
 namespace cnnl {
 namespace gen_case {
@@ -18,9 +18,24 @@
 #include <sstream>
 #include "include/macros.h"
 #include "include/cnlog.h"
+#include "include/async_log.h"
 #include "include/cnnl_core.h"
 
-#define LOG(severity) cnlog::CLOG(CNNL, severity)
+// Goes to the asynchronous backend when CNNL_LOG_ASYNC is set, see include/async_log.h.
+#define LOG_STREAM(severity)                                                              \
+  (LOG_##severity != LOG_FATAL && ::cnnl::async_log::isAsyncLogOn()                       \
+       ? ::cnnl::async_log::AsyncLogMessage(__FILE__, __LINE__, LOG_##severity).stream() \
+       : cnlog::CLOG(CNNL, severity))
+
+// A message below the level of cnlog is dropped by the asynchronous backend before its
+// operands are evaluated or formatted.
+#define LOG_IS_DROPPED(severity)                                         \
+  (LOG_##severity != LOG_FATAL && ::cnnl::async_log::isAsyncLogOn() && \
+   LOG_##severity < cnlog::logLevel)
+
+#define LOG(severity)                          \
+  CNNL_PREDICT_FALSE(LOG_IS_DROPPED(severity)) \
+  ? (void)0 : ::cnnl::internal::Voidifier() & LOG_STREAM(severity)
 
 #define TOKENPASTE(x, y, z) x##y##z
 #define TOKENPASTE2(x, y, z) TOKENPASTE(x, y, z)
@@ -28,7 +43,7 @@
 #define LOG_FIRST_N(severity, n)                                           \
   static std::atomic<int> TOKENPASTE2(LOG_, __LINE__, _OCCURRENCES)(0);    \
   if (CNNL_PREDICT_FALSE(TOKENPASTE2(LOG_, __LINE__, _OCCURRENCES)++ < n)) \
-  cnlog::CLOG(CNNL, severity)
+  LOG(severity)
 
 // CHECK with a error if condition is not true.
 #define CHECK(condition, ...)                                    \
@@ -155,7 +170,7 @@ class LogMessage : public std::basic_ostringstream<char> {
 };
 
 // Uses the lower operator & precedence to voidify a LogMessage reference, so
-// that the ternary VLOG() implementation is balanced, type wise.
+// that the ternary LOG() and VLOG() implementations are balanced, type wise.
 struct Voidifier {
   template <typename T>
   void operator&(const T &)const {}
@@ -171,17 +186,18 @@ class LogMessageFatal : public LogMessage {
 
 // Otherwise, set CNNL_MIN_VLOG_LEVEL environment to update minimum log level
 // of VLOG, or CNNL_CPP_VMODULE to set the minimum log level for individual
-// translation units.
-#define VLOG_IS_ON(lvl)                                               \
-  (([](int level, const char *fname) {                                \
-    static const bool vmodule_activated =                             \
-        ::cnnl::internal::LogMessage::VmoduleActivated(fname, level); \
-    return vmodule_activated;                                         \
-  })(lvl, __FILE__))
-
-#define VLOG(level)                     \
-  CNNL_PREDICT_TRUE(!VLOG_IS_ON(level)) \
-  ? (void)0 : ::cnnl::internal::Voidifier() & LOG(VLOG)
+// translation units. Levels above every configured level are rejected by one compare.
+#define VLOG_IS_ON(lvl)                                                           \
+  ((lvl) <= ::cnnl::internal::vlog_max_level.load(std::memory_order_relaxed) &&  \
+   ([](int level, const char *fname) {                                            \
+     static const bool vmodule_activated =                                        \
+         ::cnnl::internal::LogMessage::VmoduleActivated(fname, level);            \
+     return vmodule_activated;                                                    \
+   })(lvl, __FILE__))
+
+#define VLOG(level)                                                       \
+  CNNL_PREDICT_TRUE(!VLOG_IS_ON(level)) || LOG_IS_DROPPED(VLOG)           \
+  ? (void)0 : ::cnnl::internal::Voidifier() & LOG_STREAM(VLOG)
 
 // This formats a value for a failing CHECK_XX statement.  Ordinarily,
 // it uses the definition for operator<<, with a few special cases below.
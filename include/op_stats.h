@@ -0,0 +1,136 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef INCLUDE_OP_STATS_H_
+#define INCLUDE_OP_STATS_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <initializer_list>
+#include "include/cnnl_core.h"
+#include "include/op_timing.h"
+#include "cnnl_example.h"
+
+/* Per-handle operation counters behind cnnlGetHandleStatistics, always on.
+ *
+ * Every thread owns its counters and updates them with relaxed load + store, no
+ * read-modify-write, so calls never contend. cnnlGetHandleStatistics merges the counters
+ * of all threads, including the exited ones. The cnnl context is owned by
+ * libcnnl_core.so, so the counters live in a side table keyed by the handle address,
+ * dropped by cnnlReleaseHandleStatistics before the handle is destroyed.
+ */
+#define OP_STATS_START(handle, op_name)                                     \
+  static const int op_stats_id = cnnl::op_stats::registerOp(op_name);       \
+  cnnl::op_stats::OpStatsRecorder op_stats_recorder(handle, op_stats_id)
+#define OP_STATS_PARAM_CHECK_FAILED() op_stats_recorder.paramCheckFailed()
+#define OP_STATS_ZERO_ELEMENT() op_stats_recorder.zeroElement()
+// The status of a failed KernelRegistry::select, BAD_PARAM or ARCH_MISMATCH.
+#define OP_STATS_SELECT_FAILED(status) op_stats_recorder.selectFailed(status)
+// The descriptors of every operand read or written by the kernel.
+#define OP_STATS_LAUNCH(kernel_name, element_num, ...) \
+  op_stats_recorder.launch(kernel_name, element_num, {__VA_ARGS__})
+
+namespace cnnl {
+namespace op_stats {
+
+// Written by the owner thread only, read by any thread.
+struct Counter {
+  std::atomic<uint64_t> value{0};
+  inline void add(uint64_t n) {
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+};
+
+struct KernelCounter {
+  std::atomic<const char *> kernel_name{NULL};  // set once by the owner thread
+  Counter launches;
+};
+
+struct OpCounters {
+  Counter calls;
+  Counter param_check_failures;
+  Counter zero_element_calls;
+  Counter arch_mismatches;
+  Counter launches;
+  Counter elements;
+  Counter bytes;
+  KernelCounter kernels[CNNL_STATS_MAX_KERNELS];
+};
+
+// Returns the id of the operation, -1 once CNNL_STATS_MAX_OPS operations are registered.
+int registerOp(const char *op_name);
+// Counters of the calling thread for handle, NULL if op_id is -1.
+OpCounters *threadOpCounters(cnnlHandle_t handle, int op_id);
+
+class OpStatsRecorder {
+ public:
+  OpStatsRecorder(cnnlHandle_t handle, int op_id)
+      : counters_(handle == NULL ? NULL : threadOpCounters(handle, op_id)) {
+    if (counters_ != NULL) {
+      counters_->calls.add(1);
+    }
+  }
+  inline void paramCheckFailed() {
+    if (counters_ != NULL) {
+      counters_->param_check_failures.add(1);
+    }
+  }
+  inline void zeroElement() {
+    if (counters_ != NULL) {
+      counters_->zero_element_calls.add(1);
+    }
+  }
+  inline void selectFailed(cnnlStatus_t status) {
+    if (counters_ == NULL) {
+      return;
+    }
+    if (status == CNNL_STATUS_ARCH_MISMATCH) {
+      counters_->arch_mismatches.add(1);
+    } else {
+      counters_->param_check_failures.add(1);
+    }
+  }
+  inline void launch(const char *kernel_name,
+                     size_t element_num,
+                     std::initializer_list<cnnlTensorDescriptor_t> descs) {
+    if (counters_ == NULL) {
+      return;
+    }
+    uint64_t bytes = 0;
+    for (auto desc : descs) {
+      bytes += cnnl::op_timing::operandBytes(desc);
+    }
+    counters_->launches.add(1);
+    counters_->elements.add(element_num);
+    counters_->bytes.add(bytes);
+    // kernel names are literals, compared by address
+    for (int i = 0; i < CNNL_STATS_MAX_KERNELS; ++i) {
+      KernelCounter &kernel = counters_->kernels[i];
+      const char *name      = kernel.kernel_name.load(std::memory_order_relaxed);
+      if (name == NULL) {
+        kernel.kernel_name.store(kernel_name, std::memory_order_release);
+        name = kernel_name;
+      }
+      if (name == kernel_name) {
+        kernel.launches.add(1);
+        break;
+      }
+    }
+  }
+
+ private:
+  OpCounters *counters_;
+};
+
+}  // namespace op_stats
+}  // namespace cnnl
+
+#endif  // INCLUDE_OP_STATS_H_
@@ -0,0 +1,195 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef INCLUDE_OP_TIMING_H_
+#define INCLUDE_OP_TIMING_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include "include/cnnl_core.h"
+#include "include/macros.h"
+#include "include/runtime/device.h"
+#include "include/type.h"
+
+/* Always-on timing collector for cnnl operations.
+ *
+ * Environment variables:
+ * - CNNL_OP_TIMING=ON: record the host time of every operation call.
+ * - CNNL_OP_TIMING_HW=ON: also place notifiers around the kernel launch and record
+ *   the hardware time. Notifiers are resolved by the background aggregator, the
+ *   caller never waits on them.
+ * - CNNL_OP_BANDWIDTH=ON: implies CNNL_OP_TIMING_HW, divides the bytes moved by each
+ *   launch by its hardware time and logs the achieved bandwidth against the device peak
+ *   for every call, and for every kernel variant at exit.
+ * - CNNL_OP_TIMING_FILE=path: dump the statistics at exit, in CSV if the path ends
+ *   with ".csv", in JSON otherwise.
+ *
+ * Records are pushed into a lock-free per-thread ring buffer and aggregated into
+ * log-linear histograms keyed by (operation, kernel, size bucket). A record is dropped
+ * rather than blocking the caller when its ring buffer is full.
+ */
+#define OP_TIMING_START(op_name) cnnl::op_timing::OpTimer op_timer(op_name)
+#define OP_TIMING_KERNEL_START(queue) op_timer.kernelStart(queue)
+#define OP_TIMING_KERNEL_END(queue, kernel_name, element_num) \
+  op_timer.kernelEnd(queue, kernel_name, element_num)
+// The descriptors of every operand read or written by the kernel.
+#define OP_TIMING_TRAFFIC(handle, k_dim, ...) op_timer.setTraffic(handle, k_dim, {__VA_ARGS__})
+
+namespace cnnl {
+namespace op_timing {
+
+// Log-linear histogram with 16 sub-buckets per power of two, about 6% relative error.
+class LatencyHistogram {
+ public:
+  static const int kSubBucketBits  = 4;
+  static const int kSubBucketCount = 1 << kSubBucketBits;
+  static const int kMaxMsb         = 40;  // about 18 minutes in nanoseconds
+  static const int kBucketNum = 2 * kSubBucketCount + (kMaxMsb - kSubBucketBits) * kSubBucketCount;
+
+  LatencyHistogram() { reset(); }
+  void reset();
+  void record(uint64_t value);
+  void merge(const LatencyHistogram &other);
+  // Returns the value at quantile q in [0, 1].
+  uint64_t percentile(double q) const;
+  uint64_t count() const { return count_; }
+  uint64_t min() const { return count_ == 0 ? 0 : min_; }
+  uint64_t max() const { return max_; }
+  double mean() const { return count_ == 0 ? 0 : (double)sum_ / count_; }
+
+  static int bucketIndex(uint64_t value);
+  static uint64_t bucketValue(int index);
+
+ private:
+  uint64_t counts_[kBucketNum];
+  uint64_t count_;
+  uint64_t sum_;
+  uint64_t min_;
+  uint64_t max_;
+};
+
+struct LatencySummary {
+  uint64_t count = 0;
+  double mean    = 0;
+  uint64_t min   = 0;
+  uint64_t p50   = 0;
+  uint64_t p99   = 0;
+  uint64_t p999  = 0;
+  uint64_t max   = 0;
+};
+
+struct OpTimingStats {
+  std::string op_name;
+  std::string kernel_name;
+  int size_bucket = 0;    // floor(log2(element_num))
+  LatencySummary host;    // nanoseconds from api entry to kernel launched
+  LatencySummary device;  // nanoseconds between the notifiers, empty without CNNL_OP_TIMING_HW
+  // Bandwidth of the calls having hardware time, zero without OP_TIMING_TRAFFIC.
+  uint64_t bytes        = 0;  // sum over the calls
+  double bandwidth      = 0;  // GB/s, bytes / device time over the calls
+  double peak_bandwidth = 0;  // GB/s
+  double efficiency     = 0;  // percent of the peak
+  double min_efficiency = 0;  // percent of the peak of the slowest call
+  int used_cores        = 0;  // tasks of the last launch
+  int total_cores       = 0;  // cores the handle may use
+};
+
+bool isOpTimingOn();
+bool isOpTimingHwOn();
+bool isOpBandwidthOn();
+void setOpTimingMode(bool host_on, bool hw_on, bool bandwidth_on = false);
+
+// Drains the per-thread buffers and returns the statistics of every key.
+void getOpTimingStats(std::vector<OpTimingStats> *stats);
+// Number of records dropped because a per-thread buffer was full.
+uint64_t getOpTimingDropped();
+void resetOpTiming();
+bool dumpOpTimingJson(const std::string &file_name);
+bool dumpOpTimingCsv(const std::string &file_name);
+// CSV if file_name ends with ".csv", JSON otherwise.
+bool dumpOpTiming(const std::string &file_name);
+
+int sizeBucket(size_t element_num);
+uint64_t nowNanos();
+
+/* Notifier pair of a launch lent to the trace, so that a launch traced and timed at once
+ * places a single pair, see OpTimer::lendNotifiers. The slot owning the pair is not reused
+ * before releaseNotifiers.
+ */
+struct NotifierLease {
+  cnrtNotifier_t start    = NULL;
+  cnrtNotifier_t end      = NULL;
+  std::atomic<bool> *lent = NULL;  // flag of the slot, NULL when nothing is lent
+};
+void releaseNotifiers(const NotifierLease &lease);
+
+inline size_t operandBytes(const cnnlTensorDescriptor_t desc) {
+  return cnnlGetTensorElementNum(desc) * getSizeOfDataType(desc->dtype);
+}
+
+class OpTimer {
+ public:
+  explicit OpTimer(const char *op_name) : op_name_(op_name), active_(isOpTimingOn()) {
+    if (CNNL_PREDICT_FALSE(active_)) {
+      start_ns_ = nowNanos();
+    }
+  }
+  inline void kernelStart(cnrtQueue_t queue) {
+    if (CNNL_PREDICT_FALSE(active_)) {
+      placeStart(queue);
+    }
+  }
+  inline void setTraffic(cnnlHandle_t handle,
+                         const cnrtDim3_t &k_dim,
+                         std::initializer_list<cnnlTensorDescriptor_t> operands) {
+    if (CNNL_PREDICT_FALSE(active_)) {
+      bytes_ = 0;
+      for (auto desc : operands) {
+        bytes_ += operandBytes(desc);
+      }
+      used_cores_     = k_dim.x * k_dim.y * k_dim.z;
+      total_cores_    = cnnl::runtime::getClusterLimitCapability(handle) *
+                     cnnl::runtime::getCoreNumOfEachUnionCapability(handle);
+      peak_bandwidth_ = cnnl::runtime::getPeakBandwidthGBps(handle);
+    }
+  }
+  inline void kernelEnd(cnrtQueue_t queue, const char *kernel_name, size_t element_num) {
+    if (CNNL_PREDICT_FALSE(active_)) {
+      commit(queue, kernel_name, element_num);
+    }
+  }
+  // Lends the pair placed by kernelStart, whose end is placed by kernelEnd. Returns false
+  // without hardware time.
+  bool lendNotifiers(NotifierLease *lease);
+  // kernelEnd was reached, the end notifier of a lent pair is placed.
+  bool ended() const { return ended_; }
+
+ private:
+  void placeStart(cnrtQueue_t queue);
+  void commit(cnrtQueue_t queue, const char *kernel_name, size_t element_num);
+
+  const char *op_name_;
+  bool active_;
+  uint64_t start_ns_ = 0;
+  int slot_          = -1;  // ring buffer slot whose notifiers hold the hardware time
+  bool ended_        = false;
+  size_t bytes_          = 0;
+  int used_cores_        = 0;
+  int total_cores_       = 0;
+  double peak_bandwidth_ = 0;
+};
+
+}  // namespace op_timing
+}  // namespace cnnl
+#endif  // INCLUDE_OP_TIMING_H_
@@ -13,6 +13,7 @@
 #define INCLUDE_RUNTIME_DEVICE_H_
 
 #include <pthread.h>
+#include <stdlib.h>
 #include <string>
 #include "include/cnnl_core.h"
 #include "cn_api.h"
@@ -48,6 +49,35 @@ inline int32_t getClusterLimitCapability(cnnlHandle_t handle) {
 inline int32_t getJobLimitCapability(cnnlHandle_t handle) {
   return handle->capability_job_limit;
 }
+// Peak DRAM bandwidth in GB/s from the product specifications.
+inline double getPeakBandwidthGBps(cnnlHandle_t handle) {
+  switch (handle->arch) {
+    case CNNL_MLU220: return 29.8;    // LPDDR4x
+    case CNNL_MLU270: return 102.0;   // DDR4
+    case CNNL_MLU290: return 1228.0;  // HBM2
+    default: return 0;
+  }
+}
+/* Bound of the buffers of the 3stage pipelines, see kernels/pipeline_schedule.h. Every step
+ * ends in a full sync, so a deeper pipeline never has more than one load in flight and only
+ * shrinks the chunks: the default is 2 on every arch. CNNL_PIPELINE_DEPTH=2|3|4 replaces it
+ * to measure the deeper kernels.
+ */
+inline int32_t getMaxPipelineDepth(cnnlHandle_t handle) {
+  static const char *env_depth = getenv("CNNL_PIPELINE_DEPTH");
+  if (env_depth != NULL && atoi(env_depth) >= 2 && atoi(env_depth) <= 4) {
+    return atoi(env_depth);
+  }
+  return 2;
+}
+// Function type of a union of union_width clusters, see kernels/union_partition.h.
+inline cnrtFunctionType_t getUnionFuncType(int union_width) {
+  switch (union_width) {
+    case 4: return CNRT_FUNC_TYPE_UNION4;
+    case 2: return CNRT_FUNC_TYPE_UNION2;
+    default: return CNRT_FUNC_TYPE_UNION1;
+  }
+}
 }  // namespace runtime
 }  // namespace cnnl
 
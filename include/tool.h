@@ -126,6 +126,17 @@ inline bool isTensorDimsEqual(cnnlTensorDescriptor_t a, cnnlTensorDescriptor_t b
   return false;
 }
 
+inline bool isSupportType(const cnnlDataType_t check_type,
+                          const cnnlDataType_t support_type[],
+                          const int len) {
+  for (int i = 0; i < len; ++i) {
+    if (check_type == support_type[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
 template <typename T>
 inline bool isTwoArraysEqual(T *a, T *b, int num) {
   if (0 == memcmp(a, b, num * sizeof(T))) {
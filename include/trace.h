@@ -0,0 +1,91 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef INCLUDE_TRACE_H_
+#define INCLUDE_TRACE_H_
+
+#include <stdint.h>
+#include "include/cnnl_core.h"
+#include "include/macros.h"
+#include "include/op_timing.h"
+
+/* Chrome trace-event export, open the file with chrome://tracing or ui.perfetto.dev.
+ *
+ * Set CNNL_TRACE_FILE=path to enable. Every api call is recorded as a host span with
+ * nested spans for its phases (param_check, gen_case, policy, launch), and the kernel
+ * is recorded on a device track of the calling thread from a pair of notifiers. The pair
+ * is the one of op_timer when CNNL_OP_TIMING_HW places one, see OP_TIMING_START, so a
+ * launch places a single pair. Notifiers only give elapsed times: the first traced launch
+ * of a thread waits once on an anchor notifier, and the device span starts at the host
+ * time of the anchor plus the elapsed time from the anchor to the start notifier.
+ *
+ * Events are appended to a per-thread buffer and written by a background thread, which
+ * also resolves the notifiers, so the caller never waits on the file or the queue.
+ */
+#define TRACE_API_START(api_name) cnnl::trace::ApiTracer api_tracer(api_name)
+#define TRACE_PHASE(phase_name) api_tracer.phase(phase_name)
+#define TRACE_KERNEL_START(queue) api_tracer.kernelStart(queue, &op_timer)
+#define TRACE_KERNEL_END(queue, kernel_name) api_tracer.kernelEnd(queue, kernel_name)
+
+namespace cnnl {
+namespace trace {
+
+bool isTraceOn();
+// Writes the buffered events and resolves pending notifiers, blocking until done.
+void flushTrace();
+
+class ApiTracer {
+ public:
+  explicit ApiTracer(const char *api_name);
+  ~ApiTracer() {
+    if (CNNL_PREDICT_FALSE(active_)) {
+      finish();
+    }
+  }
+  // Ends the current phase, if any, and starts a new one.
+  inline void phase(const char *phase_name) {
+    if (CNNL_PREDICT_FALSE(active_)) {
+      switchPhase(phase_name);
+    }
+  }
+  inline void kernelStart(cnrtQueue_t queue, cnnl::op_timing::OpTimer *op_timer) {
+    if (CNNL_PREDICT_FALSE(active_)) {
+      placeStart(queue, op_timer);
+    }
+  }
+  inline void kernelEnd(cnrtQueue_t queue, const char *kernel_name) {
+    if (CNNL_PREDICT_FALSE(active_)) {
+      placeEnd(queue, kernel_name);
+    }
+  }
+
+ private:
+  void switchPhase(const char *phase_name);
+  void placeStart(cnrtQueue_t queue, cnnl::op_timing::OpTimer *op_timer);
+  void placeEnd(cnrtQueue_t queue, const char *kernel_name);
+  void finish();
+
+  const char *api_name_;
+  bool active_;
+  uint64_t start_ns_        = 0;
+  const char *phase_name_   = NULL;
+  uint64_t phase_start_ns_  = 0;
+  uint64_t launch_ns_       = 0;
+  const char *kernel_name_  = NULL;
+  // Pair of the launch, either lent by op_timer_ or created by the trace. A pair lent is
+  // pushed by finish(), once op_timer_ has placed its end.
+  cnnl::op_timing::OpTimer *op_timer_ = NULL;
+  cnnl::op_timing::NotifierLease notifiers_;
+};
+
+}  // namespace trace
+}  // namespace cnnl
+#endif  // INCLUDE_TRACE_H_
@@ -14,13 +14,25 @@
 
 #include "kernels/unary_op/unary_op_3pipeline.h"
 #include "kernels/unary_op/unary_op_5pipeline.h"
+#include "kernels/unary_op/unary_op_dual_3pipeline.h"
 
 // declare abs 3stage pipline kernel, only fast mode
 UNARY_OP_KERNEL_3PIPELINE_DECLARE(Abs, float, Fast);
 UNARY_OP_KERNEL_3PIPELINE_DECLARE(Abs, half, Fast);
 
+// declare integer abs 3stage pipeline kernels, computed in float
+UNARY_OP_KERNEL_3PIPELINE_DECLARE(AbsInt, int8_t, Fast);
+UNARY_OP_KERNEL_3PIPELINE_DECLARE(AbsInt, int16_t, Fast);
+UNARY_OP_KERNEL_3PIPELINE_DECLARE(AbsInt, int32_t, Fast);
+
 // declare abs 5stage pipelinekerneol, only fast mode
 UNARY_OP_KERNEL_5PIPELINE_DECLARE(Abs, float, Fast);
 UNARY_OP_KERNEL_5PIPELINE_DECLARE(Abs, half, Fast);
 
+// declare abs and sign 3stage pipeline kernels, the sign in the data type of x or in int8
+UNARY_DUAL_OP_KERNEL_3PIPELINE_DECLARE(AbsSign, float, Same, Fast);
+UNARY_DUAL_OP_KERNEL_3PIPELINE_DECLARE(AbsSign, half, Same, Fast);
+UNARY_DUAL_OP_KERNEL_3PIPELINE_DECLARE(AbsSign, float, Int8, Fast);
+UNARY_DUAL_OP_KERNEL_3PIPELINE_DECLARE(AbsSign, half, Int8, Fast);
+
 #endif  // KERNELS_ABS_ABS_H_
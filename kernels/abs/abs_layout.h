@@ -0,0 +1,51 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_ABS_ABS_LAYOUT_H_
+#define KERNELS_ABS_ABS_LAYOUT_H_
+
+#include "kernels/layout_planner.h"
+
+// 3stage: depth x buffers, x is computed in place.
+constexpr LayoutSpec abs3FastLayout(int elem_size, int depth) {
+  return {1, {{elem_size, depth, false}}, 0, LAYOUT_ALIGN_NUM};
+}
+
+// 5stage: x computed in place, the ping-pong is in SRAM.
+constexpr LayoutSpec abs5FastLayout(int elem_size) {
+  return {1, {{elem_size, 1, false}}, 0, LAYOUT_ALIGN_NUM};
+}
+
+#define ABS_SIGN_CONST_BYTES (LAYOUT_ALIGN_NUM * 4)  // the zero vector
+
+/* 3stage abs and sign: depth x and sign buffers, then an aux buffer. x is computed in place,
+ * the sign is computed in T in its slot and narrowed to int8 from the aux buffer.
+ */
+constexpr LayoutSpec absSign3FastLayout(int elem_size, int depth) {
+  return {3,
+          {{elem_size, depth, false}, {elem_size, depth, false}, {elem_size, 1, false}},
+          ABS_SIGN_CONST_BYTES,
+          LAYOUT_INT_ALIGN_NUM};
+}
+
+/* 3stage integer abs: depth x buffers of float, the integer input is loaded at the end of
+ * the slot and widened in place, then an aux buffer of 2 floats per element, the halves of
+ * an int32.
+ */
+constexpr LayoutSpec absInt3FastLayout(int elem_size, int depth) {
+  return {2,
+          {{(int)sizeof(float), depth, elem_size != (int)sizeof(float)},
+           {2 * (int)sizeof(float), 1, false}},
+          LAYOUT_INT_CONST_BYTES,
+          LAYOUT_INT_ALIGN_NUM};
+}
+
+#endif  // KERNELS_ABS_ABS_LAYOUT_H_
@@ -0,0 +1,20 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_ADAM_UPDATE_ADAM_UPDATE_H_
+#define KERNELS_ADAM_UPDATE_ADAM_UPDATE_H_
+
+#include "kernels/optimizer_op/optimizer_op_3pipeline.h"
+
+// declare adam_update 3stage pipeline kernel, half is always computed in float
+OPTIMIZER_OP_3PIPELINE_DECLARE(AdamUpdate, float, Fast);
+OPTIMIZER_OP_3PIPELINE_DECLARE(AdamUpdate, half, HighAcc);
+#endif  // KERNELS_ADAM_UPDATE_ADAM_UPDATE_H_
@@ -0,0 +1,481 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_APPROX_MATH_H_
+#define KERNELS_APPROX_MATH_H_
+
+#include <stdint.h>
+#include "kernels/layout_planner.h"
+
+/* Polynomial log and sqrt of the CNNL_COMPUTATION_APPROX kernels.
+ *
+ * Instead of the range scaling buffers around the active functions, the exponent is split
+ * off with bit operations: x & 0x7f800000 read as an int32 and converted to float is
+ * E * 2^23, E the biased exponent, and a power of two is built back by converting
+ * E' * 2^23 to int32. The mantissa is then a polynomial away from the result.
+ *
+ * log: x = r * 2^e with r in [sqrt(2) / 2, sqrt(2)), log(1 + t) for t = r - 1 is the
+ * minimax polynomial of Cephes logf, ln(2) * e is added in two parts.
+ * sqrt: x = m * 2^e with e even and m in [1, 4), a cubic minimax guess z of 1 / sqrt(m)
+ * takes a Newton step, then y = m * z is corrected once, sqrt(x) = y * 2^(e / 2).
+ *
+ * A chunk is computed by sub-chunks of APPROX_SUB_NUM floats in a fixed scratch, so the
+ * layouts only hold the x buffers and the chunks are larger than with per-element aux
+ * buffers. The vector operations are thin wrappers, the host builds them as loops, and
+ * test/approx_math_sim.cc checks the bounds below against a double reference on every
+ * half and on sampled floats.
+ *
+ * The other inputs are split off by compares before the polynomial, as the Fast kernels
+ * mask theirs: a positive subnormal float is scaled by 2^24 into the normal range and the
+ * exponent is corrected, zero, negative, inf and nan lanes take a harmless input and their
+ * IEEE result is or-ed in as bits afterwards, -inf for log(+-0), nan for a negative x,
+ * x itself for +inf, nan and sqrt(+-0). Masks are built as bits, so no inf or nan is ever
+ * multiplied by zero.
+ */
+#define APPROX_SUB_NUM 1024  // floats, a multiple of LAYOUT_ALIGN_NUM
+// t0 to t5, the exponent mask and APPROX_CONST_NUM vectors of LAYOUT_ALIGN_NUM constants
+#define APPROX_CONST_NUM 4
+#define APPROX_SCRATCH_BYTES \
+  ((7 * APPROX_SUB_NUM + APPROX_CONST_NUM * LAYOUT_ALIGN_NUM) * 4)
+
+// Max error in ulp of the result type against the exact result, test/approx_math_sim.cc.
+#define APPROX_LOG_MAX_ULP_FLOAT 2.5
+#define APPROX_LOG_MAX_ULP_HALF 1.0
+#define APPROX_SQRT_MAX_ULP_FLOAT 1.5
+#define APPROX_SQRT_MAX_ULP_HALF 1.0
+
+#define APPROX_EXP_MASK 0x7f800000
+#define APPROX_EXP_ONE 8388608.0f  // 2^23, one in the exponent field
+#define APPROX_SQRT2X2 2.82842712f
+#define APPROX_LN2_HI 0.693359375f  // ln(2) in two parts, e * APPROX_LN2_HI is exact
+#define APPROX_LN2_LO -2.12194440e-4f
+#define APPROX_MIN_NORMAL 1.17549435e-38f  // 2^-126
+#define APPROX_MAX_FLOAT 3.40282347e+38f
+#define APPROX_SUB_EXP 24  // subnormal floats are scaled by 2^APPROX_SUB_EXP
+#define APPROX_SUB_SCALE 16777216.0f
+#define APPROX_NAN_BITS 2143289344.0f     // 0x7fc00000 as an int32, a quiet nan
+#define APPROX_NEG_INF_BITS -8388608.0f  // 0xff800000 as an int32, -inf
+
+// The constant vectors, consts + APPROX_CONST_XXX * LAYOUT_ALIGN_NUM.
+#define APPROX_CONST_SQRT2X2 0
+#define APPROX_CONST_ZERO 1
+#define APPROX_CONST_MIN_NORMAL 2
+#define APPROX_CONST_MAX_FLOAT 3
+
+#if defined(__BANG__)
+#define APPROX_FUNC __mlu_func__
+
+APPROX_FUNC void approxSetConsts(int32_t *exp_mask, float *consts) {
+  __nramset(exp_mask, APPROX_SUB_NUM, (int32_t)APPROX_EXP_MASK);
+  __nramset(consts + APPROX_CONST_SQRT2X2 * LAYOUT_ALIGN_NUM, LAYOUT_ALIGN_NUM, APPROX_SQRT2X2);
+  __nramset(consts + APPROX_CONST_ZERO * LAYOUT_ALIGN_NUM, LAYOUT_ALIGN_NUM, 0.0f);
+  __nramset(consts + APPROX_CONST_MIN_NORMAL * LAYOUT_ALIGN_NUM, LAYOUT_ALIGN_NUM,
+            APPROX_MIN_NORMAL);
+  __nramset(consts + APPROX_CONST_MAX_FLOAT * LAYOUT_ALIGN_NUM, LAYOUT_ALIGN_NUM,
+            APPROX_MAX_FLOAT);
+}
+
+// dst = src & exp_mask bitwise, num floats.
+APPROX_FUNC void approxBandExp(float *dst, float *src, int32_t *exp_mask, int32_t num) {
+  __bang_band((char *)dst, (char *)src, (char *)exp_mask, num * (int32_t)sizeof(float));
+}
+
+// dst = a & b bitwise, num floats.
+APPROX_FUNC void approxBand(float *dst, float *a, float *b, int32_t num) {
+  __bang_band((char *)dst, (char *)a, (char *)b, num * (int32_t)sizeof(float));
+}
+
+// dst = a | b bitwise, num floats.
+APPROX_FUNC void approxBor(float *dst, float *a, float *b, int32_t num) {
+  __bang_bor((char *)dst, (char *)a, (char *)b, num * (int32_t)sizeof(float));
+}
+
+// The int32 in v to float, in place.
+APPROX_FUNC void approxIntToFloat(float *v, int32_t num) {
+  __bang_int322float(v, (int32_t *)v, num, 0);
+}
+
+// The float in v to int32 rounded down, in place.
+APPROX_FUNC void approxFloatToInt(float *v, int32_t num) {
+  __bang_float2int32_rd((int32_t *)v, v, num, 0);
+}
+
+APPROX_FUNC void approxMul(float *dst, float *a, float *b, int32_t num) {
+  __bang_mul(dst, a, b, num);
+}
+
+APPROX_FUNC void approxAdd(float *dst, float *a, float *b, int32_t num) {
+  __bang_add(dst, a, b, num);
+}
+
+APPROX_FUNC void approxMulConst(float *dst, float *a, float value, int32_t num) {
+  __bang_mul_const(dst, a, value, num);
+}
+
+APPROX_FUNC void approxAddConst(float *dst, float *a, float value, int32_t num) {
+  __bang_add_const(dst, a, value, num);
+}
+
+APPROX_FUNC void approxGeConst(float *dst, float *a, float *consts, int32_t num) {
+  __bang_cycle_ge(dst, a, consts, num, LAYOUT_ALIGN_NUM);
+}
+
+APPROX_FUNC void approxGtConst(float *dst, float *a, float *consts, int32_t num) {
+  __bang_cycle_gt(dst, a, consts, num, LAYOUT_ALIGN_NUM);
+}
+
+APPROX_FUNC void approxLtConst(float *dst, float *a, float *consts, int32_t num) {
+  __bang_cycle_lt(dst, a, consts, num, LAYOUT_ALIGN_NUM);
+}
+
+APPROX_FUNC void approxLeConst(float *dst, float *a, float *consts, int32_t num) {
+  __bang_cycle_le(dst, a, consts, num, LAYOUT_ALIGN_NUM);
+}
+
+APPROX_FUNC void approxEqConst(float *dst, float *a, float *consts, int32_t num) {
+  __bang_cycle_eq(dst, a, consts, num, LAYOUT_ALIGN_NUM);
+}
+
+APPROX_FUNC void approxRelu(float *v, int32_t num) {
+  __bang_active_relu(v, v, num);
+}
+#else
+#include <math.h>
+#include <string.h>
+#define APPROX_FUNC static inline
+
+APPROX_FUNC void approxSetConsts(int32_t *exp_mask, float *consts) {
+  for (int32_t i = 0; i < APPROX_SUB_NUM; ++i) {
+    exp_mask[i] = APPROX_EXP_MASK;
+  }
+  const float values[APPROX_CONST_NUM] = {APPROX_SQRT2X2, 0.0f, APPROX_MIN_NORMAL,
+                                          APPROX_MAX_FLOAT};
+  for (int32_t i = 0; i < APPROX_CONST_NUM * LAYOUT_ALIGN_NUM; ++i) {
+    consts[i] = values[i / LAYOUT_ALIGN_NUM];
+  }
+}
+
+APPROX_FUNC void approxBandExp(float *dst, float *src, int32_t *exp_mask, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    int32_t bits;
+    memcpy(&bits, src + i, sizeof(bits));
+    bits &= exp_mask[i];
+    memcpy(dst + i, &bits, sizeof(bits));
+  }
+}
+
+APPROX_FUNC void approxBand(float *dst, float *a, float *b, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    int32_t bits_a, bits_b;
+    memcpy(&bits_a, a + i, sizeof(bits_a));
+    memcpy(&bits_b, b + i, sizeof(bits_b));
+    bits_a &= bits_b;
+    memcpy(dst + i, &bits_a, sizeof(bits_a));
+  }
+}
+
+APPROX_FUNC void approxBor(float *dst, float *a, float *b, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    int32_t bits_a, bits_b;
+    memcpy(&bits_a, a + i, sizeof(bits_a));
+    memcpy(&bits_b, b + i, sizeof(bits_b));
+    bits_a |= bits_b;
+    memcpy(dst + i, &bits_a, sizeof(bits_a));
+  }
+}
+
+APPROX_FUNC void approxIntToFloat(float *v, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    int32_t bits;
+    memcpy(&bits, v + i, sizeof(bits));
+    v[i] = (float)bits;
+  }
+}
+
+APPROX_FUNC void approxFloatToInt(float *v, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    int32_t bits = (int32_t)floorf(v[i]);
+    memcpy(v + i, &bits, sizeof(bits));
+  }
+}
+
+APPROX_FUNC void approxMul(float *dst, float *a, float *b, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    dst[i] = a[i] * b[i];
+  }
+}
+
+APPROX_FUNC void approxAdd(float *dst, float *a, float *b, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    dst[i] = a[i] + b[i];
+  }
+}
+
+APPROX_FUNC void approxMulConst(float *dst, float *a, float value, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    dst[i] = a[i] * value;
+  }
+}
+
+APPROX_FUNC void approxAddConst(float *dst, float *a, float value, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    dst[i] = a[i] + value;
+  }
+}
+
+APPROX_FUNC void approxGeConst(float *dst, float *a, float *consts, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    dst[i] = a[i] >= consts[i % LAYOUT_ALIGN_NUM] ? 1.0f : 0.0f;
+  }
+}
+
+APPROX_FUNC void approxGtConst(float *dst, float *a, float *consts, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    dst[i] = a[i] > consts[i % LAYOUT_ALIGN_NUM] ? 1.0f : 0.0f;
+  }
+}
+
+APPROX_FUNC void approxLtConst(float *dst, float *a, float *consts, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    dst[i] = a[i] < consts[i % LAYOUT_ALIGN_NUM] ? 1.0f : 0.0f;
+  }
+}
+
+APPROX_FUNC void approxLeConst(float *dst, float *a, float *consts, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    dst[i] = a[i] <= consts[i % LAYOUT_ALIGN_NUM] ? 1.0f : 0.0f;
+  }
+}
+
+APPROX_FUNC void approxEqConst(float *dst, float *a, float *consts, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    dst[i] = a[i] == consts[i % LAYOUT_ALIGN_NUM] ? 1.0f : 0.0f;
+  }
+}
+
+APPROX_FUNC void approxRelu(float *v, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    v[i] = v[i] > 0 ? v[i] : 0;
+  }
+}
+#endif  // defined(__BANG__)
+
+/* Prepares v for the polynomial of log, or of sqrt when !is_log. Afterwards special holds the
+ * result bits of the lanes the polynomial does not take and 0 elsewhere, sub is 1 where v was
+ * a positive subnormal, now scaled by 2^APPROX_SUB_EXP, and v is 1 for log and 0 for sqrt in
+ * the special lanes, whose polynomial result is then +0. NaN fails every compare.
+ */
+APPROX_FUNC void approxSplitSpecial(float *v,
+                                    float *special,
+                                    float *sub,
+                                    float *t1,
+                                    float *t2,
+                                    float *t3,
+                                    float *consts,
+                                    int32_t num,
+                                    bool is_log) {
+  float *zero       = consts + APPROX_CONST_ZERO * LAYOUT_ALIGN_NUM;
+  float *min_normal = consts + APPROX_CONST_MIN_NORMAL * LAYOUT_ALIGN_NUM;
+  float *max_float  = consts + APPROX_CONST_MAX_FLOAT * LAYOUT_ALIGN_NUM;
+  // sub = 0 < v < 2^-126, t1 = 1 where the polynomial takes v, sub or normal positive
+  approxGtConst(t1, v, zero, num);
+  approxLtConst(sub, v, min_normal, num);
+  approxMul(sub, sub, t1, num);
+  approxGeConst(t1, v, min_normal, num);
+  approxLeConst(t2, v, max_float, num);
+  approxMul(t1, t1, t2, num);
+  approxAdd(t1, t1, sub, num);
+  // t2 = 1 for a negative v, t3 = 1 for log(+-0), the other lanes pass v through
+  approxLtConst(t2, v, zero, num);
+  approxAdd(special, t1, t2, num);
+  if (is_log) {
+    approxEqConst(t3, v, zero, num);
+    approxAdd(special, special, t3, num);
+  }
+  approxAddConst(special, special, -1.0f, num);
+  approxFloatToInt(special, num);
+  approxBand(special, special, v, num);
+  // or the nan and -inf bits in
+  approxMulConst(t2, t2, APPROX_NAN_BITS, num);
+  if (is_log) {
+    approxMulConst(t3, t3, APPROX_NEG_INF_BITS, num);
+    approxAdd(t2, t2, t3, num);
+  }
+  approxFloatToInt(t2, num);
+  approxBor(special, special, t2, num);
+  // clear the special lanes, 1 for log, and scale the subnormal ones
+  approxMulConst(t2, t1, -1.0f, num);
+  approxFloatToInt(t2, num);
+  approxBand(v, v, t2, num);
+  if (is_log) {
+    approxMulConst(t1, t1, -1.0f, num);
+    approxAddConst(t1, t1, 1.0f, num);
+    approxAdd(v, v, t1, num);
+  }
+  approxMulConst(t2, sub, APPROX_SUB_SCALE - 1.0f, num);
+  approxAddConst(t2, t2, 1.0f, num);
+  approxMul(v, v, t2, num);
+}
+
+/* v = log(v) * coef in place, coef the base factor of kernels/log/log.mlu.
+ * t1 to t5 hold num floats, num is at most APPROX_SUB_NUM.
+ */
+APPROX_FUNC void approxLog(float *v,
+                           float *t1,
+                           float *t2,
+                           float *t3,
+                           float *t4,
+                           float *t5,
+                           int32_t *exp_mask,
+                           float *consts,
+                           int32_t num,
+                           float coef) {
+  float *special = t4;
+  float *sub     = t5;
+  approxSplitSpecial(v, special, sub, t1, t2, t3, consts, num, true);
+  // v * 2^(128 - E) is in [2, 4), the power of two is normal for every normal v
+  approxBandExp(t1, v, exp_mask, num);
+  approxIntToFloat(t1, num);
+  approxMulConst(t2, t1, -1.0f, num);
+  approxAddConst(t2, t2, 255 * APPROX_EXP_ONE, num);
+  approxFloatToInt(t2, num);
+  approxMul(v, v, t2, num);
+  // halved, or quartered from 2 * sqrt(2) up, to r, e = E - 127 + quartered
+  approxMulConst(t1, t1, 1.0f / APPROX_EXP_ONE, num);
+  approxAddConst(t1, t1, -127.0f, num);
+  approxMulConst(t2, sub, -APPROX_SUB_EXP, num);
+  approxAdd(t1, t1, t2, num);
+  approxGeConst(t2, v, consts + APPROX_CONST_SQRT2X2 * LAYOUT_ALIGN_NUM, num);
+  approxAdd(t1, t1, t2, num);
+  approxMulConst(t2, t2, -0.25f, num);
+  approxAddConst(t2, t2, 0.5f, num);
+  approxMul(v, v, t2, num);
+  approxAddConst(v, v, -1.0f, num);
+  // log(1 + t) = t - t^2 / 2 + t^3 * P(t)
+  approxMul(t3, v, v, num);
+  approxMulConst(t2, v, 7.0376836292e-2f, num);
+  approxAddConst(t2, t2, -1.1514610310e-1f, num);
+  approxMul(t2, t2, v, num);
+  approxAddConst(t2, t2, 1.1676998740e-1f, num);
+  approxMul(t2, t2, v, num);
+  approxAddConst(t2, t2, -1.2420140846e-1f, num);
+  approxMul(t2, t2, v, num);
+  approxAddConst(t2, t2, 1.4249322787e-1f, num);
+  approxMul(t2, t2, v, num);
+  approxAddConst(t2, t2, -1.6668057665e-1f, num);
+  approxMul(t2, t2, v, num);
+  approxAddConst(t2, t2, 2.0000714765e-1f, num);
+  approxMul(t2, t2, v, num);
+  approxAddConst(t2, t2, -2.4999993993e-1f, num);
+  approxMul(t2, t2, v, num);
+  approxAddConst(t2, t2, 3.3333331174e-1f, num);
+  approxMul(t2, t2, v, num);
+  approxMul(t2, t2, t3, num);
+  approxMulConst(t3, t3, -0.5f, num);
+  approxAdd(t2, t2, t3, num);
+  approxMulConst(t3, t1, APPROX_LN2_LO, num);
+  approxAdd(t2, t2, t3, num);
+  approxAdd(v, v, t2, num);
+  approxMulConst(t1, t1, APPROX_LN2_HI, num);
+  approxAdd(v, v, t1, num);
+  approxMulConst(v, v, coef, num);
+  approxBor(v, v, special, num);
+}
+
+// v = sqrt(v) in place. t1 to t5 hold num floats, num is at most APPROX_SUB_NUM.
+APPROX_FUNC void approxSqrt(float *v,
+                            float *t1,
+                            float *t2,
+                            float *t3,
+                            float *t4,
+                            float *t5,
+                            int32_t *exp_mask,
+                            float *consts,
+                            int32_t num) {
+  float *special = t4;
+  float *sub     = t5;
+  approxSplitSpecial(v, special, sub, t1, t2, t3, consts, num, false);
+  // f = floor((E - 1) / 2), zero for zero, then m = v * 2^(253 - 2f - 127) in [1, 4)
+  approxBandExp(t1, v, exp_mask, num);
+  approxIntToFloat(t1, num);
+  approxMulConst(t1, t1, 0.5f / APPROX_EXP_ONE, num);
+  approxAddConst(t1, t1, -0.5f, num);
+  approxFloatToInt(t1, num);
+  approxIntToFloat(t1, num);
+  approxRelu(t1, num);
+  approxMulConst(t2, t1, -2 * APPROX_EXP_ONE, num);
+  approxAddConst(t2, t2, 253 * APPROX_EXP_ONE, num);
+  approxFloatToInt(t2, num);
+  approxMul(v, v, t2, num);
+  // z ~ 1 / sqrt(m), a relative error of 7e-3 and then 7e-5 after a Newton step
+  approxMulConst(t2, v, -1.905041397e-2f, num);
+  approxAddConst(t2, t2, 1.946857038e-1f, num);
+  approxMul(t2, t2, v, num);
+  approxAddConst(t2, t2, -7.388630494e-1f, num);
+  approxMul(t2, t2, v, num);
+  approxAddConst(t2, t2, 1.556187102f, num);
+  approxMul(t3, t2, t2, num);
+  approxMul(t3, t3, v, num);
+  approxMulConst(t3, t3, -0.5f, num);
+  approxAddConst(t3, t3, 1.5f, num);
+  approxMul(t2, t2, t3, num);
+  // y = m * z, then y + y * (1 - z * y) / 2 takes the error of y to 4e-9 before rounding
+  approxMul(t3, v, t2, num);
+  approxMul(v, t2, t3, num);
+  approxMulConst(v, v, -0.5f, num);
+  approxAddConst(v, v, 0.5f, num);
+  approxMul(v, v, t3, num);
+  approxAdd(v, v, t3, num);
+  // times 2^(f - 63), half the even exponent, less half the scaling of a subnormal v
+  approxMulConst(t2, sub, -0.5f * APPROX_SUB_EXP, num);
+  approxAdd(t1, t1, t2, num);
+  approxMulConst(t1, t1, APPROX_EXP_ONE, num);
+  approxAddConst(t1, t1, 64 * APPROX_EXP_ONE, num);
+  approxFloatToInt(t1, num);
+  approxMul(v, v, t1, num);
+  approxBor(v, v, special, num);
+}
+
+#if defined(__BANG__)
+/* x = log(x) * coef, or sqrt(x) when Sqrt, in place for deal_num elements of T, by
+ * sub-chunks in the APPROX_SCRATCH_BYTES of scratch: t0 to t5, the exponent mask and the
+ * constants. half is widened to t0 and rounded down back into x.
+ */
+template <typename T, bool Sqrt>
+__mlu_func__ void approxCompute(T *x, char *scratch, int32_t deal_num, float coef) {
+  float *t0         = (float *)scratch;
+  float *t1         = t0 + APPROX_SUB_NUM;
+  float *t2         = t1 + APPROX_SUB_NUM;
+  float *t3         = t2 + APPROX_SUB_NUM;
+  float *t4         = t3 + APPROX_SUB_NUM;
+  float *t5         = t4 + APPROX_SUB_NUM;
+  int32_t *exp_mask = (int32_t *)(t5 + APPROX_SUB_NUM);
+  float *consts     = t5 + 2 * APPROX_SUB_NUM;
+  approxSetConsts(exp_mask, consts);
+  for (int32_t i = 0; i < deal_num; i += APPROX_SUB_NUM) {
+    int32_t num = deal_num - i < APPROX_SUB_NUM ? deal_num - i : APPROX_SUB_NUM;
+    float *v    = sizeof(T) == sizeof(float) ? (float *)x + i : t0;
+    if (sizeof(T) != sizeof(float)) {
+      __bang_half2float(t0, (half *)x + i, num);
+    }
+    if (Sqrt) {
+      approxSqrt(v, t1, t2, t3, t4, t5, exp_mask, consts, num);
+    } else {
+      approxLog(v, t1, t2, t3, t4, t5, exp_mask, consts, num, coef);
+    }
+    if (sizeof(T) != sizeof(float)) {
+      __bang_float2half_rd((half *)x + i, t0, num);
+    }
+  }
+}
+#endif  // defined(__BANG__)
+
+#endif  // KERNELS_APPROX_MATH_H_
@@ -13,15 +13,25 @@
 #define KERNELS_BINARY_OP_BINARY_OP_3PIPELINE_H_
 
 #include "kernels/kernel.h"
+#include "kernels/pipeline_schedule.h"
 #define BINARY_ALIGN_NUM 64
 
-#define BINARY_OP_3PIPELINE_DECLARE(Op, Dtype, Prefer)                                      \
-  __mlu_global__ void MLUKernel3StagePipeline##Op##Dtype##Prefer(void *a, void *b, void *c, \
-                                                                 int32_t data_num)
+/* The 3stage kernels are built for every pipeline depth, see kernels/pipeline_schedule.h.
+ * Depth 2 keeps the kernel name, depth 3 and 4 add a Depth3 or Depth4 suffix. coef is
+ * passed to the compute function, e.g. the eps of DivEps, the other ops ignore it.
+ */
+#define BINARY_OP_3PIPELINE_DECLARE_DEPTH(Op, Dtype, Prefer, Suffix)      \
+  __mlu_global__ void MLUKernel3StagePipeline##Op##Dtype##Prefer##Suffix( \
+      void *a, void *b, void *c, int32_t data_num, float coef)
 
-#define BINARY_OP_3PIPELINE_IMPLE(Op, Dtype, Prefer)                                            \
-  __mlu_global__ void MLUKernel3StagePipeline##Op##Dtype##Prefer(void *x, void *y, void *z,     \
-                                                                 int32_t data_num) {            \
+#define BINARY_OP_3PIPELINE_DECLARE(Op, Dtype, Prefer)          \
+  BINARY_OP_3PIPELINE_DECLARE_DEPTH(Op, Dtype, Prefer, );       \
+  BINARY_OP_3PIPELINE_DECLARE_DEPTH(Op, Dtype, Prefer, Depth3); \
+  BINARY_OP_3PIPELINE_DECLARE_DEPTH(Op, Dtype, Prefer, Depth4)
+
+#define BINARY_OP_3PIPELINE_IMPLE_DEPTH(Op, Dtype, Prefer, Depth, Suffix)                       \
+  __mlu_global__ void MLUKernel3StagePipeline##Op##Dtype##Prefer##Suffix(                       \
+      void *x, void *y, void *z, int32_t data_num, float coef) {                                \
     int32_t nram_limit = 0;                                                                     \
     int32_t pong_x     = 0;                                                                     \
     int32_t pong_y     = 0;                                                                     \
@@ -30,16 +40,79 @@
     Dtype *nram_aux1   = NULL;                                                                  \
     Dtype *nram_aux2   = NULL;                                                                  \
     Dtype *nram_aux3   = NULL;                                                                  \
-    get3Offset##Op##Prefer(nram_limit, pong_x, pong_y, nram_x, nram_y, nram_aux1, nram_aux2,    \
-                           nram_aux3, nram_buffer);                                             \
-    processBinaryPipe3<Dtype, compute##Op##Prefer>(                                             \
+    get3Offset##Op##Prefer<Dtype, Depth>(nram_limit, pong_x, pong_y, nram_x, nram_y, nram_aux1, \
+                                         nram_aux2, nram_aux3, nram_buffer);                    \
+    processBinaryPipe3<Dtype, compute##Op##Prefer, Depth>(                                      \
         (Dtype *)x, (Dtype *)y, (Dtype *)z, nram_buffer, (Dtype *)nram_x, (Dtype *)nram_y,      \
         (Dtype *)nram_aux1, (Dtype *)nram_aux2, (Dtype *)nram_aux3, nram_limit, pong_x, pong_y, \
-        data_num);                                                                              \
+        data_num, coef);                                                                        \
+  }
+
+#define BINARY_OP_3PIPELINE_IMPLE(Op, Dtype, Prefer)            \
+  BINARY_OP_3PIPELINE_IMPLE_DEPTH(Op, Dtype, Prefer, 2, )       \
+  BINARY_OP_3PIPELINE_IMPLE_DEPTH(Op, Dtype, Prefer, 3, Depth3) \
+  BINARY_OP_3PIPELINE_IMPLE_DEPTH(Op, Dtype, Prefer, 4, Depth4)
+
+// Host side, registry entry of the kernels of every pipeline depth, see
+// kernels/kernel_registry.h.
+#define BINARY_OP_3PIPELINE_ENTRY(Op, Dtype, Prefer, layout) \
+  {KERNEL_DTYPE(Dtype),                                      \
+   KERNEL_PREFER(Prefer),                                    \
+   KERNEL_PIPELINE_3STAGE,                                   \
+   layout,                                                   \
+   {MLUKernel3StagePipeline##Op##Dtype##Prefer,              \
+    MLUKernel3StagePipeline##Op##Dtype##Prefer##Depth3,      \
+    MLUKernel3StagePipeline##Op##Dtype##Prefer##Depth4},     \
+   {"MLUKernel3StagePipeline" #Op #Dtype #Prefer,            \
+    "MLUKernel3StagePipeline" #Op #Dtype #Prefer "Depth3",   \
+    "MLUKernel3StagePipeline" #Op #Dtype #Prefer "Depth4"}}
+
+// The stages of processBinaryPipe3, chunk c is in buffer c % Depth of x and of y.
+template <typename Dtype,
+          void (*OpFunc)(Dtype *, Dtype *, Dtype *, Dtype *, Dtype *, int32_t, int32_t, float),
+          int Depth>
+struct Binary3Stages {
+  Dtype *x;
+  Dtype *y;
+  Dtype *z;
+  Dtype *nram_x;
+  Dtype *nram_y;
+  Dtype *nram_aux1;
+  Dtype *nram_aux2;
+  Dtype *nram_aux3;
+  int32_t nram_limit;
+  int32_t pong_x;
+  int32_t pong_y;
+  int32_t repeat;
+  int32_t rem;
+  float coef;
+
+  __mlu_func__ int32_t num(int32_t chunk) {
+    return chunk < repeat ? nram_limit : rem;
   }
 
+  __mlu_func__ void store(int32_t chunk) {
+    __memcpy_async(z + chunk * nram_limit, nram_x + (chunk % Depth) * pong_x,
+                   num(chunk) * sizeof(Dtype), NRAM2GDRAM);
+  }
+
+  __mlu_func__ void load(int32_t chunk) {
+    __memcpy_async(nram_x + (chunk % Depth) * pong_x, x + chunk * nram_limit,
+                   num(chunk) * sizeof(Dtype), GDRAM2NRAM);
+    __memcpy_async(nram_y + (chunk % Depth) * pong_y, y + chunk * nram_limit,
+                   num(chunk) * sizeof(Dtype), GDRAM2NRAM);
+  }
+
+  __mlu_func__ void compute(int32_t chunk) {
+    OpFunc(nram_x + (chunk % Depth) * pong_x, nram_y + (chunk % Depth) * pong_y, nram_aux1,
+           nram_aux2, nram_aux3, num(chunk),
+           chunk < repeat ? nram_limit : CEIL_ALIGN(rem, BINARY_ALIGN_NUM), coef);
+  }
+};
+
 template <typename Dtype,
-          void (*OpFunc)(Dtype *, Dtype *, Dtype *, Dtype *, Dtype *, int32_t, int32_t)>
+          void (*OpFunc)(Dtype *, Dtype *, Dtype *, Dtype *, Dtype *, int32_t, int32_t, float),
+          int Depth>
 __mlu_func__ void processBinaryPipe3(const Dtype *x,
                                      const Dtype *y,
                                      Dtype *z,
@@ -52,7 +125,8 @@ __mlu_func__ void processBinaryPipe3(const Dtype *x,
                                      const int32_t nram_limit,
                                      const int32_t pong_x,
                                      const int32_t pong_y,
-                                     const int32_t data_num) {
+                                     const int32_t data_num,
+                                     const float coef) {
   if (coreId == 0x80) {
     return;
   }
@@ -60,91 +134,26 @@ __mlu_func__ void processBinaryPipe3(const Dtype *x,
   // Dtype just use for POWN y inDtype6_t
   int32_t num_per_core = data_num / taskDim;
   int32_t rem_for_all  = data_num % taskDim;
-  Dtype *base_addr_x   = (Dtype *)x + taskId * num_per_core;
-  Dtype *base_addr_y   = (Dtype *)y + taskId * num_per_core;
-  Dtype *base_addr_z   = (Dtype *)z + taskId * num_per_core;
+  Binary3Stages<Dtype, OpFunc, Depth> stages;
+  stages.x = (Dtype *)x + taskId * num_per_core;
+  stages.y = (Dtype *)y + taskId * num_per_core;
+  stages.z = (Dtype *)z + taskId * num_per_core;
   if (rem_for_all > 0 && taskId == (taskDim - 1)) {
     num_per_core = num_per_core + rem_for_all;
   }
-
-  int32_t repeat    = num_per_core / nram_limit;
-  int32_t rem       = num_per_core % nram_limit;
-  int32_t align_rem = CEIL_ALIGN(rem, BINARY_ALIGN_NUM);
-
-  int32_t span_handle_size = nram_limit * sizeof(Dtype);
-  int32_t rem_size         = rem * sizeof(Dtype);
-
-  if (repeat > 0) {
-    // L
-    __memcpy_async(nram_x, base_addr_x, span_handle_size, GDRAM2NRAM);
-    __memcpy_async(nram_y, base_addr_y, span_handle_size, GDRAM2NRAM);
-    __asm__ volatile("sync;");
-  }
-  if (repeat > 1) {
-    // L
-    __memcpy_async(nram_x + pong_x, base_addr_x + nram_limit, span_handle_size, GDRAM2NRAM);
-    __memcpy_async(nram_y + pong_y, base_addr_y + nram_limit, span_handle_size, GDRAM2NRAM);
-    // C
-    OpFunc(nram_x, nram_y, nram_aux1, nram_aux2, nram_aux3, nram_limit, nram_limit);
-    __asm__ volatile("sync;");
-  }
-
-  for (int32_t i = 0; i < repeat - 2; i++) {
-    // S
-    pvLock();
-    __memcpy_async(base_addr_z + i * nram_limit, nram_x + (i % 2) * pong_x, span_handle_size,
-                   NRAM2GDRAM);
-    pvUnlock();
-    // L
-    __memcpy_async(nram_x + (i % 2) * pong_x, base_addr_x + (i + 2) * nram_limit, span_handle_size,
-                   GDRAM2NRAM);
-    __memcpy_async(nram_y + (i % 2) * pong_y, base_addr_y + (i + 2) * nram_limit, span_handle_size,
-                   GDRAM2NRAM);
-    // C
-    OpFunc(nram_x + ((i + 1) % 2) * pong_x, nram_y + ((i + 1) % 2) * pong_y, nram_aux1, nram_aux2,
-           nram_aux3, nram_limit, nram_limit);
-    __asm__ volatile("sync;");
-  }
-
-  if (repeat >= 2) {
-    // S
-    pvLock();
-    __memcpy_async(base_addr_z + (repeat - 2) * nram_limit, nram_x + (repeat % 2) * pong_x,
-                   span_handle_size, NRAM2GDRAM);
-    pvUnlock();
-  }
-  if (rem > 0) {
-    // L
-    __memcpy_async(nram_x + (repeat % 2) * pong_x, base_addr_x + repeat * nram_limit, rem_size,
-                   GDRAM2NRAM);
-    __memcpy_async(nram_y + (repeat % 2) * pong_y, base_addr_y + repeat * nram_limit, rem_size,
-                   GDRAM2NRAM);
-  }
-  if (repeat > 0) {
-    // C
-    OpFunc(nram_x + ((repeat - 1) % 2) * pong_x, nram_y + ((repeat - 1) % 2) * pong_y, nram_aux1,
-           nram_aux2, nram_aux3, nram_limit, nram_limit);
-  }
-  __asm__ volatile("sync;");
-
-  if (repeat > 0) {
-    // S
-    pvLock();
-    __memcpy_async(base_addr_z + (repeat - 1) * nram_limit, nram_x + ((repeat - 1) % 2) * pong_x,
-                   span_handle_size, NRAM2GDRAM);
-    pvUnlock();
-  }
-  if (rem > 0) {
-    // C
-    OpFunc(nram_x + (repeat % 2) * pong_x, nram_y + (repeat % 2) * pong_y, nram_aux1, nram_aux2,
-           nram_aux3, rem, align_rem);
-    __asm__ volatile("sync;");
-    // S
-    pvLock();
-    __memcpy_async(base_addr_z + repeat * nram_limit, nram_x + (repeat % 2) * pong_x, rem_size,
-                   NRAM2GDRAM);
-    pvUnlock();
-  }
+  stages.nram_x     = nram_x;
+  stages.nram_y     = nram_y;
+  stages.nram_aux1  = nram_aux1;
+  stages.nram_aux2  = nram_aux2;
+  stages.nram_aux3  = nram_aux3;
+  stages.nram_limit = nram_limit;
+  stages.pong_x     = pong_x;
+  stages.pong_y     = pong_y;
+  stages.repeat     = num_per_core / nram_limit;
+  stages.rem        = num_per_core % nram_limit;
+  stages.coef       = coef;
+  // the last chunk holds rem elements
+  pipelineRun<Depth>(stages.repeat + (stages.rem > 0 ? 1 : 0), stages);
 }
 
 #endif  // KERNELS_BINARY_OP_BINARY_OP_3PIPELINE_H_
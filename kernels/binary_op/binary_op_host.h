@@ -14,6 +14,10 @@
 
 #include <string>
 #include "include/cnnl_core.h"
+#include "kernels/layout_planner.h"
+
+// Launch signature of the binary kernels, coef is a scalar of the op where it has one.
+typedef void (*BinaryKernel)(void *a, void *b, void *c, int32_t data_num, float coef);
 
 void binaryOpPolicyFunc(const cnnlHandle_t &handle,
                         const cnnlTensorDescriptor_t &desc,
@@ -18,4 +18,12 @@
 BINARY_OP_3PIPELINE_DECLARE(Div, half, HighAcc);
 BINARY_OP_3PIPELINE_DECLARE(Div, half, Fast);
 BINARY_OP_3PIPELINE_DECLARE(Div, float, Fast);
+
+// declare integer div 3stage pipeline kernels, truncating and flooring
+BINARY_OP_3PIPELINE_DECLARE(DivInt, int8_t, Fast);
+BINARY_OP_3PIPELINE_DECLARE(DivInt, int16_t, Fast);
+BINARY_OP_3PIPELINE_DECLARE(DivInt, int32_t, Fast);
+BINARY_OP_3PIPELINE_DECLARE(DivFloor, int8_t, Fast);
+BINARY_OP_3PIPELINE_DECLARE(DivFloor, int16_t, Fast);
+BINARY_OP_3PIPELINE_DECLARE(DivFloor, int32_t, Fast);
 #endif  // KERNELS_DIV_DIV_H_
@@ -0,0 +1,47 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_DIV_DIV_LAYOUT_H_
+#define KERNELS_DIV_DIV_LAYOUT_H_
+
+#include "kernels/layout_planner.h"
+
+// zero, factor and bound vectors of BINARY_ALIGN_NUM floats
+#define DIV_CONST_BYTES (3 * LAYOUT_ALIGN_NUM * (int)sizeof(float))
+
+/* depth x buffers - depth y buffers - aux1 (scaling, zoom) - aux2 (aux2, aux4) - constants.
+ * Half inputs, Fast or HighAcc, are widened to float in place.
+ */
+constexpr LayoutSpec div3Layout(int elem_size, int depth) {
+  return LayoutSpec{4,
+                    {{(int)sizeof(float), depth, elem_size != (int)sizeof(float)},
+                     {(int)sizeof(float), depth, elem_size != (int)sizeof(float)},
+                     {2 * (int)sizeof(float), 1, false},
+                     {2 * (int)sizeof(float), 1, false}},
+                    DIV_CONST_BYTES,
+                    LAYOUT_ALIGN_NUM};
+}
+
+/* Integer div: depth x buffers - depth y buffers - aux1 (scaling) - aux2 (aux2, reciprocal,
+ * quotient) - div constants - integer constants. int8 and int16 are widened to float in place,
+ * int32 keeps the halves, limbs and remainders of divInt32 in an aux2 of 13 floats.
+ */
+constexpr LayoutSpec divInt3Layout(int elem_size, int depth) {
+  return LayoutSpec{4,
+                    {{(int)sizeof(float), depth, elem_size != (int)sizeof(float)},
+                     {(int)sizeof(float), depth, elem_size != (int)sizeof(float)},
+                     {2 * (int)sizeof(float), 1, false},
+                     {(elem_size == 4 ? 13 : 4) * (int)sizeof(float), 1, false}},
+                    DIV_CONST_BYTES + LAYOUT_INT_CONST_BYTES,
+                    LAYOUT_INT_ALIGN_NUM};
+}
+
+#endif  // KERNELS_DIV_DIV_LAYOUT_H_
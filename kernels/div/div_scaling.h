@@ -0,0 +1,86 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_DIV_DIV_SCALING_H_
+#define KERNELS_DIV_DIV_SCALING_H_
+
+#include "kernels/div/div_layout.h"
+
+/* Range scaling around __bang_active_reciphp, shared by div, div_eps and reciprocal.
+ *
+ * reciphp is only accurate on a limited positive range. The divisor is made positive, then
+ * for float the large values are zoomed by SCALE and the tiny ones by LOW_SCALE, and the
+ * reciprocal is scaled back by the same factors. half already fits the range.
+ *
+ * consts holds the zero, factor and bound vectors of LAYOUT_ALIGN_NUM floats,
+ * DIV_CONST_BYTES, see setDivConsts.
+ */
+#define HIGH_BOUND 1e5
+#define LOW_BOUND 1e-10
+#define SCALE 1e-5
+#define LOW_SCALE 1e10
+
+__mlu_func__ void setDivConsts(float *consts) {
+  __nramset(consts + LAYOUT_ALIGN_NUM, LAYOUT_ALIGN_NUM, (float)HIGH_BOUND);
+  __nramset(consts + 2 * LAYOUT_ALIGN_NUM, LAYOUT_ALIGN_NUM, (float)LOW_BOUND);
+}
+
+// y = 1 / y in place, scaling and aux hold 2 * deal_num elements of T.
+template <typename T>
+__mlu_func__ void scaledReciprocal(T *y, T *scaling, T *aux, float *consts, int32_t deal_num) {
+  T *zoom   = scaling + deal_num;
+  T *aux4   = aux + deal_num;
+  T *zero   = (T *)consts;
+  T *factor = (T *)(consts + LAYOUT_ALIGN_NUM);
+  T *bound  = (T *)(consts + 2 * LAYOUT_ALIGN_NUM);
+  __bang_write_zero(zero, LAYOUT_ALIGN_NUM);
+  // ensure all the input are larger than 0
+  __bang_cycle_gt(scaling, y, zero, deal_num, LAYOUT_ALIGN_NUM);
+  __bang_mul_const(scaling, scaling, (T)(2), deal_num);
+  __bang_add_const(scaling, scaling, (T)(-1), deal_num);
+  __bang_mul(y, y, scaling, deal_num);
+  if (sizeof(T) == sizeof(float)) {
+    // ZOOM
+    __bang_cycle_lt(zoom, y, factor, deal_num, LAYOUT_ALIGN_NUM);
+    __bang_mul_const((float *)zoom, (float *)zoom, (float)(1 - SCALE), deal_num);
+    __bang_add_const((float *)zoom, (float *)zoom, (float)SCALE, deal_num);
+    __bang_mul(y, y, zoom, deal_num);
+
+    __bang_cycle_lt(aux, y, bound, deal_num, LAYOUT_ALIGN_NUM);
+    __bang_mul_const((float *)aux4, (float *)aux, (float)LOW_SCALE, deal_num);
+    __bang_cycle_eq(aux, aux, zero, deal_num, LAYOUT_ALIGN_NUM);
+    __bang_add(aux, aux, aux4, deal_num);
+    __bang_mul(y, y, aux, deal_num);
+  }
+  // execute active
+  __bang_active_reciphp(y, y, deal_num);
+  // recover all the sacled input data
+  if (sizeof(T) == sizeof(float)) {
+    __bang_mul(y, y, zoom, deal_num);
+    __bang_mul(y, y, aux, deal_num);
+  }
+  __bang_mul(y, y, scaling, deal_num);
+}
+
+/* Zero divisor policy of div_eps: x is zeroed and y set to 1 where y is 0, so x * (1 / y)
+ * gives 0 there. mask holds deal_num elements of T, the scaling buffer can be used.
+ */
+template <typename T>
+__mlu_func__ void maskZeroDivisor(T *x, T *y, T *mask, float *consts, int32_t deal_num) {
+  T *zero = (T *)consts;
+  __bang_write_zero(zero, LAYOUT_ALIGN_NUM);
+  __bang_cycle_eq(mask, y, zero, deal_num, LAYOUT_ALIGN_NUM);
+  __bang_add(y, y, mask, deal_num);
+  __bang_cycle_eq(mask, mask, zero, deal_num, LAYOUT_ALIGN_NUM);
+  __bang_mul(x, x, mask, deal_num);
+}
+
+#endif  // KERNELS_DIV_DIV_SCALING_H_
@@ -0,0 +1,149 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_INTEGER_MATH_H_
+#define KERNELS_INTEGER_MATH_H_
+
+#include "kernels/layout_planner.h"
+
+/* Integer kernels compute in float, the MLU270 vector unit has no integer arithmetic.
+ *
+ * int8 and int16 are exact in float. int32 is not above 2^24, abs splits it in 16-bit halves
+ * that are, see splitInt32. The int32 division works on the halves too: it divides 16-bit
+ * digits, and cuts the divisor further so that every product of its remainders is below
+ * 2^24, see divInt32 of kernels/div/div_device.mlu.
+ *
+ * Counts of the conversions are multiples of LAYOUT_INT_ALIGN_NUM, the layouts of the
+ * integer kernels align num_deal to it.
+ *
+ * consts holds the zero, max and 2^23 vectors of LAYOUT_ALIGN_NUM floats,
+ * LAYOUT_INT_CONST_BYTES, see setIntConsts.
+ */
+#define INT_ROUND_MAGIC 8388608.0f  // 2^23, floats from it up have no fraction
+#define INT_HALF_SCALE 65536.0f     // 2^16, the weight of the high half of an int32
+
+__mlu_func__ void intToFloat(float *dst, int8_t *src, int32_t num) {
+  __bang_int82float(dst, src, num, 0);
+}
+
+__mlu_func__ void intToFloat(float *dst, int16_t *src, int32_t num) {
+  __bang_int162float(dst, src, num, 0);
+}
+
+__mlu_func__ void intToFloat(float *dst, int32_t *src, int32_t num) {
+  __bang_int322float(dst, src, num, 0);
+}
+
+// src holds integers in the range of the type, the rounding mode does not matter.
+__mlu_func__ void floatToInt(int8_t *dst, float *src, int32_t num) {
+  __bang_float2int8_rd(dst, src, num, 0);
+}
+
+__mlu_func__ void floatToInt(int16_t *dst, float *src, int32_t num) {
+  __bang_float2int16_rd(dst, src, num, 0);
+}
+
+__mlu_func__ void floatToInt(int32_t *dst, float *src, int32_t num) {
+  __bang_float2int32_rd(dst, src, num, 0);
+}
+
+// The largest T, 2^31 - 128 for int32 which is the largest float below 2^31.
+template <typename T>
+__mlu_func__ void setIntConsts(float *consts) {
+  __bang_write_zero(consts, LAYOUT_ALIGN_NUM);
+  __nramset(consts + LAYOUT_ALIGN_NUM, LAYOUT_ALIGN_NUM,
+            sizeof(T) == 1 ? 127.0f : (sizeof(T) == 2 ? 32767.0f : 2147483520.0f));
+  __nramset(consts + 2 * LAYOUT_ALIGN_NUM, LAYOUT_ALIGN_NUM, INT_ROUND_MAGIC);
+}
+
+/* v = round(v) in place, ties to even, which the callers do not depend on.
+ * Adding and subtracting 2^23 with the sign of v drops the fraction, values from 2^23 up
+ * are already integers and are left as they are. aux holds 2 * num floats.
+ */
+__mlu_func__ void roundToInteger(float *v, float *aux, float *consts, int32_t num) {
+  float *sign  = aux;
+  float *magic = aux + num;
+  __bang_cycle_gt(sign, v, consts, num, LAYOUT_ALIGN_NUM);
+  __bang_cycle_lt(magic, v, consts, num, LAYOUT_ALIGN_NUM);
+  __bang_sub(sign, sign, magic, num);
+  __bang_mul(magic, v, sign, num);
+  __bang_cycle_lt(magic, magic, consts + 2 * LAYOUT_ALIGN_NUM, num, LAYOUT_ALIGN_NUM);
+  __bang_mul(magic, magic, sign, num);
+  __bang_mul_const(magic, magic, INT_ROUND_MAGIC, num);
+  __bang_add(v, v, magic, num);
+  __bang_sub(v, v, magic, num);
+}
+
+/* v = min(v, max of T) in place. Integer results only overflow upwards, |MIN| and
+ * MIN / -1, so there is no lower bound. aux holds 2 * num floats.
+ */
+__mlu_func__ void saturateInt(float *v, float *aux, float *consts, int32_t num) {
+  float *over = aux;
+  float *mask = aux + num;
+  __bang_cycle_sub(over, v, consts + LAYOUT_ALIGN_NUM, num, LAYOUT_ALIGN_NUM);
+  __bang_cycle_gt(mask, v, consts + LAYOUT_ALIGN_NUM, num, LAYOUT_ALIGN_NUM);
+  __bang_mul(over, over, mask, num);
+  __bang_sub(v, v, over, num);
+}
+
+/* x = hi + lo exactly, hi the high half of x times 2^16, signed, and lo the low half in
+ * [0, 2^16). The halves are cut with a bitwise and, both are exact in float.
+ */
+__mlu_func__ void splitInt32(float *hi, float *lo, int32_t *x, int32_t num) {
+  __nramset((int32_t *)hi, num, (int32_t)0xffff0000);
+  __nramset((int32_t *)lo, num, (int32_t)0x0000ffff);
+  __bang_band((char *)hi, (char *)x, (char *)hi, num * (int32_t)sizeof(int32_t));
+  __bang_band((char *)lo, (char *)x, (char *)lo, num * (int32_t)sizeof(int32_t));
+  __bang_int322float(hi, (int32_t *)hi, num, 0);
+  __bang_int322float(lo, (int32_t *)lo, num, 0);
+}
+
+/* |x| = hi + lo exactly, hi a multiple of 2^16 in [0, 2^31] and lo in [0, 2^16), sign = 1 or
+ * -1 the sign of x. The negation borrows 2^16 from the high half where the low half went
+ * negative, |MIN| is 2^31 and not saturated. aux holds num floats, it may be sign where the
+ * sign is not needed. consts holds the zero vector.
+ */
+__mlu_func__ void absInt32Halves(float *hi,
+                                 float *lo,
+                                 float *sign,
+                                 float *aux,
+                                 int32_t *x,
+                                 float *consts,
+                                 int32_t num) {
+  splitInt32(hi, lo, x, num);
+  __bang_cycle_lt(sign, hi, consts, num, LAYOUT_ALIGN_NUM);
+  __bang_mul_const(sign, sign, -2.0f, num);
+  __bang_add_const(sign, sign, 1.0f, num);
+  __bang_mul(hi, hi, sign, num);
+  __bang_mul(lo, lo, sign, num);
+  __bang_cycle_lt(aux, lo, consts, num, LAYOUT_ALIGN_NUM);
+  __bang_mul_const(aux, aux, INT_HALF_SCALE, num);
+  __bang_sub(hi, hi, aux, num);
+  __bang_add(lo, lo, aux, num);
+}
+
+// dst = floor(src * scale), scale a power of two so that the product is exact.
+__mlu_func__ void floorScaled(float *dst, float *src, float scale, int32_t num) {
+  __bang_mul_const(dst, src, scale, num);
+  __bang_float2int32_rd((int32_t *)dst, dst, num, 0);
+  __bang_int322float(dst, (int32_t *)dst, num, 0);
+}
+
+/* dst = hi + lo for hi a multiple of 2^16 in the int32 range and lo in [0, 2^16): both are
+ * converted exactly and their bits do not overlap. hi and lo are overwritten.
+ */
+__mlu_func__ void joinInt32(int32_t *dst, float *hi, float *lo, int32_t num) {
+  __bang_float2int32_rd((int32_t *)hi, hi, num, 0);
+  __bang_float2int32_rd((int32_t *)lo, lo, num, 0);
+  __bang_bor((char *)dst, (char *)hi, (char *)lo, num * (int32_t)sizeof(int32_t));
+}
+
+#endif  // KERNELS_INTEGER_MATH_H_
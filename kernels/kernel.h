@@ -16,6 +16,7 @@
  * Macros for host and device side
  ******************************************************************************/
 #define NFU_ALIGN_SIZE 128  // Byte
+#define NRAM_RESERVED_SIZE (128 * 1024)  // Byte, reserved for cncc
 #define CEIL_ALIGN(x, align) (((x) + (align)-1) / (align) * (align))
 #define FLOOR_ALIGN(x, align) ((x) / (align) * (align))
 
@@ -27,8 +28,13 @@
  * Macros for device side
  ******************************************************************************/
 #if defined(__BANG__)
-#define MAX_NRAM_SIZE (__MLU_NRAM_SIZE__ * 1024 - 128 * 1024)  // 128KB reserved for cncc
+#define MAX_NRAM_SIZE (__MLU_NRAM_SIZE__ * 1024 - NRAM_RESERVED_SIZE)
 #define MAX_SRAM_SIZE (__MLU_SRAM_SIZE__ * 1024 - 128 * 1024)  // 128KB reserved for cncc
+/* WRAM is left to the convolution and mlp kernels, the elementwise kernels do not use it:
+ * the vector instructions only read NRAM, so a constant table kept in WRAM needs a copy to
+ * NRAM before use, and staging chunks through WRAM needs NRAM double buffers to overlap the
+ * moves, which cancels the larger chunk.
+ */
 #define MAX_WRAM_SIZE (__MLU_WRAM_SIZE__ * 1024)
 #endif  // defined(__BANG__)
 
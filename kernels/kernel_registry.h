@@ -0,0 +1,144 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_KERNEL_REGISTRY_H_
+#define KERNELS_KERNEL_REGISTRY_H_
+
+#include "include/cnnl_core.h"
+#include "include/context.h"
+#include "include/tensor.h"
+#include "kernels/kernel.h"
+#include "kernels/layout_planner.h"
+#include "kernels/pipeline_schedule.h"
+
+/* Host side kernel dispatch of the elementwise operations.
+ *
+ * Each operation lists its kernels in a static table of KernelEntry, built with the
+ * *_ENTRY macros of kernels/unary_op and kernels/binary_op. They paste the same names as
+ * the DECLARE and IMPLE macros, so the table holds every kernel the device files define.
+ * The entries are in the order of preference, e.g. the 5stage kernels before the 3stage
+ * ones. An entry is a candidate on a handle when the capabilities of the handle run its
+ * pipeline, see isKernelPipelineSupported, never by the arch enum.
+ *
+ * KernelRegistry indexes the table once by capability, dtype and preference, a lookup is
+ * then a few array reads. A preference without a kernel of its own, e.g. the high
+ * precision of float or the approximation of div, falls back to the first kernel of the dtype.
+ */
+typedef enum {
+  KERNEL_PIPELINE_3STAGE = 0,
+  KERNEL_PIPELINE_5STAGE = 1,
+} KernelPipeline;
+
+#define KERNEL_DTYPE_SLOTS 16  // cnnlDataType_t values indexed by the registry
+#define KERNEL_PREFER_SLOTS 3  // cnnlComputationPreference_t values
+#define KERNEL_DEPTH_SLOTS 3   // 3stage kernels of depth 2, 3 and 4
+
+// DType and Prefer tokens of the DECLARE and IMPLE macros.
+#define KERNEL_DTYPE(DType) KERNEL_DTYPE_##DType
+#define KERNEL_DTYPE_float CNNL_DTYPE_FLOAT
+#define KERNEL_DTYPE_half CNNL_DTYPE_HALF
+#define KERNEL_DTYPE_int8_t CNNL_DTYPE_INT8
+#define KERNEL_DTYPE_int16_t CNNL_DTYPE_INT16
+#define KERNEL_DTYPE_int32_t CNNL_DTYPE_INT32
+#define KERNEL_PREFER(Prefer) KERNEL_PREFER_##Prefer
+#define KERNEL_PREFER_Fast CNNL_COMPUTATION_FAST
+#define KERNEL_PREFER_HighAcc CNNL_COMPUTATION_HIGH_PRECISION
+#define KERNEL_PREFER_Approx CNNL_COMPUTATION_APPROX
+
+template <typename Kernel>
+struct KernelEntry {
+  cnnlDataType_t dtype;
+  cnnlComputationPreference_t prefer;
+  KernelPipeline pipeline;
+  LayoutSpec (*layout)(int, int);  // 3stage, picks the pipeline depth; NULL for 5stage
+  Kernel kernels[KERNEL_DEPTH_SLOTS];  // by kernelDepthSlot, 5stage only has the first
+  const char *names[KERNEL_DEPTH_SLOTS];
+};
+
+inline int kernelDepthSlot(int depth) {
+  return depth - PIPELINE_MIN_DEPTH;
+}
+
+/* The 5stage kernels split each SRAM chunk over the CORE_DIM cores of a cluster, every core
+ * taking a whole NRAM: they need clusters of CORE_DIM cores and SRAM for CORE_DIM NRAMs.
+ */
+inline bool isKernelPipelineSupported(cnnlHandle_t handle, KernelPipeline pipeline) {
+  if (pipeline == KERNEL_PIPELINE_3STAGE) {
+    return true;
+  }
+  int64_t nram_used = handle->nram_size - NRAM_RESERVED_SIZE;
+  return handle->core_num_per_cluster == CORE_DIM && nram_used > 0 &&
+         (int64_t)handle->sram_size >= CORE_DIM * nram_used;
+}
+
+template <typename Kernel>
+class KernelRegistry {
+ public:
+  // Pipeline depth of a 3stage entry, pipelineDepth unless the operation plans its own.
+  typedef int (*DepthFunc)(const cnnlHandle_t &,
+                           const cnnlTensorDescriptor_t &,
+                           const cnrtDim3_t &,
+                           LayoutSpec (*)(int, int));
+
+  template <int N>
+  KernelRegistry(const KernelEntry<Kernel> (&entries)[N], DepthFunc depth_func = pipelineDepth)
+      : depth_func_(depth_func) {
+    for (int sram = 0; sram < 2; ++sram) {
+      for (int dtype = 0; dtype < KERNEL_DTYPE_SLOTS; ++dtype) {
+        for (int prefer = 0; prefer < KERNEL_PREFER_SLOTS; ++prefer) {
+          const KernelEntry<Kernel> *exact = NULL, *fallback = NULL;
+          for (int i = N - 1; i >= 0; --i) {
+            const KernelEntry<Kernel> &entry = entries[i];
+            if (entry.dtype != dtype || (entry.pipeline == KERNEL_PIPELINE_5STAGE && !sram)) {
+              continue;
+            }
+            fallback = &entry;
+            exact    = entry.prefer == prefer ? &entry : exact;
+          }
+          index_[sram][dtype][prefer] = exact != NULL ? exact : fallback;
+        }
+      }
+    }
+  }
+
+  // Sets kernel and kernel_name. Returns CNNL_STATUS_BAD_PARAM for a dtype or prefer out of
+  // the table, CNNL_STATUS_ARCH_MISMATCH when no kernel of the dtype runs on handle.
+  cnnlStatus_t select(const cnnlHandle_t &handle,
+              const cnnlTensorDescriptor_t &desc,
+              const cnrtDim3_t &k_dim,
+              cnnlComputationPreference_t prefer,
+              Kernel *kernel,
+              const char **kernel_name) const {
+    if (desc->dtype < 0 || desc->dtype >= KERNEL_DTYPE_SLOTS || prefer < 0 ||
+        prefer >= KERNEL_PREFER_SLOTS) {
+      return CNNL_STATUS_BAD_PARAM;
+    }
+    int sram = isKernelPipelineSupported(handle, KERNEL_PIPELINE_5STAGE) ? 1 : 0;
+    const KernelEntry<Kernel> *entry = index_[sram][desc->dtype][prefer];
+    if (entry == NULL) {
+      return CNNL_STATUS_ARCH_MISMATCH;
+    }
+    int slot = 0;
+    if (entry->pipeline == KERNEL_PIPELINE_3STAGE) {
+      slot = kernelDepthSlot(depth_func_(handle, desc, k_dim, entry->layout));
+    }
+    *kernel      = entry->kernels[slot];
+    *kernel_name = entry->names[slot];
+    return CNNL_STATUS_SUCCESS;
+  }
+
+ private:
+  DepthFunc depth_func_;
+  // first candidate of [5stage supported][dtype][prefer], NULL when none
+  const KernelEntry<Kernel> *index_[2][KERNEL_DTYPE_SLOTS][KERNEL_PREFER_SLOTS];
+};
+
+#endif  // KERNELS_KERNEL_REGISTRY_H_
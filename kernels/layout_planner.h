@@ -0,0 +1,216 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_LAYOUT_PLANNER_H_
+#define KERNELS_LAYOUT_PLANNER_H_
+
+/* Declarative NRAM/SRAM layouts of the pipelined kernels.
+ *
+ * A layout lists the buffers of one kernel variant. The buffers are placed one after
+ * another, each one holds `copies` slots of num_deal elements, then fixed_bytes of
+ * constants follow. The planner picks the largest aligned num_deal that fits the
+ * capacity and derives the offsets, all in elements of the kernel data type T.
+ *
+ * The functions are constexpr and the headers have no device dependency, so the kernels
+ * and the host tests compute the same numbers.
+ */
+#define LAYOUT_MAX_BUFFERS 6
+#define LAYOUT_ALIGN_NUM 64  // elements, UNARY_ALIGN_NUM and BINARY_ALIGN_NUM
+#define LAYOUT_INT_ALIGN_NUM 128  // elements, the int8 and int16 conversions
+// zero, max and 2^23 vectors of LAYOUT_ALIGN_NUM floats, see kernels/integer_math.h
+#define LAYOUT_INT_CONST_BYTES (3 * LAYOUT_ALIGN_NUM * 4)
+
+struct BufferSpec {
+  int bytes;          // bytes per element, sizeof(float) for half data computed in float
+  int copies;         // the pipeline depth for a buffer of the pipeline
+  bool input_at_end;  // the T input is loaded at the end of the slot and widened in place
+};
+
+struct LayoutSpec {
+  int buffer_num;
+  BufferSpec buffers[LAYOUT_MAX_BUFFERS];
+  int fixed_bytes;  // constants after the buffers
+  int align;        // num_deal is a multiple of align
+};
+
+// Elements of T taken by buffers [0, end) per element of num_deal.
+constexpr int layoutUnits(const LayoutSpec &spec, int elem_size, int end) {
+  return end <= 0 ? 0
+                  : layoutUnits(spec, elem_size, end - 1) +
+                        spec.buffers[end - 1].bytes / elem_size * spec.buffers[end - 1].copies;
+}
+
+/* Largest num_deal such that every slot holds num_deal + slack elements.
+ * slack covers a pipeline computing more than num_deal elements on its last chunk.
+ */
+constexpr int planNumDeal(const LayoutSpec &spec, int capacity, int elem_size, int slack = 0) {
+  return ((capacity - spec.fixed_bytes) / elem_size /
+              layoutUnits(spec, elem_size, spec.buffer_num) -
+          slack) /
+         spec.align * spec.align;
+}
+
+// Offset of the first slot of buffer index, the end of the buffers if index is past them.
+constexpr int planOffset(const LayoutSpec &spec, int elem_size, int slot_num, int index) {
+  return layoutUnits(spec, elem_size, index < spec.buffer_num ? index : spec.buffer_num) *
+         slot_num;
+}
+
+// Distance between two slots of buffer index.
+constexpr int planPong(const LayoutSpec &spec, int elem_size, int slot_num, int index) {
+  return spec.buffers[index].bytes / elem_size * slot_num;
+}
+
+// Offset of the T input in the first slot of buffer index.
+constexpr int planInputOffset(const LayoutSpec &spec, int elem_size, int slot_num, int index) {
+  return planOffset(spec, elem_size, slot_num, index) +
+         (spec.buffers[index].input_at_end ? planPong(spec, elem_size, slot_num, index) - slot_num
+                                           : 0);
+}
+
+constexpr int planUsedBytes(const LayoutSpec &spec, int elem_size, int slot_num) {
+  return planOffset(spec, elem_size, slot_num, spec.buffer_num) * elem_size + spec.fixed_bytes;
+}
+
+// SRAM of the 5-stage pipeline, a ping-pong chunk for each core of the cluster.
+constexpr LayoutSpec sramPipelineLayout(int elem_size, int core_dim) {
+  return {1, {{elem_size * core_dim, 2, false}}, 0, LAYOUT_ALIGN_NUM};
+}
+
+/* num_deal of a 5-stage kernel, bounded by its NRAM layout and by the SRAM ping-pong.
+ * The last chunk is split over the cores, a core may compute up to core_dim - 1 elements
+ * more than num_deal rounded up to align, hence the slack.
+ */
+constexpr int planNumDeal5Stage(const LayoutSpec &nram_spec,
+                                int nram_capacity,
+                                int sram_capacity,
+                                int elem_size,
+                                int core_dim) {
+  return planNumDeal(nram_spec, nram_capacity, elem_size, nram_spec.align) <
+                 planNumDeal(sramPipelineLayout(elem_size, core_dim), sram_capacity, elem_size)
+             ? planNumDeal(nram_spec, nram_capacity, elem_size, nram_spec.align)
+             : planNumDeal(sramPipelineLayout(elem_size, core_dim), sram_capacity, elem_size);
+}
+
+// Offsets of the unary pipelines, buffers are x (x_half is its input), aux_a, aux_b.
+struct UnaryLayoutPlan {
+  int num_deal;
+  int num_pong;
+  int offset_x_half;
+  int offset_aux_a;
+  int offset_aux_b;
+};
+
+constexpr UnaryLayoutPlan planUnary(const LayoutSpec &spec,
+                                    int elem_size,
+                                    int num_deal,
+                                    int slot_num) {
+  return {num_deal, planPong(spec, elem_size, slot_num, 0),
+          planInputOffset(spec, elem_size, slot_num, 0), planOffset(spec, elem_size, slot_num, 1),
+          planOffset(spec, elem_size, slot_num, 2)};
+}
+
+constexpr UnaryLayoutPlan planUnary3Stage(const LayoutSpec &spec, int capacity, int elem_size) {
+  return planUnary(spec, elem_size, planNumDeal(spec, capacity, elem_size),
+                   planNumDeal(spec, capacity, elem_size));
+}
+
+constexpr UnaryLayoutPlan planUnary5Stage(const LayoutSpec &spec,
+                                          int nram_capacity,
+                                          int sram_capacity,
+                                          int elem_size,
+                                          int core_dim) {
+  return planUnary(spec, elem_size,
+                   planNumDeal5Stage(spec, nram_capacity, sram_capacity, elem_size, core_dim),
+                   planNumDeal5Stage(spec, nram_capacity, sram_capacity, elem_size, core_dim) +
+                       spec.align);
+}
+
+/* Offsets of the dual output unary pipeline, buffers are x (x_half is its input), the second
+ * output z, aux_a, aux_b. aux_b is the start of the constants when there is a single aux.
+ * block3Unary takes it for the ops of one output too, with pong_z and offset_z 0.
+ */
+struct UnaryDualLayoutPlan {
+  int num_deal;
+  int num_pong;
+  int pong_z;
+  int offset_x_half;
+  int offset_z;
+  int offset_aux_a;
+  int offset_aux_b;
+};
+
+constexpr UnaryDualLayoutPlan planUnaryDual(const LayoutSpec &spec, int elem_size, int num_deal) {
+  return {num_deal,
+          planPong(spec, elem_size, num_deal, 0),
+          planPong(spec, elem_size, num_deal, 1),
+          planInputOffset(spec, elem_size, num_deal, 0),
+          planOffset(spec, elem_size, num_deal, 1),
+          planOffset(spec, elem_size, num_deal, 2),
+          planOffset(spec, elem_size, num_deal, 3)};
+}
+
+constexpr UnaryDualLayoutPlan planUnaryDual3Stage(const LayoutSpec &spec,
+                                                  int capacity,
+                                                  int elem_size) {
+  return planUnaryDual(spec, elem_size, planNumDeal(spec, capacity, elem_size));
+}
+
+/* Offsets of the binary pipeline, buffers are x, y, aux1, aux2, and aux3 is the start of
+ * the constants.
+ */
+struct BinaryLayoutPlan {
+  int nram_limit;
+  int pong_x;
+  int pong_y;
+  int offset_x;
+  int offset_y;
+  int offset_aux1;
+  int offset_aux2;
+  int offset_aux3;
+};
+
+constexpr BinaryLayoutPlan planBinary(const LayoutSpec &spec, int elem_size, int num_deal) {
+  return {num_deal,
+          planPong(spec, elem_size, num_deal, 0),
+          planPong(spec, elem_size, num_deal, 1),
+          planInputOffset(spec, elem_size, num_deal, 0),
+          planInputOffset(spec, elem_size, num_deal, 1),
+          planOffset(spec, elem_size, num_deal, 2),
+          planOffset(spec, elem_size, num_deal, 3),
+          planOffset(spec, elem_size, num_deal, spec.buffer_num)};
+}
+
+constexpr BinaryLayoutPlan planBinary3Stage(const LayoutSpec &spec, int capacity, int elem_size) {
+  return planBinary(spec, elem_size, planNumDeal(spec, capacity, elem_size));
+}
+
+/* Pipeline depth of a 3stage kernel, see kernels/pipeline_schedule.h.
+ * A deeper pipeline splits the same NRAM into smaller chunks and takes more steps to fill
+ * and drain, so depth is only raised while each core still computes at least
+ * LAYOUT_MIN_CHUNKS_PER_BUFFER chunks per buffer. layout(elem_size, depth) is the
+ * layout of the kernel variant.
+ */
+#define LAYOUT_MIN_CHUNKS_PER_BUFFER 4
+
+constexpr int planPipelineDepth(LayoutSpec (*layout)(int, int),
+                                int capacity,
+                                int elem_size,
+                                int num_per_core,
+                                int max_depth) {
+  return max_depth <= 2 ||
+                 num_per_core / LAYOUT_MIN_CHUNKS_PER_BUFFER / max_depth >=
+                     planNumDeal(layout(elem_size, max_depth), capacity, elem_size)
+             ? (max_depth < 2 ? 2 : max_depth)
+             : planPipelineDepth(layout, capacity, elem_size, num_per_core, max_depth - 1);
+}
+
+#endif  // KERNELS_LAYOUT_PLANNER_H_
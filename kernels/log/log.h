@@ -15,14 +15,18 @@
 #include "kernels/unary_op/unary_op_3pipeline.h"
 #include "kernels/unary_op/unary_op_5pipeline.h"
 
-// declare log 3stage pipeline kernel, half:Fast or HighAcc mode, float:Fast mode
+// declare log 3stage pipeline kernel, half:Fast, HighAcc or Approx mode, float:Fast or Approx mode
 UNARY_OP_KERNEL_3PIPELINE_DECLARE(Log, float, Fast);
 UNARY_OP_KERNEL_3PIPELINE_DECLARE(Log, half, Fast);
 UNARY_OP_KERNEL_3PIPELINE_DECLARE(Log, half, HighAcc);
+UNARY_OP_KERNEL_3PIPELINE_DECLARE(Log, float, Approx);
+UNARY_OP_KERNEL_3PIPELINE_DECLARE(Log, half, Approx);
 
-// declare log 5stage pipeline kernel, half:Fast or HighAcc mode, float:Fast mode
+// declare log 5stage pipeline kernel, half:Fast, HighAcc or Approx mode, float:Fast or Approx mode
 UNARY_OP_KERNEL_5PIPELINE_DECLARE(Log, float, Fast);
 UNARY_OP_KERNEL_5PIPELINE_DECLARE(Log, half, Fast);
 UNARY_OP_KERNEL_5PIPELINE_DECLARE(Log, half, HighAcc);
+UNARY_OP_KERNEL_5PIPELINE_DECLARE(Log, float, Approx);
+UNARY_OP_KERNEL_5PIPELINE_DECLARE(Log, half, Approx);
 
 #endif  // KERNELS_LOG_LOG_H_
@@ -0,0 +1,202 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_OPTIMIZER_OP_OPTIMIZER_OP_3PIPELINE_H_
+#define KERNELS_OPTIMIZER_OP_OPTIMIZER_OP_3PIPELINE_H_
+
+#include "kernels/kernel.h"
+#include "kernels/layout_planner.h"
+#include "kernels/pipeline_schedule.h"
+
+/* Fused optimizer updates on the 3stage pipeline, see kernels/pipeline_schedule.h.
+ *
+ * Every tensor of the update is a stream: param, grad, then the states of the optimizer.
+ * Each chunk of every stream is loaded once, updated in NRAM and stored back in place, grad
+ * is only loaded. The first stream_num buffers of the layout are the streams, the others
+ * are aux buffers of one slot, the constants follow. The update always runs in float, half
+ * streams are loaded at the end of their float slots, widened in place and narrowed back with
+ * round to nearest, a rounding down would drift param, m and v over the steps.
+ *
+ * The kernels are built for the depths 2, 3 and 4 with the suffixes of the binary kernels.
+ */
+#define OPTIMIZER_MAX_STREAMS 4
+#define OPTIMIZER_GRAD_STREAM 1  // the only stream that is not stored
+
+// Scalars of the update, the host folds the bias corrections of Adam into lr and eps.
+struct OptimizerCoef {
+  float lr;
+  float beta1;  // Adam beta1
+  float beta2;  // Adam beta2, RMSProp rho
+  float eps;
+};
+
+#define OPTIMIZER_OP_3PIPELINE_DECLARE_DEPTH(Op, DType, Prefer, Suffix)   \
+  __mlu_global__ void MLUKernel3StagePipeline##Op##DType##Prefer##Suffix( \
+      void *param, void *grad, void *state_a, void *state_b, int32_t data_num, OptimizerCoef coef)
+
+#define OPTIMIZER_OP_3PIPELINE_DECLARE(Op, DType, Prefer)          \
+  OPTIMIZER_OP_3PIPELINE_DECLARE_DEPTH(Op, DType, Prefer, );       \
+  OPTIMIZER_OP_3PIPELINE_DECLARE_DEPTH(Op, DType, Prefer, Depth3); \
+  OPTIMIZER_OP_3PIPELINE_DECLARE_DEPTH(Op, DType, Prefer, Depth4)
+
+#define OPTIMIZER_OP_3PIPELINE_IMPLE_DEPTH(Op, DType, Prefer, Depth, Suffix)                      \
+  OPTIMIZER_OP_3PIPELINE_DECLARE_DEPTH(Op, DType, Prefer, Suffix) {                               \
+    OptimizerLayoutPlan plan;                                                                     \
+    get3Offset##Op<DType, Depth>(plan);                                                           \
+    DType *gdram[OPTIMIZER_MAX_STREAMS] = {(DType *)param, (DType *)grad, (DType *)state_a,       \
+                                           (DType *)state_b};                                     \
+    processOptimizerPipe3<DType, compute##Op, Depth>(gdram, (DType *)nram_buffer, plan, data_num, \
+                                                     coef);                                       \
+  }
+
+#define OPTIMIZER_OP_3PIPELINE_IMPLE(Op, DType, Prefer)             \
+  OPTIMIZER_OP_3PIPELINE_IMPLE_DEPTH(Op, DType, Prefer, 2, );       \
+  OPTIMIZER_OP_3PIPELINE_IMPLE_DEPTH(Op, DType, Prefer, 3, Depth3); \
+  OPTIMIZER_OP_3PIPELINE_IMPLE_DEPTH(Op, DType, Prefer, 4, Depth4)
+
+// Host side, registry entry of the kernels of every pipeline depth, see
+// kernels/kernel_registry.h.
+#define OPTIMIZER_OP_3PIPELINE_ENTRY(Op, DType, Prefer, layout) \
+  {KERNEL_DTYPE(DType),                                         \
+   KERNEL_PREFER(Prefer),                                       \
+   KERNEL_PIPELINE_3STAGE,                                      \
+   layout,                                                      \
+   {MLUKernel3StagePipeline##Op##DType##Prefer,                 \
+    MLUKernel3StagePipeline##Op##DType##Prefer##Depth3,         \
+    MLUKernel3StagePipeline##Op##DType##Prefer##Depth4},        \
+   {"MLUKernel3StagePipeline" #Op #DType #Prefer,               \
+    "MLUKernel3StagePipeline" #Op #DType #Prefer "Depth3",      \
+    "MLUKernel3StagePipeline" #Op #DType #Prefer "Depth4"}}
+
+// Offsets in elements of T: slot[i] of buffer i, input[i] of its T input, consts.
+struct OptimizerLayoutPlan {
+  int32_t num_deal;
+  int32_t buffer_num;
+  int32_t stream_num;
+  int32_t slot[LAYOUT_MAX_BUFFERS];
+  int32_t input[LAYOUT_MAX_BUFFERS];
+  int32_t pong[LAYOUT_MAX_BUFFERS];
+  int32_t consts;
+};
+
+__mlu_func__ void planOptimizer3Stage(const LayoutSpec &spec,
+                                      int capacity,
+                                      int elem_size,
+                                      int stream_num,
+                                      OptimizerLayoutPlan &plan) {
+  plan.num_deal   = planNumDeal(spec, capacity, elem_size);
+  plan.buffer_num = spec.buffer_num;
+  plan.stream_num = stream_num;
+  for (int i = 0; i < spec.buffer_num; ++i) {
+    plan.slot[i]  = planOffset(spec, elem_size, plan.num_deal, i);
+    plan.input[i] = planInputOffset(spec, elem_size, plan.num_deal, i);
+    plan.pong[i]  = planPong(spec, elem_size, plan.num_deal, i);
+  }
+  plan.consts = planOffset(spec, elem_size, plan.num_deal, spec.buffer_num);
+}
+
+// The stages of processOptimizerPipe3, chunk c is in buffer c % Depth of every stream.
+template <typename T,
+          void (*OpFunc)(float **, float **, float *, int32_t, const OptimizerCoef &),
+          int Depth>
+struct Optimizer3Stages {
+  T *const *gdram;
+  T *nram_buffer;
+  const OptimizerLayoutPlan *plan;
+  const OptimizerCoef *coef;
+  float *aux[LAYOUT_MAX_BUFFERS];
+  int32_t core_offset;
+  int32_t repeat;
+  int32_t rem;
+
+  __mlu_func__ int32_t num(int32_t chunk) {
+    return chunk < repeat ? plan->num_deal : rem;
+  }
+
+  __mlu_func__ T *nram(int32_t offset, int s, int32_t chunk) {
+    return nram_buffer + offset + (chunk % Depth) * plan->pong[s];
+  }
+
+  __mlu_func__ void store(int32_t chunk) {
+    for (int s = 0; s < plan->stream_num; ++s) {
+      if (s != OPTIMIZER_GRAD_STREAM) {
+        __memcpy_async(gdram[s] + core_offset + chunk * plan->num_deal,
+                       nram(plan->slot[s], s, chunk), num(chunk) * sizeof(T), NRAM2GDRAM);
+      }
+    }
+  }
+
+  __mlu_func__ void load(int32_t chunk) {
+    for (int s = 0; s < plan->stream_num; ++s) {
+      __memcpy_async(nram(plan->input[s], s, chunk),
+                     gdram[s] + core_offset + chunk * plan->num_deal, num(chunk) * sizeof(T),
+                     GDRAM2NRAM);
+    }
+  }
+
+  __mlu_func__ void compute(int32_t chunk) {
+    int32_t deal_num = chunk < repeat ? plan->num_deal : CEIL_ALIGN(rem, LAYOUT_ALIGN_NUM);
+    float *stream[OPTIMIZER_MAX_STREAMS];
+    for (int s = 0; s < plan->stream_num; ++s) {
+      stream[s] = (float *)nram(plan->slot[s], s, chunk);
+      if (sizeof(T) == sizeof(half)) {
+        __bang_half2float(stream[s], (half *)nram(plan->input[s], s, chunk), deal_num);
+      }
+    }
+    OpFunc(stream, aux, (float *)(nram_buffer + plan->consts), deal_num, *coef);
+    if (sizeof(T) == sizeof(half)) {
+      for (int s = 0; s < plan->stream_num; ++s) {
+        if (s != OPTIMIZER_GRAD_STREAM) {
+          __bang_float2half_rn((half *)stream[s], stream[s], deal_num);
+        }
+      }
+    }
+  }
+};
+
+/* OpFunc(stream, aux, consts, deal_num, coef) updates the float streams of a chunk, aux are
+ * the aux buffers of the layout in order.
+ */
+template <typename T,
+          void (*OpFunc)(float **, float **, float *, int32_t, const OptimizerCoef &),
+          int Depth>
+__mlu_func__ void processOptimizerPipe3(T *const *gdram,
+                                        T *nram_buffer,
+                                        const OptimizerLayoutPlan &plan,
+                                        const int32_t data_num,
+                                        const OptimizerCoef &coef) {
+  if (coreId == 0x80) {
+    return;
+  }
+  // split data by cores
+  int32_t num_per_core = data_num / taskDim;
+  int32_t rem_for_all  = data_num % taskDim;
+  int32_t core_offset  = taskId * num_per_core;
+  if (rem_for_all > 0 && taskId == (taskDim - 1)) {
+    num_per_core = num_per_core + rem_for_all;
+  }
+
+  Optimizer3Stages<T, OpFunc, Depth> stages;
+  stages.gdram       = gdram;
+  stages.nram_buffer = nram_buffer;
+  stages.plan        = &plan;
+  stages.coef        = &coef;
+  for (int i = plan.stream_num; i < plan.buffer_num; ++i) {
+    stages.aux[i - plan.stream_num] = (float *)(nram_buffer + plan.slot[i]);
+  }
+  stages.core_offset = core_offset;
+  stages.repeat      = num_per_core / plan.num_deal;
+  stages.rem         = num_per_core % plan.num_deal;
+  // the last chunk holds rem elements
+  pipelineRun<Depth>(stages.repeat + (stages.rem > 0 ? 1 : 0), stages);
+}
+
+#endif  // KERNELS_OPTIMIZER_OP_OPTIMIZER_OP_3PIPELINE_H_
@@ -0,0 +1,40 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_OPTIMIZER_OP_OPTIMIZER_OP_HOST_H_
+#define KERNELS_OPTIMIZER_OP_OPTIMIZER_OP_HOST_H_
+
+#include <string>
+#include "include/cnnl_core.h"
+#include "kernels/layout_planner.h"
+#include "kernels/optimizer_op/optimizer_op_3pipeline.h"
+
+// Launch signature of the optimizer kernels, state_b is NULL for a single state.
+typedef void (*OptimizerKernel)(void *param,
+                                void *grad,
+                                void *state_a,
+                                void *state_b,
+                                int32_t data_num,
+                                OptimizerCoef coef);
+
+/* user param check
+ * step1:check desc and data ptr is not nullptr_t
+ * step2:check all the tensors have the shape and data type of the first one
+ * */
+cnnlStatus_t optimizerOpParamCheck(const std::string &op_name,
+                                   const cnnlHandle_t &handle,
+                                   const cnnlTensorDescriptor_t descs[],
+                                   const void *const ptrs[],
+                                   const int &tensor_num,
+                                   const cnnlDataType_t support_type[],
+                                   const int &len,
+                                   bool &zero_element);
+#endif  //  KERNELS_OPTIMIZER_OP_OPTIMIZER_OP_HOST_H_
@@ -0,0 +1,118 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_PIPELINE_SCHEDULE_H_
+#define KERNELS_PIPELINE_SCHEDULE_H_
+
+/* Schedule of the 3stage load-compute-store pipelines with depth buffers.
+ *
+ * Chunk c lives in buffer c % depth. Each step issues the store, the load and the compute
+ * of different chunks, then syncs:
+ *   step t: store chunk t - 2 - lookahead, load chunk t, compute chunk t - 1 - lookahead.
+ * depth 2 is the ping-pong: the load reuses the buffer being stored in the same step, the
+ * store is issued first. From depth 3 the three chunks of a step are in different buffers,
+ * depth 4 also keeps one loaded chunk waiting, i.e. loads run one more step ahead.
+ * The sync of a step waits for every transfer, there is no wait per buffer, so at any depth
+ * one load is in flight per step and depth 2 already overlaps it with the compute and the
+ * store: 64 chunks take 66 steps at depth 2 and 3, and 67 at depth 4. Deeper buffers only
+ * cost chunk size, the default depth is 2, see cnnl::runtime::getMaxPipelineDepth.
+ *
+ * Shared by the kernels and the host schedule simulator, test/pipeline_sim.cc. The kernels
+ * run it with pipelineRun, the host picks their depth with pipelineDepth.
+ */
+#if defined(__BANG__)
+#include "include/context.h"
+#include "include/logging.h"
+#include "include/runtime/device.h"
+#include "include/tensor.h"
+#include "include/type.h"
+#include "kernels/kernel.h"
+#include "kernels/layout_planner.h"
+#endif  // defined(__BANG__)
+
+#define PIPELINE_MIN_DEPTH 2
+#define PIPELINE_MAX_DEPTH 4
+
+#if defined(__BANG__)
+#define PIPELINE_FUNC __mlu_func__
+#else
+#define PIPELINE_FUNC static inline
+#endif  // defined(__BANG__)
+
+PIPELINE_FUNC int pipelineLookahead(int depth) {
+  return depth > 3 ? depth - 3 : 0;
+}
+
+PIPELINE_FUNC int pipelineStepNum(int chunk_num, int depth) {
+  return chunk_num > 0 ? chunk_num + 2 + pipelineLookahead(depth) : 0;
+}
+
+// Chunk of each stage at step, -1 when the stage is idle.
+PIPELINE_FUNC int pipelineLoadChunk(int step, int chunk_num) {
+  return step < chunk_num ? step : -1;
+}
+
+PIPELINE_FUNC int pipelineComputeChunk(int step, int chunk_num, int depth) {
+  int chunk = step - 1 - pipelineLookahead(depth);
+  return chunk >= 0 && chunk < chunk_num ? chunk : -1;
+}
+
+PIPELINE_FUNC int pipelineStoreChunk(int step, int chunk_num, int depth) {
+  int chunk = step - 2 - pipelineLookahead(depth);
+  return chunk >= 0 && chunk < chunk_num ? chunk : -1;
+}
+
+#if defined(__BANG__)
+/* Runs the schedule of chunk_num chunks on Depth buffers. stages issues the transfers and the
+ * compute of a chunk: stages.store(chunk) under pvLock, stages.load(chunk) and
+ * stages.compute(chunk), see block3Unary for an example.
+ */
+template <int Depth, typename Stages>
+__mlu_func__ void pipelineRun(int chunk_num, Stages &stages) {
+  int step_num = pipelineStepNum(chunk_num, Depth);
+  for (int step = 0; step < step_num; step++) {
+    int store = pipelineStoreChunk(step, chunk_num, Depth);
+    if (store >= 0) {
+      pvLock();
+      stages.store(store);
+      pvUnlock();
+    }
+    int load = pipelineLoadChunk(step, chunk_num);
+    if (load >= 0) {
+      stages.load(load);
+    }
+    int compute = pipelineComputeChunk(step, chunk_num, Depth);
+    if (compute >= 0) {
+      stages.compute(compute);
+    }
+    __asm__ volatile("sync;");
+  }
+}
+
+/* Host side, pipeline depth of a 3stage kernel launched on k_dim, layout is the layout of the
+ * kernel variant. Trades chunk size for depth, up to cnnl::runtime::getMaxPipelineDepth.
+ */
+inline int pipelineDepth(const cnnlHandle_t &handle,
+                         const cnnlTensorDescriptor_t &desc,
+                         const cnrtDim3_t &k_dim,
+                         LayoutSpec (*layout)(int, int)) {
+  size_t task_num = k_dim.x * k_dim.y * k_dim.z;
+  size_t num_per_core = cnnlGetTensorElementNum(desc) / task_num;
+  num_per_core = num_per_core < INT32_MAX ? num_per_core : INT32_MAX;
+  int nram_capacity = cnnl::runtime::getNramSizeInBytes(handle) - NRAM_RESERVED_SIZE;
+  int depth = planPipelineDepth(layout, nram_capacity, getSizeOfDataType(desc->dtype),
+                                num_per_core, cnnl::runtime::getMaxPipelineDepth(handle));
+  VLOG(5) << "3stage pipeline depth " << depth;
+  return depth;
+}
+#endif  // defined(__BANG__)
+
+#endif  // KERNELS_PIPELINE_SCHEDULE_H_
@@ -0,0 +1,52 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_RECIPROCAL_RECIPROCAL_LAYOUT_H_
+#define KERNELS_RECIPROCAL_RECIPROCAL_LAYOUT_H_
+
+#include "kernels/layout_planner.h"
+
+/* 3stage Fast: depth x buffers computed in place, aux_a (scaling, zoom) and aux_b
+ * (aux2, aux4) of the range scaling, see kernels/div/div_scaling.h. half only scales the
+ * sign and uses aux_a.
+ */
+constexpr LayoutSpec reciprocal3FastLayout(int elem_size, int depth) {
+  return elem_size == (int)sizeof(float)
+             ? LayoutSpec{3,
+                          {{elem_size, depth, false},
+                           {2 * elem_size, 1, false},
+                           {2 * elem_size, 1, false}},
+                          0,
+                          LAYOUT_ALIGN_NUM}
+             : LayoutSpec{2, {{elem_size, depth, false}, {elem_size, 1, false}}, 0,
+                          LAYOUT_ALIGN_NUM};
+}
+
+// 3stage HighAcc, half only: the input is widened to float in place, aux as float Fast.
+constexpr LayoutSpec reciprocal3HighAccLayout(int elem_size, int depth) {
+  return {3,
+          {{(int)sizeof(float), depth, true},
+           {2 * (int)sizeof(float), 1, false},
+           {2 * (int)sizeof(float), 1, false}},
+          0,
+          LAYOUT_ALIGN_NUM};
+}
+
+// 5stage, a single x buffer.
+constexpr LayoutSpec reciprocal5FastLayout(int elem_size) {
+  return reciprocal3FastLayout(elem_size, 1);
+}
+
+constexpr LayoutSpec reciprocal5HighAccLayout(int elem_size) {
+  return reciprocal3HighAccLayout(elem_size, 1);
+}
+
+#endif  // KERNELS_RECIPROCAL_RECIPROCAL_LAYOUT_H_
@@ -0,0 +1,25 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_REDUCE_REDUCE_H_
+#define KERNELS_REDUCE_REDUCE_H_
+
+#include "kernels/reduce/reduce_pipeline.h"
+
+// declare the last dim reduction kernels, half is always accumulated in float
+REDUCE_KERNEL_DECLARE(ReduceSum, float, Fast);
+REDUCE_KERNEL_DECLARE(ReduceSum, half, HighAcc);
+REDUCE_KERNEL_DECLARE(ReduceMax, float, Fast);
+REDUCE_KERNEL_DECLARE(ReduceMax, half, HighAcc);
+REDUCE_KERNEL_DECLARE(LogSumExp, float, Fast);
+REDUCE_KERNEL_DECLARE(LogSumExp, half, HighAcc);
+
+#endif  // KERNELS_REDUCE_REDUCE_H_
@@ -0,0 +1,76 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_REDUCE_REDUCE_LAYOUT_H_
+#define KERNELS_REDUCE_REDUCE_LAYOUT_H_
+
+#include "kernels/layout_planner.h"
+#include "kernels/reduce/reduce_partial.h"
+
+#define REDUCE_MAX_CORE_DIM 16  // partials of the cores of a cluster
+#define REDUCE_RESULT_NUM LAYOUT_ALIGN_NUM  // results staged in NRAM before a store
+// scratch of the scalar exp and log - partials of a row - staged results
+#define REDUCE_SCRATCH_BYTES (LAYOUT_ALIGN_NUM * (int)sizeof(float))
+#define REDUCE_PARTIAL_BYTES (REDUCE_MAX_CORE_DIM * (int)sizeof(ReducePartial))
+#define REDUCE_CONST_BYTES \
+  (REDUCE_SCRATCH_BYTES + REDUCE_PARTIAL_BYTES + REDUCE_RESULT_NUM * (int)sizeof(float))
+
+// sum and max: depth x buffers, half is widened to float in place.
+constexpr LayoutSpec reduce3Layout(int elem_size, int depth) {
+  return LayoutSpec{1,
+                    {{(int)sizeof(float), depth, elem_size != (int)sizeof(float)}},
+                    REDUCE_CONST_BYTES,
+                    LAYOUT_ALIGN_NUM};
+}
+
+// logsumexp: as reduce3Layout, aux keeps the chunk while its max is folded.
+constexpr LayoutSpec logSumExp3Layout(int elem_size, int depth) {
+  return LayoutSpec{2,
+                    {{(int)sizeof(float), depth, elem_size != (int)sizeof(float)},
+                     {(int)sizeof(float), 1, false}},
+                    REDUCE_CONST_BYTES,
+                    LAYOUT_ALIGN_NUM};
+}
+
+/* Offsets of the reductions in elements of T: the distance between the two slots of x, the
+ * T input of the first slot, aux and the start of the constants.
+ */
+struct ReduceLayoutPlan {
+  int num_deal;
+  int pong;
+  int offset_x;
+  int offset_aux;
+  int offset_const;
+};
+
+constexpr ReduceLayoutPlan planReduce(const LayoutSpec &spec,
+                                      int elem_size,
+                                      int num_deal) {
+  return {num_deal, planPong(spec, elem_size, num_deal, 0),
+          planInputOffset(spec, elem_size, num_deal, 0), planOffset(spec, elem_size, num_deal, 1),
+          planOffset(spec, elem_size, num_deal, spec.buffer_num)};
+}
+
+constexpr ReduceLayoutPlan planReduce3Stage(const LayoutSpec &spec, int capacity, int elem_size) {
+  return planReduce(spec, elem_size, planNumDeal(spec, capacity, elem_size));
+}
+
+/* Rows of a packed chunk of short rows, 0 when the rows are too long to pack. The rows are
+ * loaded CEIL_ALIGN(col_num) apart into the first half of an x slot and transposed into the
+ * second half, a multiple of LAYOUT_ALIGN_NUM rows is reduced at once.
+ */
+constexpr int reducePackRowNum(int col_num, int num_deal) {
+  return num_deal / 2 /
+         ((col_num + LAYOUT_ALIGN_NUM - 1) / LAYOUT_ALIGN_NUM * LAYOUT_ALIGN_NUM) /
+         LAYOUT_ALIGN_NUM * LAYOUT_ALIGN_NUM;
+}
+
+#endif  // KERNELS_REDUCE_REDUCE_LAYOUT_H_
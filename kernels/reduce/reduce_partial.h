@@ -0,0 +1,95 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_REDUCE_REDUCE_PARTIAL_H_
+#define KERNELS_REDUCE_REDUCE_PARTIAL_H_
+
+#include <stdint.h>
+
+/* Partition and partial results of the last dim reductions.
+ *
+ * Short rows are split over every core, each core reduces its rows alone. Long rows, or
+ * fewer rows than cores, are split over the clusters and the cores of a cluster cooperate
+ * on each row: every core reduces a part of the columns into a ReducePartial, the partials
+ * meet in SRAM and core 0 combines them in core order.
+ *
+ * A part is reduced chunk by chunk, the partial of each chunk is combined in the same way,
+ * so the combination is also what the device does within a core.
+ *
+ * Shared by the kernels and the host model, test/reduce_sim.cc.
+ */
+#define REDUCE_COOPERATIVE_MIN_NUM 1024  // columns per core from which the cores cooperate
+
+#if defined(__BANG__)
+#define REDUCE_FUNC __mlu_func__
+#else
+#define REDUCE_FUNC static inline
+#endif  // defined(__BANG__)
+
+/* Sum or max of a part in value. For logsumexp value is the max and sum_exp the sum of
+ * exp(x - max). num is the elements of the part, 0 for an empty part.
+ */
+struct ReducePartial {
+  float value;
+  float sum_exp;
+  int32_t num;
+};
+
+// First of num_total items split in part_num balanced parts.
+REDUCE_FUNC int32_t reducePartBegin(int32_t num_total, int32_t part_num, int32_t part_idx) {
+  int32_t rem = num_total % part_num;
+  return part_idx * (num_total / part_num) + (part_idx < rem ? part_idx : rem);
+}
+
+REDUCE_FUNC int32_t reducePartNum(int32_t num_total, int32_t part_num, int32_t part_idx) {
+  return num_total / part_num + (part_idx < num_total % part_num ? 1 : 0);
+}
+
+REDUCE_FUNC bool reduceCooperative(int32_t row_num, int32_t col_num, int32_t core_dim,
+                                   int32_t task_dim) {
+  return row_num < task_dim || col_num / core_dim >= REDUCE_COOPERATIVE_MIN_NUM;
+}
+
+REDUCE_FUNC void mergeSum(ReducePartial &acc, const ReducePartial &part) {
+  acc.value += part.value;
+  acc.num += part.num;
+}
+
+REDUCE_FUNC void mergeMax(ReducePartial &acc, const ReducePartial &part) {
+  if (part.num > 0 && (acc.num == 0 || part.value > acc.value)) {
+    acc.value = part.value;
+  }
+  acc.num += part.num;
+}
+
+// exp of it scales the sum of the smaller max in mergeLogSumExp, never positive.
+REDUCE_FUNC float logSumExpScaleArg(const ReducePartial &acc, const ReducePartial &part) {
+  return acc.value > part.value ? part.value - acc.value : acc.value - part.value;
+}
+
+REDUCE_FUNC void mergeLogSumExp(ReducePartial &acc, const ReducePartial &part, float scale) {
+  if (part.num == 0) {
+    return;
+  }
+  if (acc.num == 0) {
+    acc = part;
+    return;
+  }
+  if (part.value > acc.value) {
+    acc.sum_exp = acc.sum_exp * scale + part.sum_exp;
+    acc.value   = part.value;
+  } else {
+    acc.sum_exp += part.sum_exp * scale;
+  }
+  acc.num += part.num;
+}
+
+#endif  // KERNELS_REDUCE_REDUCE_PARTIAL_H_
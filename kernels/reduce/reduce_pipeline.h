@@ -0,0 +1,252 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_REDUCE_REDUCE_PIPELINE_H_
+#define KERNELS_REDUCE_REDUCE_PIPELINE_H_
+
+#include "kernels/kernel.h"
+#include "kernels/pipeline_schedule.h"
+#include "kernels/reduce/reduce_layout.h"
+#include "kernels/reduce/reduce_partial.h"
+
+/* Last dim reductions of a [row_num, col_num] tensor into row_num results.
+ *
+ * A core loads its rows, or its part of the columns of each row, in chunks of num_deal
+ * elements through a ping-pong: the next chunk is loaded while the current one is
+ * reduced, across rows too. See kernels/reduce/reduce_partial.h for the partition.
+ *
+ * Short rows of a core that reduces whole rows are packed: a chunk holds reducePackRowNum rows,
+ * is transposed to [col_num, rows] and folded along the columns, so every row of the chunk
+ * is reduced by the same vector instructions and a step stores all their results.
+ */
+#define REDUCE_KERNEL_DECLARE(Op, DType, Prefer)                       \
+  __mlu_global__ void MLUBlockKernel3StagePipeline##Op##DType##Prefer( \
+      void *x, void *y, int32_t row_num, int32_t col_num);
+
+// Host side, registry entry of the kernel, see kernels/kernel_registry.h.
+#define REDUCE_KERNEL_ENTRY(Op, DType, Prefer, layout) \
+  {KERNEL_DTYPE(DType),                                \
+   KERNEL_PREFER(Prefer),                              \
+   KERNEL_PIPELINE_3STAGE,                             \
+   layout,                                             \
+   {MLUBlockKernel3StagePipeline##Op##DType##Prefer},  \
+   {"MLUBlockKernel3StagePipeline" #Op #DType #Prefer}}
+
+#define REDUCE_KERNEL_IMPLE(Op, DType, Prefer)                                                \
+  __mlu_global__ void MLUBlockKernel3StagePipeline##Op##DType##Prefer(                        \
+      void *x, void *y, int32_t row_num, int32_t col_num) {                                   \
+    ReduceLayoutPlan plan;                                                                    \
+    get3Offset##Op<DType>(plan);                                                              \
+    blockReduce<DType, chunk##Op, combine##Op, result##Op, pack##Op>(                         \
+        (DType *)x, (DType *)y, row_num, col_num, nram_buffer, sram_buffer, plan);            \
+  }
+
+// Partial of the num elements of a chunk, x holds num_align floats.
+typedef void (*ReduceChunkFunc)(float *x,
+                                float *aux,
+                                float *scratch,
+                                int32_t num,
+                                int32_t num_align,
+                                ReducePartial &part);
+typedef void (*ReduceCombineFunc)(ReducePartial &acc, const ReducePartial &part, float *scratch);
+typedef float (*ReduceResultFunc)(const ReducePartial &acc, float *scratch);
+// Results of the row_align rows of a transposed packed chunk, x is [col_num, row_align] and is
+// overwritten, the result of row i goes to result[i].
+typedef void (*ReducePackFunc)(float *x,
+                               float *aux,
+                               int32_t col_num,
+                               int32_t row_align,
+                               float *result);
+
+// Elements of chunk of a part of col_count columns taken in chunk_per_row chunks.
+__mlu_func__ int32_t reduceChunkNum(int32_t chunk,
+                                    int32_t chunk_per_row,
+                                    int32_t col_count,
+                                    int32_t num_deal) {
+  int32_t rest = col_count - (chunk % chunk_per_row) * num_deal;
+  return rest < num_deal ? rest : num_deal;
+}
+
+// Loads rows of col_num elements from row, col_align apart, into slot of the x ping-pong.
+template <typename T>
+__mlu_func__ void reduceLoadRows(T *x,
+                                 int32_t row,
+                                 int32_t rows,
+                                 int32_t col_num,
+                                 int32_t col_align,
+                                 int32_t slot,
+                                 char *nram_buffer,
+                                 const ReduceLayoutPlan &plan) {
+  __memcpy_async((T *)nram_buffer + plan.offset_x + slot * plan.pong,
+                 x + (int64_t)row * col_num, col_num * sizeof(T), GDRAM2NRAM,
+                 col_align * sizeof(T), col_num * sizeof(T), rows - 1);
+}
+
+/* The row_count rows from row_begin, pack_row_num rows a chunk through the ping-pong. A half
+ * chunk is widened into the first half of its slot, below its input, and transposed into the
+ * second half.
+ */
+template <typename T, ReducePackFunc PackFunc>
+__mlu_func__ void blockReducePacked(T *x,
+                                    T *y,
+                                    int32_t row_begin,
+                                    int32_t row_count,
+                                    int32_t col_num,
+                                    int32_t pack_row_num,
+                                    char *nram_buffer,
+                                    const ReduceLayoutPlan &plan) {
+  int32_t col_align   = CEIL_ALIGN(col_num, LAYOUT_ALIGN_NUM);
+  int32_t chunk_total = (row_count + pack_row_num - 1) / pack_row_num;
+  float *aux          = (float *)((T *)nram_buffer + plan.offset_aux);
+  if (chunk_total > 0) {
+    reduceLoadRows(x, row_begin, row_count < pack_row_num ? row_count : pack_row_num, col_num,
+                   col_align, 0, nram_buffer, plan);
+  }
+  for (int32_t chunk = 0; chunk < chunk_total; ++chunk) {
+    __asm__ volatile("sync;\n\t");
+    int32_t next = chunk + 1;
+    if (next < chunk_total) {
+      int32_t rest = row_count - next * pack_row_num;
+      reduceLoadRows(x, row_begin + next * pack_row_num, rest < pack_row_num ? rest : pack_row_num,
+                     col_num, col_align, next % 2, nram_buffer, plan);
+    }
+    int32_t rest   = row_count - chunk * pack_row_num;
+    int32_t rows   = rest < pack_row_num ? rest : pack_row_num;
+    float *nram_x  = (float *)((T *)nram_buffer + (chunk % 2) * plan.pong);
+    float *nram_xt = nram_x + plan.num_deal / 2;
+    if (sizeof(T) != sizeof(float)) {
+      __bang_half2float(nram_x, (half *)nram_buffer + plan.offset_x + (chunk % 2) * plan.pong,
+                        pack_row_num * col_align);
+    }
+    // the rows past rows and the columns past col_num are not folded into a result
+    __bang_transpose(nram_xt, nram_x, pack_row_num, col_align);
+    PackFunc(nram_xt, aux, col_num, pack_row_num, nram_x);
+    if (sizeof(T) != sizeof(float)) {
+      __bang_float2half_rd((half *)nram_x, nram_x, pack_row_num);
+    }
+    __memcpy(y + row_begin + chunk * pack_row_num, nram_x, rows * sizeof(T), NRAM2GDRAM);
+  }
+}
+
+template <typename T,
+          ReduceChunkFunc ChunkFunc,
+          ReduceCombineFunc CombineFunc,
+          ReduceResultFunc ResultFunc,
+          ReducePackFunc PackFunc>
+__mlu_func__ void blockReduce(T *x,
+                              T *y,
+                              int32_t row_num,
+                              int32_t col_num,
+                              char *nram_buffer,
+                              char *sram_buffer,
+                              const ReduceLayoutPlan &plan) {
+  int32_t cluster_num = taskDimY * clusterDim;
+  int32_t cluster_idx = taskIdY * clusterDim + clusterId;
+  bool cooperative    = reduceCooperative(row_num, col_num, coreDim, taskDim);
+  int32_t row_begin   = cooperative ? reducePartBegin(row_num, cluster_num, cluster_idx)
+                                    : reducePartBegin(row_num, taskDim, taskId);
+  int32_t row_count   = cooperative ? reducePartNum(row_num, cluster_num, cluster_idx)
+                                    : reducePartNum(row_num, taskDim, taskId);
+  if (coreId == 0x80) {
+    // the memory core has no columns, it only meets the cores of its cluster once a row
+    for (int32_t row = 0; cooperative && row < row_count; ++row) {
+      __sync_cluster();
+    }
+    return;
+  }
+  int32_t col_begin   = cooperative ? reducePartBegin(col_num, coreDim, coreId) : 0;
+  int32_t col_count   = cooperative ? reducePartNum(col_num, coreDim, coreId) : col_num;
+  int32_t num_deal    = plan.num_deal;
+
+  // short rows of a core of its own are reduced a packed chunk at a time
+  int32_t pack_row_num = cooperative ? 0 : reducePackRowNum(col_num, num_deal);
+  if (pack_row_num > 0) {
+    blockReducePacked<T, PackFunc>(x, y, row_begin, row_count, col_num, pack_row_num,
+                                   nram_buffer, plan);
+    return;
+  }
+
+  float *aux              = (float *)((T *)nram_buffer + plan.offset_aux);
+  float *scratch          = (float *)((T *)nram_buffer + plan.offset_const);
+  ReducePartial *partials = (ReducePartial *)((char *)scratch + REDUCE_SCRATCH_BYTES);
+  T *results              = (T *)((char *)partials + REDUCE_PARTIAL_BYTES);
+  // partials of the even and the odd rows, core 0 reads a row before the next one is written
+  ReducePartial *sram_partials = (ReducePartial *)sram_buffer;
+
+  // a core without columns still takes a step per row to meet the others in SRAM
+  int32_t chunk_per_row = col_count > 0 ? (col_count + num_deal - 1) / num_deal : 1;
+  int32_t chunk_total   = row_count * chunk_per_row;
+  int32_t staged        = 0;
+  int32_t staged_row    = row_begin;
+  ReducePartial acc;
+  if (chunk_total > 0 && col_count > 0) {
+    __memcpy_async((T *)nram_buffer + plan.offset_x, x + (int64_t)row_begin * col_num + col_begin,
+                   reduceChunkNum(0, chunk_per_row, col_count, num_deal) * sizeof(T),
+                   GDRAM2NRAM);
+  }
+  for (int32_t chunk = 0; chunk < chunk_total; ++chunk) {
+    __asm__ volatile("sync;\n\t");
+    int32_t next = chunk + 1;
+    if (next < chunk_total && col_count > 0) {
+      int32_t next_row = row_begin + next / chunk_per_row;
+      __memcpy_async((T *)nram_buffer + plan.offset_x + (next % 2) * plan.pong,
+                     x + (int64_t)next_row * col_num + col_begin +
+                         (next % chunk_per_row) * num_deal,
+                     reduceChunkNum(next, chunk_per_row, col_count, num_deal) * sizeof(T),
+                     GDRAM2NRAM);
+    }
+    if (chunk % chunk_per_row == 0) {
+      acc.value   = 0;
+      acc.sum_exp = 0;
+      acc.num     = 0;
+    }
+    if (col_count > 0) {
+      int32_t num       = reduceChunkNum(chunk, chunk_per_row, col_count, num_deal);
+      int32_t num_align = CEIL_ALIGN(num, LAYOUT_ALIGN_NUM);
+      float *nram_x     = (float *)((T *)nram_buffer + (chunk % 2) * plan.pong);
+      if (sizeof(T) != sizeof(float)) {
+        __bang_half2float(nram_x, (half *)nram_buffer + plan.offset_x + (chunk % 2) * plan.pong,
+                          num_align);
+      }
+      ReducePartial part;
+      ChunkFunc(nram_x, aux, scratch, num, num_align, part);
+      CombineFunc(acc, part, scratch);
+    }
+    if (chunk % chunk_per_row != chunk_per_row - 1) {
+      continue;
+    }
+
+    // the row is done
+    int32_t row = chunk / chunk_per_row;
+    if (cooperative) {
+      ReducePartial *sram_row = sram_partials + (row % 2) * REDUCE_MAX_CORE_DIM;
+      partials[0] = acc;
+      __memcpy(sram_row + coreId, partials, sizeof(ReducePartial), NRAM2SRAM);
+      __sync_cluster();
+      if (coreId != 0) {
+        continue;
+      }
+      __memcpy(partials, sram_row, coreDim * sizeof(ReducePartial), SRAM2NRAM);
+      acc = partials[0];
+      for (int32_t i = 1; i < coreDim; ++i) {
+        CombineFunc(acc, partials[i], scratch);
+      }
+    }
+    results[staged++] = (T)ResultFunc(acc, scratch);
+    if (staged == REDUCE_RESULT_NUM || row == row_count - 1) {
+      __memcpy(y + staged_row, results, staged * sizeof(T), NRAM2GDRAM);
+      staged_row += staged;
+      staged = 0;
+    }
+  }
+}
+
+#endif  // KERNELS_REDUCE_REDUCE_PIPELINE_H_
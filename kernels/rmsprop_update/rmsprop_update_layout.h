@@ -0,0 +1,36 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_RMSPROP_UPDATE_RMSPROP_UPDATE_LAYOUT_H_
+#define KERNELS_RMSPROP_UPDATE_RMSPROP_UPDATE_LAYOUT_H_
+
+#include "kernels/div/div_layout.h"
+#include "kernels/layout_planner.h"
+
+#define RMSPROP_UPDATE_STREAM_NUM 3  // param, grad, ms
+
+/* depth buffers of each stream - the divisor - aux1 (scaling, zoom) - aux2 (aux2, aux4) -
+ * constants of the reciprocal, see kernels/div/div_scaling.h. grad is still needed once the
+ * divisor is computed, so unlike Adam the divisor has a buffer of its own.
+ */
+constexpr LayoutSpec rmspropUpdate3Layout(int elem_size, int depth) {
+  return LayoutSpec{6,
+                    {{(int)sizeof(float), depth, elem_size != (int)sizeof(float)},
+                     {(int)sizeof(float), depth, elem_size != (int)sizeof(float)},
+                     {(int)sizeof(float), depth, elem_size != (int)sizeof(float)},
+                     {(int)sizeof(float), 1, false},
+                     {2 * (int)sizeof(float), 1, false},
+                     {2 * (int)sizeof(float), 1, false}},
+                    DIV_CONST_BYTES,
+                    LAYOUT_ALIGN_NUM};
+}
+
+#endif  // KERNELS_RMSPROP_UPDATE_RMSPROP_UPDATE_LAYOUT_H_
@@ -0,0 +1,57 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_SQRT_SQRT_LAYOUT_H_
+#define KERNELS_SQRT_SQRT_LAYOUT_H_
+
+#include "kernels/approx_math.h"
+#include "kernels/layout_planner.h"
+
+// 3stage HighAcc, half only: depth x buffers, the input is widened to float in place.
+constexpr LayoutSpec sqrt3HighAccLayout(int elem_size, int depth) {
+  return {1, {{(int)sizeof(float), depth, true}}, 0, LAYOUT_ALIGN_NUM};
+}
+
+// 3stage Fast: depth x buffers, x is computed in place.
+// float uses aux_a and aux_b to expand the input range.
+constexpr LayoutSpec sqrt3FastLayout(int elem_size, int depth) {
+  return elem_size == (int)sizeof(float)
+             ? LayoutSpec{3,
+                          {{elem_size, depth, false}, {elem_size, 1, false}, {elem_size, 1, false}},
+                          0,
+                          LAYOUT_ALIGN_NUM}
+             : LayoutSpec{1, {{elem_size, depth, false}}, 0, LAYOUT_ALIGN_NUM};
+}
+
+// 5stage HighAcc, half only: the input is widened to float in place.
+constexpr LayoutSpec sqrt5HighAccLayout(int elem_size) {
+  return {1, {{(int)sizeof(float), 1, true}}, 0, LAYOUT_ALIGN_NUM};
+}
+
+// 5stage Fast: x computed in place, float uses aux_a and aux_b.
+constexpr LayoutSpec sqrt5FastLayout(int elem_size) {
+  return elem_size == (int)sizeof(float)
+             ? LayoutSpec{3, {{elem_size, 1, false}, {elem_size, 1, false}, {elem_size, 1, false}},
+                          0, LAYOUT_ALIGN_NUM}
+             : LayoutSpec{1, {{elem_size, 1, false}}, 0, LAYOUT_ALIGN_NUM};
+}
+
+// 3stage Approx: depth x buffers, then the sub-chunk scratch of kernels/approx_math.h.
+constexpr LayoutSpec sqrt3ApproxLayout(int elem_size, int depth) {
+  return {1, {{elem_size, depth, false}}, APPROX_SCRATCH_BYTES, LAYOUT_ALIGN_NUM};
+}
+
+// 5stage Approx: x computed in place by sub-chunks.
+constexpr LayoutSpec sqrt5ApproxLayout(int elem_size) {
+  return {1, {{elem_size, 1, false}}, APPROX_SCRATCH_BYTES, LAYOUT_ALIGN_NUM};
+}
+
+#endif  // KERNELS_SQRT_SQRT_LAYOUT_H_
@@ -0,0 +1,27 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_SQRT_BACKWARD_SQRT_BACKWARD_LAYOUT_H_
+#define KERNELS_SQRT_BACKWARD_SQRT_BACKWARD_LAYOUT_H_
+
+#include "kernels/layout_planner.h"
+
+// 3stage Fast, float only: depth y buffers, then depth dy buffers.
+constexpr LayoutSpec sqrtBackward3FastLayout(int elem_size, int depth) {
+  return {2, {{elem_size, depth, false}, {elem_size, depth, false}}, 0, LAYOUT_ALIGN_NUM};
+}
+
+// 3stage HighAcc, half only: y is widened to float in place.
+constexpr LayoutSpec sqrtBackward3HighAccLayout(int elem_size, int depth) {
+  return {2, {{(int)sizeof(float), depth, true}, {elem_size, depth, false}}, 0, LAYOUT_ALIGN_NUM};
+}
+
+#endif  // KERNELS_SQRT_BACKWARD_SQRT_BACKWARD_LAYOUT_H_
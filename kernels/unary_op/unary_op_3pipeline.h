@@ -13,110 +13,148 @@
 #define KERNELS_UNARY_OP_UNARY_OP_3PIPELINE_H_
 
 #include "kernels/kernel.h"
+#include "kernels/layout_planner.h"
+#include "kernels/pipeline_schedule.h"
 #define UNARY_ALIGN_NUM 64
 
-#define UNARY_OP_KERNEL_3PIPELINE_DECLARE(Op, DType, Prefer)           \
-  __mlu_global__ void MLUBlockKernel3StagePipeline##Op##DType##Prefer( \
+/* The 3stage kernels are built for every pipeline depth, see kernels/pipeline_schedule.h.
+ * Depth 2 keeps the kernel name, depth 3 and 4 add a Depth3 or Depth4 suffix.
+ */
+#define UNARY_OP_KERNEL_3PIPELINE_DECLARE_DEPTH(Op, DType, Prefer, Suffix)     \
+  __mlu_global__ void MLUBlockKernel3StagePipeline##Op##DType##Prefer##Suffix( \
       void *x, void *y, uint32_t num_total, float coef);
 
-#define UNARY_OP_KERNEL_3PIPELINE_IMPLE(Op, DType, Prefer)                                      \
-  __mlu_global__ void MLUBlockKernel3StagePipeline##Op##DType##Prefer(                          \
-      void *x, void *y, uint32_t num_total, float coef) {                                       \
-    int32_t num_deal = 0, num_pong = 0;                                                         \
-    int32_t offset_half = 0, offset_aux_a = 0, offset_aux_b = 0;                                \
-    get3Offset##Op##Prefer<DType>(offset_half, offset_aux_a, offset_aux_b, num_deal, num_pong); \
-    block3Unary<DType, compute##Op##Prefer>((DType *)x, (DType *)y, nram_buffer, num_total,     \
-                                            offset_half, offset_aux_a, offset_aux_b, num_deal,  \
-                                            num_pong, coef);                                    \
-  }
+#define UNARY_OP_KERNEL_3PIPELINE_DECLARE(Op, DType, Prefer)         \
+  UNARY_OP_KERNEL_3PIPELINE_DECLARE_DEPTH(Op, DType, Prefer, )       \
+  UNARY_OP_KERNEL_3PIPELINE_DECLARE_DEPTH(Op, DType, Prefer, Depth3) \
+  UNARY_OP_KERNEL_3PIPELINE_DECLARE_DEPTH(Op, DType, Prefer, Depth4)
 
-template <typename T, void (*OpFunc)(T *, T *, T *, T *, int, int, float)>
-__mlu_func__ void block3Unary(T *x,
-                              T *y,
-                              char *nram_buffer,
-                              int32_t num_total,
-                              int32_t offset_x_half,
-                              int32_t offset_aux_a,
-                              int32_t offset_aux_b,
-                              int32_t num_deal,
-                              int32_t num_pong,
-                              float coef) {
-  int32_t num_per_core = num_total / taskDim;
-  int32_t num_rem      = num_total % taskDim;
-  T *addr_x            = (T *)x + taskId * num_per_core;
-  T *addr_y            = (T *)y + taskId * num_per_core;
-  if (num_rem > 0 && taskId == taskDim - 1) {
-    num_per_core = num_per_core + num_rem;
+#define UNARY_OP_KERNEL_3PIPELINE_IMPLE_DEPTH(Op, DType, Prefer, Depth, Suffix)             \
+  __mlu_global__ void MLUBlockKernel3StagePipeline##Op##DType##Prefer##Suffix(              \
+      void *x, void *y, uint32_t num_total, float coef) {                                   \
+    int32_t num_deal = 0, num_pong = 0;                                                     \
+    int32_t offset_half = 0, offset_aux_a = 0, offset_aux_b = 0;                            \
+    get3Offset##Op##Prefer<DType, Depth>(offset_half, offset_aux_a, offset_aux_b, num_deal, \
+                                         num_pong);                                         \
+    UnaryDualLayoutPlan plan = {num_deal,    num_pong,     0,           offset_half,        \
+                                0,           offset_aux_a, offset_aux_b};                   \
+    block3Unary<DType, DType, unaryOneOutput<DType, compute##Op##Prefer>, Depth>(           \
+        (DType *)x, (DType *)y, (DType *)NULL, nram_buffer, num_total, plan, coef);         \
   }
-  int32_t repeat    = num_per_core / num_deal;
-  int32_t rem       = num_per_core % num_deal;
-  int32_t align_rem = CEIL_ALIGN(rem, UNARY_ALIGN_NUM);
 
-  T *nram_x                = (T *)nram_buffer;
-  T *nram_x_half           = (T *)nram_buffer + offset_x_half;
-  T *nram_aux_a            = (T *)nram_buffer + offset_aux_a;
-  T *nram_aux_b            = (T *)nram_buffer + offset_aux_b;
-  int32_t span_handle_size = num_deal * sizeof(T);
+#define UNARY_OP_KERNEL_3PIPELINE_IMPLE(Op, DType, Prefer)            \
+  UNARY_OP_KERNEL_3PIPELINE_IMPLE_DEPTH(Op, DType, Prefer, 2, )       \
+  UNARY_OP_KERNEL_3PIPELINE_IMPLE_DEPTH(Op, DType, Prefer, 3, Depth3) \
+  UNARY_OP_KERNEL_3PIPELINE_IMPLE_DEPTH(Op, DType, Prefer, 4, Depth4)
 
-  // 3 level pipeline.
-  if (repeat > 0) {
-    __memcpy_async(nram_x_half, addr_x, span_handle_size, GDRAM2NRAM);
-    __asm__ volatile("sync;");
-  }
-
-  if (repeat > 1) {
-    __memcpy_async(nram_x_half + num_pong, addr_x + num_deal, span_handle_size, GDRAM2NRAM);
-    OpFunc(nram_x, nram_x_half, nram_aux_a, nram_aux_b, num_deal, num_deal, coef);
-    __asm__ volatile("sync;");
-  }
+// Host side, registry entry of the kernels of every pipeline depth, see
+// kernels/kernel_registry.h.
+#define UNARY_OP_KERNEL_3PIPELINE_ENTRY(Op, DType, Prefer, layout) \
+  {KERNEL_DTYPE(DType),                                            \
+   KERNEL_PREFER(Prefer),                                          \
+   KERNEL_PIPELINE_3STAGE,                                         \
+   layout,                                                         \
+   {MLUBlockKernel3StagePipeline##Op##DType##Prefer,               \
+    MLUBlockKernel3StagePipeline##Op##DType##Prefer##Depth3,       \
+    MLUBlockKernel3StagePipeline##Op##DType##Prefer##Depth4},      \
+   {"MLUBlockKernel3StagePipeline" #Op #DType #Prefer,             \
+    "MLUBlockKernel3StagePipeline" #Op #DType #Prefer "Depth3",    \
+    "MLUBlockKernel3StagePipeline" #Op #DType #Prefer "Depth4"}}
 
-  for (int i = 0; i < repeat - 2; i++) {
-    pvLock();
-    __memcpy_async(addr_y + i * num_deal, nram_x + (i % 2) * num_pong, span_handle_size,
-                   NRAM2GDRAM);
-    pvUnlock();
+// The OpFunc of block3Unary for an op of one output, z is not used.
+template <typename T, void (*OpFunc)(T *, T *, T *, T *, int, int, float)>
+__mlu_func__ void unaryOneOutput(T *y,
+                                 T *x_half,
+                                 T *z,
+                                 T *aux_a,
+                                 T *aux_b,
+                                 int deal_num,
+                                 int actual_num,
+                                 float coef) {
+  OpFunc(y, x_half, aux_a, aux_b, deal_num, actual_num, coef);
+}
 
-    __memcpy_async(nram_x_half + (i % 2) * num_pong, addr_x + (i + 2) * num_deal, span_handle_size,
-                   GDRAM2NRAM);
-    OpFunc(nram_x + ((i + 1) % 2) * num_pong, nram_x_half + ((i + 1) % 2) * num_pong, nram_aux_a,
-           nram_aux_b, num_deal, num_deal, coef);
-    __asm__ volatile("sync;");
-  }
+// The stages of block3Unary, chunk c is in buffer c % Depth of x and of z.
+template <typename T,
+          typename TZ,
+          void (*OpFunc)(T *, T *, TZ *, T *, T *, int, int, float),
+          int Depth>
+struct Unary3Stages {
+  T *x;
+  T *y;
+  TZ *z;
+  T *nram_x;
+  T *nram_x_half;
+  T *nram_z;
+  T *nram_aux_a;
+  T *nram_aux_b;
+  UnaryDualLayoutPlan plan;
+  int32_t repeat;
+  int32_t rem;
+  float coef;
 
-  if (repeat > 1) {
-    pvLock();
-    __memcpy_async(addr_y + (repeat - 2) * num_deal, nram_x + ((repeat - 2) % 2) * num_pong,
-                   span_handle_size, NRAM2GDRAM);
-    pvUnlock();
+  __mlu_func__ int32_t num(int32_t chunk) {
+    return chunk < repeat ? plan.num_deal : rem;
   }
 
-  if (rem > 0) {
-    __memcpy_async(nram_x_half + (repeat % 2) * num_pong, addr_x + repeat * num_deal,
-                   rem * sizeof(T), GDRAM2NRAM);
+  __mlu_func__ void store(int32_t chunk) {
+    __memcpy_async(y + chunk * plan.num_deal, nram_x + (chunk % Depth) * plan.num_pong,
+                   num(chunk) * sizeof(T), NRAM2GDRAM);
+    if (z != NULL) {
+      __memcpy_async(z + chunk * plan.num_deal, (TZ *)(nram_z + (chunk % Depth) * plan.pong_z),
+                     num(chunk) * sizeof(TZ), NRAM2GDRAM);
+    }
   }
 
-  if (repeat > 0) {
-    OpFunc(nram_x + ((repeat - 1) % 2) * num_pong, nram_x_half + ((repeat - 1) % 2) * num_pong,
-           nram_aux_a, nram_aux_b, num_deal, num_deal, coef);
+  __mlu_func__ void load(int32_t chunk) {
+    __memcpy_async(nram_x_half + (chunk % Depth) * plan.num_pong, x + chunk * plan.num_deal,
+                   num(chunk) * sizeof(T), GDRAM2NRAM);
   }
-  __asm__ volatile("sync;");
 
-  if (repeat > 0) {
-    pvLock();
-    __memcpy_async(addr_y + (repeat - 1) * num_deal, nram_x + ((repeat - 1) % 2) * num_pong,
-                   span_handle_size, NRAM2GDRAM);
-    pvUnlock();
+  __mlu_func__ void compute(int32_t chunk) {
+    OpFunc(nram_x + (chunk % Depth) * plan.num_pong,
+           nram_x_half + (chunk % Depth) * plan.num_pong,
+           (TZ *)(nram_z + (chunk % Depth) * plan.pong_z), nram_aux_a, nram_aux_b,
+           chunk < repeat ? plan.num_deal : CEIL_ALIGN(rem, UNARY_ALIGN_NUM), num(chunk), coef);
   }
+};
 
-  if (rem > 0) {
-    OpFunc(nram_x + (repeat % 2) * num_pong, nram_x_half + (repeat % 2) * num_pong, nram_aux_a,
-           nram_aux_b, align_rem, rem, coef);
-    __asm__ volatile("sync;");
-
-    pvLock();
-    __memcpy_async(addr_y + repeat * num_deal, nram_x + (repeat % 2) * num_pong, rem * sizeof(T),
-                   NRAM2GDRAM);
-    pvUnlock();
+/* y = op(x) on the 3stage pipeline, with an optional second output z of type TZ, NULL when
+ * the op has none. OpFunc(y, x_half, z, aux_a, aux_b, deal_num, actual_num, coef) computes a
+ * chunk: y in the x buffer from the x_half buffer, and z in its own buffer, the slot of the
+ * chunk. An op of one output is wrapped by unaryOneOutput and its plan has no z.
+ */
+template <typename T,
+          typename TZ,
+          void (*OpFunc)(T *, T *, TZ *, T *, T *, int, int, float),
+          int Depth>
+__mlu_func__ void block3Unary(T *x,
+                              T *y,
+                              TZ *z,
+                              char *nram_buffer,
+                              int32_t num_total,
+                              const UnaryDualLayoutPlan &plan,
+                              float coef) {
+  int32_t num_per_core = num_total / taskDim;
+  int32_t num_rem      = num_total % taskDim;
+  int32_t core_offset  = taskId * num_per_core;
+  if (num_rem > 0 && taskId == taskDim - 1) {
+    num_per_core = num_per_core + num_rem;
   }
+  Unary3Stages<T, TZ, OpFunc, Depth> stages;
+  stages.x           = x + core_offset;
+  stages.y           = y + core_offset;
+  stages.z           = z != NULL ? z + core_offset : NULL;
+  stages.nram_x      = (T *)nram_buffer;
+  stages.nram_x_half = (T *)nram_buffer + plan.offset_x_half;
+  stages.nram_z      = (T *)nram_buffer + plan.offset_z;
+  stages.nram_aux_a  = (T *)nram_buffer + plan.offset_aux_a;
+  stages.nram_aux_b  = (T *)nram_buffer + plan.offset_aux_b;
+  stages.plan        = plan;
+  stages.repeat      = num_per_core / plan.num_deal;
+  stages.rem         = num_per_core % plan.num_deal;
+  stages.coef        = coef;
+  // the last chunk holds rem elements
+  pipelineRun<Depth>(stages.repeat + (stages.rem > 0 ? 1 : 0), stages);
 }
 #endif  // KERNELS_UNARY_OP_UNARY_OP_3PIPELINE_H_
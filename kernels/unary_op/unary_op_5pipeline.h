@@ -13,12 +13,22 @@
 #define KERNELS_UNARY_OP_UNARY_OP_5PIPELINE_H_
 
 #include "kernels/kernel.h"
+#include "kernels/union_partition.h"
 #define UNARY_ALIGN_NUM 64
 
 #define UNARY_OP_KERNEL_5PIPELINE_DECLARE(Op, DType, Prefer)           \
   __mlu_global__ void MLUBlockKernel5StagePipeline##Op##DType##Prefer( \
       void *x, void *y, uint32_t num_total, float coef);
 
+// Host side, registry entry of the kernel, see kernels/kernel_registry.h.
+#define UNARY_OP_KERNEL_5PIPELINE_ENTRY(Op, DType, Prefer) \
+  {KERNEL_DTYPE(DType),                                    \
+   KERNEL_PREFER(Prefer),                                  \
+   KERNEL_PIPELINE_5STAGE,                                 \
+   NULL,                                                   \
+   {MLUBlockKernel5StagePipeline##Op##DType##Prefer},      \
+   {"MLUBlockKernel5StagePipeline" #Op #DType #Prefer}}
+
 #define UNARY_OP_KERNEL_5PIPELINE_IMPLE(Op, DType, Prefer)                                      \
   __mlu_global__ void MLUBlockKernel5StagePipeline##Op##DType##Prefer(                          \
       void *x, void *y, uint32_t num_total, float coef) {                                       \
@@ -57,15 +67,13 @@ __mlu_func__ void block5Unary(T *x,
                               int32_t offset_aux_b,
                               int32_t num_deal,
                               float coef) {
-  // split data_num by clusters
-  int32_t num_per_cluster = num_total / taskDimY;
-  int32_t remain_cluster  = num_total % taskDimY;
+  // split data_num by the clusters of every union, see kernels/union_partition.h
+  int32_t cluster_num     = taskDimY * clusterDim;
+  int32_t cluster_idx     = taskIdY * clusterDim + clusterId;
+  int32_t num_per_cluster = partitionNum(num_total, cluster_num, cluster_idx);
   // ddr ram space
-  T *addr_x = (T *)x + taskIdY * num_per_cluster;
-  T *addr_y = (T *)y + taskIdY * num_per_cluster;
-  if (remain_cluster > 0 && taskIdY == taskDimY - 1) {
-    num_per_cluster += remain_cluster;
-  }
+  T *addr_x = (T *)x + partitionBegin(num_total, cluster_num, cluster_idx);
+  T *addr_y = (T *)y + partitionBegin(num_total, cluster_num, cluster_idx);
 
   // onchip ran space
   T *sram_x      = (T *)sram_buffer;
@@ -78,13 +86,9 @@ __mlu_func__ void block5Unary(T *x,
   int32_t repeat   = num_per_cluster / num_pong;
   int32_t rem      = num_per_cluster % num_pong;
 
-  // split rem num by cores
-  int32_t rem_per_core    = rem / coreDim;
-  int32_t remain_core     = rem % coreDim;
-  int32_t rem_core_offset = taskIdX * rem_per_core;
-  if (remain_core > 0 && coreId == coreDim - 1) {
-    rem_per_core += remain_core;
-  }
+  // split rem num by the cores of the cluster
+  int32_t rem_per_core    = partitionNum(rem, coreDim, coreId);
+  int32_t rem_core_offset = partitionBegin(rem, coreDim, coreId);
   int32_t align_rem_per_core = CEIL_ALIGN(rem_per_core, UNARY_ALIGN_NUM);
   int32_t span_hanld_size    = num_pong * sizeof(T);
 
@@ -0,0 +1,68 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_UNARY_OP_UNARY_OP_DUAL_3PIPELINE_H_
+#define KERNELS_UNARY_OP_UNARY_OP_DUAL_3PIPELINE_H_
+
+#include "kernels/kernel.h"
+#include "kernels/pipeline_schedule.h"
+#include "kernels/unary_op/unary_op_3pipeline.h"
+
+/* Unary operations with two outputs on the 3stage pipeline, see kernels/pipeline_schedule.h.
+ *
+ * The kernels run block3Unary with its second output z: each chunk of x is loaded once, the op
+ * writes y in the x buffer and z in its own buffer, both are stored in the same step. z is of
+ * type ZType: Same stores it in the data type of x, Int8 as int8_t from the start of its slot.
+ *
+ * The kernels are built for the depths 2, 3 and 4 with the suffixes of the unary kernels.
+ */
+#define UNARY_DUAL_Z_TYPE(DType, ZType) UNARY_DUAL_Z_TYPE_##ZType(DType)
+#define UNARY_DUAL_Z_TYPE_Same(DType) DType
+#define UNARY_DUAL_Z_TYPE_Int8(DType) int8_t
+
+#define UNARY_DUAL_OP_KERNEL_3PIPELINE_DECLARE_DEPTH(Op, DType, ZType, Prefer, Suffix) \
+  __mlu_global__ void MLUBlockKernel3StagePipeline##Op##DType##ZType##Prefer##Suffix(  \
+      void *x, void *y, void *z, uint32_t num_total, float coef)
+
+#define UNARY_DUAL_OP_KERNEL_3PIPELINE_DECLARE(Op, DType, ZType, Prefer)          \
+  UNARY_DUAL_OP_KERNEL_3PIPELINE_DECLARE_DEPTH(Op, DType, ZType, Prefer, );       \
+  UNARY_DUAL_OP_KERNEL_3PIPELINE_DECLARE_DEPTH(Op, DType, ZType, Prefer, Depth3); \
+  UNARY_DUAL_OP_KERNEL_3PIPELINE_DECLARE_DEPTH(Op, DType, ZType, Prefer, Depth4)
+
+#define UNARY_DUAL_OP_KERNEL_3PIPELINE_IMPLE_DEPTH(Op, DType, ZType, Prefer, Depth, Suffix) \
+  UNARY_DUAL_OP_KERNEL_3PIPELINE_DECLARE_DEPTH(Op, DType, ZType, Prefer, Suffix) {          \
+    UnaryDualLayoutPlan plan;                                                               \
+    get3Offset##Op##Prefer<DType, Depth>(plan);                                             \
+    block3Unary<DType, UNARY_DUAL_Z_TYPE(DType, ZType), compute##Op##Prefer, Depth>(        \
+        (DType *)x, (DType *)y, (UNARY_DUAL_Z_TYPE(DType, ZType) *)z, nram_buffer,          \
+        num_total, plan, coef);                                                             \
+  }
+
+#define UNARY_DUAL_OP_KERNEL_3PIPELINE_IMPLE(Op, DType, ZType, Prefer)             \
+  UNARY_DUAL_OP_KERNEL_3PIPELINE_IMPLE_DEPTH(Op, DType, ZType, Prefer, 2, );       \
+  UNARY_DUAL_OP_KERNEL_3PIPELINE_IMPLE_DEPTH(Op, DType, ZType, Prefer, 3, Depth3); \
+  UNARY_DUAL_OP_KERNEL_3PIPELINE_IMPLE_DEPTH(Op, DType, ZType, Prefer, 4, Depth4)
+
+// Host side, registry entry of the kernels of every pipeline depth, see
+// kernels/kernel_registry.h.
+#define UNARY_DUAL_OP_KERNEL_3PIPELINE_ENTRY(Op, DType, ZType, Prefer, layout) \
+  {KERNEL_DTYPE(DType),                                                        \
+   KERNEL_PREFER(Prefer),                                                      \
+   KERNEL_PIPELINE_3STAGE,                                                     \
+   layout,                                                                     \
+   {MLUBlockKernel3StagePipeline##Op##DType##ZType##Prefer,                    \
+    MLUBlockKernel3StagePipeline##Op##DType##ZType##Prefer##Depth3,            \
+    MLUBlockKernel3StagePipeline##Op##DType##ZType##Prefer##Depth4},           \
+   {"MLUBlockKernel3StagePipeline" #Op #DType #ZType #Prefer,                  \
+    "MLUBlockKernel3StagePipeline" #Op #DType #ZType #Prefer "Depth3",         \
+    "MLUBlockKernel3StagePipeline" #Op #DType #ZType #Prefer "Depth4"}}
+
+#endif  // KERNELS_UNARY_OP_UNARY_OP_DUAL_3PIPELINE_H_
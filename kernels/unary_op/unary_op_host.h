@@ -13,6 +13,13 @@
 #define KERNELS_UNARY_OP_UNARY_OP_HOST_H_
 #include <string>
 #include "include/cnnl_core.h"
+#include "kernels/layout_planner.h"
+
+// Launch signature of the unary kernels, coef is the scale of the result where the op has one.
+typedef void (*UnaryKernel)(void *x, void *y, uint32_t num_total, float coef);
+
+// Launch signature of the unary kernels with a second output z.
+typedef void (*UnaryDualKernel)(void *x, void *y, void *z, uint32_t num_total, float coef);
 
 void unaryOpPolicyFunc(const cnnlHandle_t &handle,
                        const cnnlTensorDescriptor_t &desc,
@@ -0,0 +1,65 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef KERNELS_UNION_PARTITION_H_
+#define KERNELS_UNION_PARTITION_H_
+
+#include <stdint.h>
+
+/* Partition of the elementwise tensors over the clusters of UNION1, UNION2 and UNION4 jobs.
+ *
+ * A UNIONn task spans n clusters, so a launch of k_dim.y tasks runs on k_dim.y * n
+ * clusters. Cluster taskIdY * clusterDim + clusterId takes a contiguous part of the tensor,
+ * the last cluster also takes the remainder. The 5stage kernels split each SRAM chunk of a
+ * cluster over its cores in the same way, see kernels/unary_op/unary_op_5pipeline.h.
+ *
+ * A union reserves all of its clusters at once, so the policies only widen it for tensors
+ * that keep every cluster busy for several SRAM chunks, see partitionUnionWidth.
+ *
+ * Shared by the kernels and the host partition model, test/union_partition_sim.cc.
+ */
+#define PARTITION_UNION2_MIN_BYTES (4 * 1024 * 1024)   // bytes per cluster for UNION2
+#define PARTITION_UNION4_MIN_BYTES (16 * 1024 * 1024)  // bytes per cluster for UNION4
+
+#if defined(__BANG__)
+#define PARTITION_FUNC __mlu_func__
+#else
+#define PARTITION_FUNC static inline
+#endif  // defined(__BANG__)
+
+// First element of part part_idx of num_total elements split in part_num parts.
+PARTITION_FUNC int32_t partitionBegin(int32_t num_total, int32_t part_num, int32_t part_idx) {
+  return part_idx * (num_total / part_num);
+}
+
+// Elements of part part_idx, the last part takes the remainder.
+PARTITION_FUNC int32_t partitionNum(int32_t num_total, int32_t part_num, int32_t part_idx) {
+  return num_total / part_num + (part_idx == part_num - 1 ? num_total % part_num : 0);
+}
+
+/* Union width of a job on cluster_num clusters that all get a part of tensor_bytes: 4 or 2
+ * when cluster_num is a multiple of it and every cluster gets enough bytes, else 1.
+ */
+PARTITION_FUNC int partitionUnionWidth(int64_t tensor_bytes, int cluster_num) {
+  if (cluster_num <= 0) {
+    return 1;
+  }
+  int64_t cluster_bytes = tensor_bytes / cluster_num;
+  if (cluster_num % 4 == 0 && cluster_bytes >= PARTITION_UNION4_MIN_BYTES) {
+    return 4;
+  }
+  if (cluster_num % 2 == 0 && cluster_bytes >= PARTITION_UNION2_MIN_BYTES) {
+    return 2;
+  }
+  return 1;
+}
+
+#endif  // KERNELS_UNION_PARTITION_H_
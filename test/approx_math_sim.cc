@@ -0,0 +1,180 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Runs the polynomial log and sqrt of kernels/approx_math.h on the host, on every positive
+// half, on floats sampled over the normal range plus every float of [0.5, 2) and on every
+// subnormal float, checks the max error in ulp against a double reference and the bounds of
+// the header, and checks zero, negative, inf and nan inputs against the IEEE results.
+// usage: ./approx_math_sim
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <vector>
+#include "kernels/approx_math.h"
+
+enum SimOp { SIM_LOG_E = 0, SIM_LOG_2 = 1, SIM_LOG_10 = 2, SIM_SQRT = 3 };
+static const char *op_names[] = {"log", "log2", "log10", "sqrt"};
+
+static int failed_num = 0;
+
+static float bitsToFloat(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+static float halfToFloat(uint16_t bits) {
+  int exponent = (bits >> 10) & 0x1f;
+  float value  = exponent == 0 ? ldexpf((float)(bits & 0x3ff), -24)
+                              : ldexpf((float)((bits & 0x3ff) | 0x400), exponent - 25);
+  return bits & 0x8000 ? -value : value;
+}
+
+// float to the half below or equal, __bang_float2half_rd of the HighAcc kernels.
+static float roundDownToHalf(float value) {
+  int exponent = 0;
+  frexpf(value, &exponent);
+  double ulp = ldexp(1.0, (exponent - 1 > -14 ? exponent - 1 : -14) - 10);
+  return (float)(floor(value / ulp) * ulp);
+}
+
+// Spacing of the result type at the exact value, the smallest one below the normal range.
+static double ulpOf(double exact, bool is_half) {
+  int exponent = 0;
+  frexp(exact, &exponent);
+  int min_exponent = is_half ? -14 : -126;
+  int mantissa     = is_half ? 10 : 23;
+  return ldexp(1.0, (exponent - 1 > min_exponent ? exponent - 1 : min_exponent) - mantissa);
+}
+
+static double reference(SimOp op, double x) {
+  switch (op) {
+    case SIM_LOG_E: return log(x);
+    case SIM_LOG_2: return log2(x);
+    case SIM_LOG_10: return log10(x);
+    default: return sqrt(x);
+  }
+}
+
+// The base factors of kernels/log/log.mlu.
+static float coefOf(SimOp op) {
+  return op == SIM_LOG_2 ? (float)log2(exp(1)) : (op == SIM_LOG_10 ? (float)log10(exp(1)) : 1.0f);
+}
+
+// Computes x in place by sub-chunks, as the Approx kernels of kernels/log and kernels/sqrt.
+static void compute(SimOp op, std::vector<float> &x) {
+  std::vector<float> scratch(APPROX_SCRATCH_BYTES / sizeof(float));
+  float *t1     = scratch.data() + APPROX_SUB_NUM;
+  float *t2     = t1 + APPROX_SUB_NUM;
+  float *t3     = t2 + APPROX_SUB_NUM;
+  float *t4     = t3 + APPROX_SUB_NUM;
+  float *t5     = t4 + APPROX_SUB_NUM;
+  int32_t *mask = (int32_t *)(t5 + APPROX_SUB_NUM);
+  float *consts = t5 + 2 * APPROX_SUB_NUM;
+  approxSetConsts(mask, consts);
+  for (size_t i = 0; i < x.size(); i += APPROX_SUB_NUM) {
+    int32_t num = x.size() - i < APPROX_SUB_NUM ? x.size() - i : APPROX_SUB_NUM;
+    if (op == SIM_SQRT) {
+      approxSqrt(x.data() + i, t1, t2, t3, t4, t5, mask, consts, num);
+    } else {
+      approxLog(x.data() + i, t1, t2, t3, t4, t5, mask, consts, num, coefOf(op));
+    }
+  }
+}
+
+static void check(SimOp op, const std::vector<float> &inputs, bool is_half, const char *set,
+                  double bound) {
+  std::vector<float> y = inputs;
+  compute(op, y);
+  double max_ulp = 0, sum_ulp = 0;
+  float worst    = 0;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    float result = is_half ? roundDownToHalf(y[i]) : y[i];
+    double exact = reference(op, inputs[i]);
+    double ulp   = fabs(result - exact) / ulpOf(exact, is_half);
+    sum_ulp += ulp;
+    if (!(ulp <= max_ulp)) {
+      max_ulp = ulp;
+      worst   = inputs[i];
+    }
+  }
+  bool passed = max_ulp <= bound;
+  printf("%s %-5s %-6s %9zu inputs: max %.3f ulp at %.9g, mean %.4f ulp, bound %.1f\n",
+         passed ? "PASS" : "FAIL", op_names[op], set, inputs.size(), max_ulp, worst,
+         sum_ulp / inputs.size(), bound);
+  failed_num += passed ? 0 : 1;
+}
+
+// The inputs out of the polynomial range give the result of libm, bit for bit up to the nan
+// payload, a nan for a nan.
+static void checkSpecial(SimOp op) {
+  const float inf           = bitsToFloat(0x7f800000u);
+  std::vector<float> inputs = {0.0f,  -0.0f, -1.0f, -bitsToFloat(1), -3.40282347e+38f, -inf,
+                               inf,   bitsToFloat(0x7fc00000u),      bitsToFloat(0xffc00001u),
+                               1.0f,  bitsToFloat(1),                bitsToFloat(0x007fffffu)};
+  std::vector<float> y = inputs;
+  compute(op, y);
+  int wrong_num = 0;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    float exact  = (float)reference(op, inputs[i]);
+    bool matched = isnan(exact) ? isnan(y[i]) != 0
+                                : (y[i] == exact && signbit(y[i]) == signbit(exact)) ||
+                                      (isfinite(exact) && exact != 0 &&
+                                       fabs(y[i] - exact) <= 4 * ulpOf(exact, false));
+    if (!matched) {
+      printf("  %s(%g) = %g, expected %g\n", op_names[op], inputs[i], y[i], exact);
+      wrong_num++;
+    }
+  }
+  printf("%s %-5s %-6s %9zu inputs: zero, negative, inf, nan and the subnormal ends\n",
+         wrong_num == 0 ? "PASS" : "FAIL", op_names[op], "special", inputs.size());
+  failed_num += wrong_num == 0 ? 0 : 1;
+}
+
+int main() {
+  // every positive finite half, and zero for sqrt
+  std::vector<float> halves, halves_zero(1, 0.0f);
+  for (uint32_t bits = 1; bits < 0x7c00; ++bits) {
+    halves.push_back(halfToFloat(bits));
+  }
+  halves_zero.insert(halves_zero.end(), halves.begin(), halves.end());
+
+  // normal floats sampled by their bits, and every float of [0.5, 2) around log(1) = 0
+  std::vector<float> floats;
+  std::mt19937 gen(2021);
+  std::uniform_int_distribution<uint32_t> dist(0x00800000u, 0x7f7fffffu);
+  for (int i = 0; i < (1 << 24); ++i) {
+    floats.push_back(bitsToFloat(dist(gen)));
+  }
+  for (uint32_t bits = 0x3f000000u; bits < 0x40000000u; ++bits) {
+    floats.push_back(bitsToFloat(bits));
+  }
+
+  // every positive subnormal float
+  std::vector<float> subnormals;
+  for (uint32_t bits = 1; bits < 0x00800000u; ++bits) {
+    subnormals.push_back(bitsToFloat(bits));
+  }
+
+  for (int op = SIM_LOG_E; op <= SIM_LOG_10; ++op) {
+    check((SimOp)op, halves, true, "half", APPROX_LOG_MAX_ULP_HALF);
+    check((SimOp)op, floats, false, "float", APPROX_LOG_MAX_ULP_FLOAT);
+    check((SimOp)op, subnormals, false, "subnml", APPROX_LOG_MAX_ULP_FLOAT);
+    checkSpecial((SimOp)op);
+  }
+  check(SIM_SQRT, halves_zero, true, "half", APPROX_SQRT_MAX_ULP_HALF);
+  check(SIM_SQRT, floats, false, "float", APPROX_SQRT_MAX_ULP_FLOAT);
+  check(SIM_SQRT, subnormals, false, "subnml", APPROX_SQRT_MAX_ULP_FLOAT);
+  checkSpecial(SIM_SQRT);
+  return failed_num == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,103 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Compares the benchmark json of test_example --json against a stored baseline.
+// usage: ./bench_compare --baseline=base.json --candidate=cand.json [--alpha=0.01]
+//                        [--threshold=0.05] [--min_samples=5]
+// The results of the same op, dtype, shape and prefer are tested with the Mann-Whitney U test
+// on their samples, a significant change of the median over threshold is a regression or an
+// improvement, a change of the kernel variant is noted. Every key is listed, the exit status
+// is non-zero when any regressed or is only in one of the files.
+#include <stdlib.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_stats.h"
+
+static void usage(const char *name) {
+  std::cerr << "usage: " << name
+            << " --baseline=base.json --candidate=cand.json [--alpha=0.01] [--threshold=0.05]"
+               " [--min_samples=5]\n";
+  exit(EXIT_FAILURE);
+}
+
+static void readResults(const std::string &path, std::vector<BenchResult> &results) {
+  std::ifstream in(path.c_str());
+  std::string error;
+  if (!in) {
+    std::cerr << "can not open " << path << "\n";
+    exit(EXIT_FAILURE);
+  }
+  if (!readBenchJson(in, results, error)) {
+    std::cerr << path << ": " << error << "\n";
+    exit(EXIT_FAILURE);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  std::string base_path, cand_path;
+  CompareParam param;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    std::string value = arg.substr(arg.find('=') + 1);
+    if (arg.compare(0, 11, "--baseline=") == 0) {
+      base_path = value;
+    } else if (arg.compare(0, 12, "--candidate=") == 0) {
+      cand_path = value;
+    } else if (arg.compare(0, 8, "--alpha=") == 0) {
+      param.alpha = atof(value.c_str());
+    } else if (arg.compare(0, 12, "--threshold=") == 0) {
+      param.threshold = atof(value.c_str());
+    } else if (arg.compare(0, 14, "--min_samples=") == 0) {
+      param.min_samples = atoi(value.c_str());
+    } else {
+      std::cerr << "unsupported param:" << arg << "\n";
+      usage(argv[0]);
+    }
+  }
+  if (base_path.empty() || cand_path.empty() || param.alpha <= 0 || param.threshold < 0) {
+    usage(argv[0]);
+  }
+
+  std::vector<BenchResult> base, cand;
+  readResults(base_path, base);
+  readResults(cand_path, cand);
+  std::vector<CompareEntry> entries = compareBench(base, cand, param);
+
+  int regressed = 0, improved = 0, unmatched = 0;
+  std::cout << std::fixed << std::setprecision(3);
+  for (auto &entry : entries) {
+    regressed += entry.status == COMPARE_REGRESSION;
+    improved += entry.status == COMPARE_IMPROVEMENT;
+    unmatched += entry.status == COMPARE_ONLY_BASE || entry.status == COMPARE_ONLY_CAND;
+    std::cout << "[" << compareStatusStr(entry.status) << "] " << entry.key;
+    if (entry.status != COMPARE_ONLY_BASE && entry.status != COMPARE_ONLY_CAND) {
+      std::cout << " base " << entry.base_median << " us, cand " << entry.cand_median
+                << " us, change " << std::showpos << entry.change * 100 << std::noshowpos
+                << "%";
+    }
+    if (entry.status != COMPARE_ONLY_BASE && entry.status != COMPARE_ONLY_CAND &&
+        entry.status != COMPARE_FEW_SAMPLES) {
+      std::cout << ", p " << std::setprecision(4) << entry.p_value << std::setprecision(3);
+    }
+    if (entry.status != COMPARE_ONLY_BASE && entry.status != COMPARE_ONLY_CAND &&
+        entry.base_variant != entry.cand_variant) {
+      std::cout << ", note: variant " << entry.base_variant << " -> " << entry.cand_variant;
+    }
+    std::cout << "\n";
+  }
+  std::cout << entries.size() << " results, " << regressed << " regressions, " << improved
+            << " improvements, " << unmatched << " unmatched (alpha " << param.alpha
+            << ", threshold " << param.threshold * 100 << "%)\n";
+  return regressed == 0 && unmatched == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,174 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Checks the benchmark json and the statistics of bench_compare on the host.
+// usage: ./bench_compare_test
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench_stats.h"
+
+static int failed_num = 0;
+
+#define EXPECT(cond)                                       \
+  if (!(cond)) {                                           \
+    printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+    failed_num++;                                          \
+  }
+
+static bool near(double a, double b, double tolerance) {
+  return fabs(a - b) <= tolerance;
+}
+
+static BenchResult makeResult(const std::string &op, const std::vector<double> &samples) {
+  BenchResult result;
+  result.op         = op;
+  result.dtype      = "half";
+  result.shape      = {64, 4096};
+  result.prefer     = "fast";
+  result.variant    = "MLUKernel";
+  result.warmup     = 2;
+  result.bytes      = 1048576;
+  result.samples_us = samples;
+  return result;
+}
+
+// n samples of a sawtooth around center, deterministic noise of +-spread
+static std::vector<double> noisy(double center, double spread, int n) {
+  std::vector<double> samples;
+  for (int i = 0; i < n; ++i) {
+    samples.push_back(center + spread * ((i * 7 % 11) / 5.0 - 1));
+  }
+  return samples;
+}
+
+static void testSummary() {
+  std::vector<double> samples = {5, 1, 4, 2, 3};
+  EXPECT(latencyPercentile(samples, 50) == 3);
+  EXPECT(latencyPercentile(samples, 0) == 1);
+  EXPECT(latencyPercentile(samples, 100) == 5);
+  EXPECT(latencyPercentile(std::vector<double>(), 50) == 0);
+  LatencySummary summary = summarizeLatency(samples);
+  EXPECT(summary.min_us == 1 && summary.median_us == 3 && summary.mean_us == 3);
+  EXPECT(bandwidthGBps(2000, 1) == 2 && bandwidthGBps(2000, 0) == 0);
+}
+
+static void testJson() {
+  std::vector<BenchResult> written = {makeResult("cnnlLog", {10.5, 11.25, 9.75}),
+                                      makeResult("cnnl\"Abs\"", {})};
+  written[1].shape = {8};
+  std::stringstream json;
+  writeBenchJson(json, written);
+
+  std::vector<BenchResult> read;
+  std::string error;
+  EXPECT(readBenchJson(json, read, error));
+  EXPECT(read.size() == 2);
+  if (read.size() == 2) {
+    EXPECT(benchKey(read[0]) == "cnnlLog half {64-4096} fast");
+    EXPECT(benchKey(read[1]) == "cnnl\"Abs\" half {8} fast");
+    EXPECT(read[0].samples_us == written[0].samples_us);
+    EXPECT(read[0].prefer == "fast" && read[0].warmup == 2 && read[0].bytes == 1048576);
+    EXPECT(read[1].samples_us.empty());
+  }
+
+  std::stringstream truncated("{\"benchmark\": [{\"op\": \"cnnlLog\"");
+  read.clear();
+  EXPECT(!readBenchJson(truncated, read, error) && !error.empty());
+  std::stringstream missing("{\"benchmark\": [{\"op\": \"cnnlLog\", \"dtype\": \"half\"}]}");
+  EXPECT(!readBenchJson(missing, read, error));
+  std::stringstream other("{\"results\": []}");
+  EXPECT(!readBenchJson(other, read, error) && error == "no benchmark array");
+}
+
+static void testMannWhitney() {
+  // every a is below every b: U = 0, the exact p is 2 / C(6, 3)
+  MannWhitneyResult result = mannWhitneyU({1, 2, 3}, {4, 5, 6});
+  EXPECT(result.exact && result.u == 0 && near(result.p_value, 0.1, 1e-12));
+  result = mannWhitneyU({4, 5, 6}, {1, 2, 3});
+  EXPECT(result.u == 9 && near(result.p_value, 0.1, 1e-12));
+
+  // interleaved samples, U = 3 of 9, P(U <= 3) = 7 / 20
+  result = mannWhitneyU({1, 3, 5}, {2, 4, 6});
+  EXPECT(result.exact && result.u == 3 && near(result.p_value, 0.7, 1e-12));
+
+  // 8 against 8 separated, 2 / C(16, 8)
+  result = mannWhitneyU({1, 2, 3, 4, 5, 6, 7, 8}, {9, 10, 11, 12, 13, 14, 15, 16});
+  EXPECT(result.exact && near(result.p_value, 2.0 / 12870, 1e-12));
+
+  // ties take the normal approximation, U counts a tie as a half
+  result = mannWhitneyU({1, 2, 2, 3}, {2, 3, 4, 5});
+  EXPECT(!result.exact && result.u == 2.5);
+  EXPECT(result.p_value > 0.05 && result.p_value < 0.2);
+
+  // every sample the same is no evidence of a change
+  result = mannWhitneyU({7, 7, 7}, {7, 7, 7});
+  EXPECT(result.u == 4.5 && result.p_value == 1);
+
+  // large samples: the normal approximation of separated sets is far below alpha
+  result = mannWhitneyU(noisy(100, 1, 30), noisy(120, 1, 30));
+  EXPECT(!result.exact && result.u == 0 && result.p_value < 1e-9);
+  result = mannWhitneyU(noisy(100, 1, 30), noisy(100, 1, 30));
+  EXPECT(result.p_value > 0.9);
+}
+
+static void testCompare() {
+  std::vector<BenchResult> base = {
+      makeResult("cnnlLog", noisy(100, 2, 20)), makeResult("cnnlSqrt", noisy(100, 2, 20)),
+      makeResult("cnnlAbs", noisy(100, 2, 20)), makeResult("cnnlDiv", noisy(100, 2, 20)),
+      makeResult("cnnlExp", noisy(100, 2, 3)),  makeResult("cnnlRemoved", noisy(100, 2, 20))};
+  std::vector<BenchResult> cand = {
+      makeResult("cnnlAdded", noisy(100, 2, 20)), makeResult("cnnlExp", noisy(200, 2, 3)),
+      makeResult("cnnlDiv", noisy(103, 2, 20)),   makeResult("cnnlAbs", noisy(100.5, 2, 20)),
+      makeResult("cnnlSqrt", noisy(80, 2, 20)),   makeResult("cnnlLog", noisy(130, 2, 20))};
+  CompareParam param;
+  std::vector<CompareEntry> entries = compareBench(base, cand, param);
+  EXPECT(entries.size() == 7);
+  if (entries.size() != 7) {
+    return;
+  }
+  EXPECT(entries[0].key == "cnnlLog half {64-4096} fast");
+  EXPECT(entries[0].status == COMPARE_REGRESSION && near(entries[0].change, 0.3, 1e-9));
+  EXPECT(entries[0].p_value < param.alpha);
+  EXPECT(entries[1].status == COMPARE_IMPROVEMENT && near(entries[1].change, -0.2, 1e-9));
+  EXPECT(entries[2].status == COMPARE_UNCHANGED);  // within the noise
+  EXPECT(entries[3].status == COMPARE_UNCHANGED);  // significant, below the threshold
+  EXPECT(entries[3].p_value < param.alpha && near(entries[3].change, 0.03, 1e-9));
+  EXPECT(entries[4].status == COMPARE_FEW_SAMPLES && near(entries[4].change, 1, 0.02));
+  EXPECT(entries[5].status == COMPARE_ONLY_BASE);
+  EXPECT(entries[6].status == COMPARE_ONLY_CAND && entries[6].key.find("cnnlAdded") == 0);
+
+  EXPECT(entries[1].base_variant == "MLUKernel" && entries[1].cand_variant == "MLUKernel");
+
+  // a lower threshold reports the small significant change, a different kernel is the same key
+  param.threshold = 0.01;
+  entries         = compareBench(base, cand, param);
+  EXPECT(entries[3].status == COMPARE_REGRESSION);
+  cand[4].variant = "MLUOtherKernel";
+  entries         = compareBench(base, cand, param);
+  EXPECT(entries.size() == 7 && entries[1].status == COMPARE_IMPROVEMENT);
+  EXPECT(entries[1].base_variant == "MLUKernel" && entries[1].cand_variant == "MLUOtherKernel");
+  cand[4].prefer = "high_precision";
+  entries        = compareBench(base, cand, param);
+  EXPECT(entries.size() == 8 && entries[1].status == COMPARE_ONLY_BASE);
+}
+
+int main() {
+  testSummary();
+  testJson();
+  testMannWhitney();
+  testCompare();
+  printf("%s bench_compare_test\n", failed_num == 0 ? "PASS" : "FAIL");
+  return failed_num == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
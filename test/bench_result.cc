@@ -0,0 +1,264 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include "bench_result.h"
+
+double latencyPercentile(const std::vector<double> &samples, double p) {
+  if (samples.empty()) {
+    return 0;
+  }
+  std::vector<double> sorted(samples);
+  std::sort(sorted.begin(), sorted.end());
+  size_t rank = (size_t)ceil(p / 100 * sorted.size());
+  return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+}
+
+LatencySummary summarizeLatency(const std::vector<double> &samples) {
+  LatencySummary summary;
+  if (samples.empty()) {
+    return summary;
+  }
+  summary.min_us    = *std::min_element(samples.begin(), samples.end());
+  summary.median_us = latencyPercentile(samples, 50);
+  summary.p99_us    = latencyPercentile(samples, 99);
+  for (auto sample : samples) {
+    summary.mean_us += sample;
+  }
+  summary.mean_us /= samples.size();
+  return summary;
+}
+
+double bandwidthGBps(size_t bytes, double us) {
+  return us > 0 ? bytes / us / 1e3 : 0;
+}
+
+static std::string shapeStr(const std::vector<int> &shape, const char *separator) {
+  std::stringstream text;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    text << (i == 0 ? "" : separator) << shape[i];
+  }
+  return text.str();
+}
+
+std::string benchKey(const BenchResult &result) {
+  return result.op + " " + result.dtype + " {" + shapeStr(result.shape, "-") + "} " +
+         result.prefer;
+}
+
+static std::string quote(const std::string &value) {
+  std::string quoted = "\"";
+  for (auto c : value) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+void writeBenchJson(std::ostream &out, const std::vector<BenchResult> &results) {
+  std::stringstream json;
+  json << std::fixed << std::setprecision(3);
+  json << "{\"benchmark\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchResult &result = results[i];
+    LatencySummary summary    = summarizeLatency(result.samples_us);
+    json << "{\"op\": " << quote(result.op) << ", \"dtype\": " << quote(result.dtype)
+         << ", \"shape\": [" << shapeStr(result.shape, ", ") << "]"
+         << ", \"prefer\": " << quote(result.prefer) << ", \"variant\": " << quote(result.variant)
+         << ", \"warmup\": " << result.warmup << ", \"iters\": " << result.samples_us.size()
+         << ", \"bytes\": " << result.bytes << ", \"min_us\": " << summary.min_us
+         << ", \"median_us\": " << summary.median_us << ", \"p99_us\": " << summary.p99_us
+         << ", \"mean_us\": " << summary.mean_us
+         << ", \"gbps\": " << bandwidthGBps(result.bytes, summary.median_us)
+         << ", \"samples_us\": [";
+    for (size_t j = 0; j < result.samples_us.size(); ++j) {
+      json << (j == 0 ? "" : ", ") << result.samples_us[j];
+    }
+    json << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  json << "]}\n";
+  out << json.str();
+}
+
+namespace {
+
+// A json value of readBenchJson, objects keep the order of their keys.
+struct JsonValue {
+  enum Type { JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT };
+  Type type     = JSON_NULL;
+  double number = 0;
+  std::string text;
+  std::vector<JsonValue> items;
+  std::vector<std::string> keys;  // keys[i] of items[i] for an object
+
+  const JsonValue *find(const std::string &key) const {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (keys[i] == key) {
+        return &items[i];
+      }
+    }
+    return NULL;
+  }
+};
+
+// Recursive descent parser of the json subset written by writeBenchJson, no \u escapes.
+class JsonParser {
+ public:
+  explicit JsonParser(const std::string &text) : text_(text) {}
+
+  bool parse(JsonValue &value, std::string &error) {
+    if (!parseValue(value) || (skipSpace(), pos_ != text_.size())) {
+      std::stringstream message;
+      message << "invalid json at offset " << pos_;
+      error = message.str();
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  void skipSpace() {
+    while (pos_ < text_.size() && isspace((unsigned char)text_[pos_])) {
+      pos_++;
+    }
+  }
+
+  bool consume(char c) {
+    skipSpace();
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      pos_++;
+      return true;
+    }
+    return false;
+  }
+
+  bool parseString(std::string &out) {
+    if (!consume('"')) {
+      return false;
+    }
+    while (pos_ < text_.size() && text_[pos_] != '"') {
+      if (text_[pos_] == '\\' && ++pos_ == text_.size()) {
+        return false;
+      }
+      out += text_[pos_++];
+    }
+    return consume('"');
+  }
+
+  bool parseValue(JsonValue &value) {
+    skipSpace();
+    if (pos_ == text_.size()) {
+      return false;
+    }
+    char c = text_[pos_];
+    if (c == '{' || c == '[') {
+      pos_++;
+      value.type = c == '{' ? JsonValue::JSON_OBJECT : JsonValue::JSON_ARRAY;
+      char end   = c == '{' ? '}' : ']';
+      if (consume(end)) {
+        return true;
+      }
+      do {
+        if (value.type == JsonValue::JSON_OBJECT) {
+          value.keys.push_back("");
+          if (!parseString(value.keys.back()) || !consume(':')) {
+            return false;
+          }
+        }
+        value.items.push_back(JsonValue());
+        if (!parseValue(value.items.back())) {
+          return false;
+        }
+      } while (consume(','));
+      return consume(end);
+    }
+    if (c == '"') {
+      value.type = JsonValue::JSON_STRING;
+      return parseString(value.text);
+    }
+    const char *words[] = {"true", "false", "null"};
+    for (auto word : words) {
+      std::string literal(word);
+      if (text_.compare(pos_, literal.size(), literal) == 0) {
+        pos_ += literal.size();
+        value.type   = literal == "null" ? JsonValue::JSON_NULL : JsonValue::JSON_BOOL;
+        value.number = literal == "true" ? 1 : 0;
+        return true;
+      }
+    }
+    const char *begin = text_.c_str() + pos_;
+    char *end         = NULL;
+    value.type        = JsonValue::JSON_NUMBER;
+    value.number      = strtod(begin, &end);
+    pos_ += end - begin;
+    return end != begin;
+  }
+
+  const std::string &text_;
+  size_t pos_ = 0;
+};
+
+}  // namespace
+
+bool readBenchJson(std::istream &in, std::vector<BenchResult> &results, std::string &error) {
+  std::stringstream stream;
+  stream << in.rdbuf();
+  std::string text = stream.str();
+  JsonParser parser(text);
+  JsonValue root;
+  if (!parser.parse(root, error)) {
+    return false;
+  }
+  const JsonValue *list = root.find("benchmark");
+  if (list == NULL || list->type != JsonValue::JSON_ARRAY) {
+    error = "no benchmark array";
+    return false;
+  }
+  for (auto &item : list->items) {
+    const JsonValue *op = item.find("op"), *dtype = item.find("dtype");
+    const JsonValue *shape = item.find("shape"), *samples = item.find("samples_us");
+    if (op == NULL || dtype == NULL || shape == NULL || samples == NULL) {
+      error = "a result misses op, dtype, shape or samples_us";
+      return false;
+    }
+    BenchResult result;
+    result.op    = op->text;
+    result.dtype = dtype->text;
+    for (auto &dim : shape->items) {
+      result.shape.push_back((int)dim.number);
+    }
+    for (auto &sample : samples->items) {
+      result.samples_us.push_back(sample.number);
+    }
+    const JsonValue *value = NULL;
+    if ((value = item.find("prefer")) != NULL) {
+      result.prefer = value->text;
+    }
+    if ((value = item.find("variant")) != NULL) {
+      result.variant = value->text;
+    }
+    if ((value = item.find("warmup")) != NULL) {
+      result.warmup = (int)value->number;
+    }
+    if ((value = item.find("bytes")) != NULL) {
+      result.bytes = (size_t)value->number;
+    }
+    results.push_back(result);
+  }
+  return true;
+}
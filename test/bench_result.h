@@ -0,0 +1,71 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef TEST_BENCH_RESULT_H_
+#define TEST_BENCH_RESULT_H_
+
+#include <stddef.h>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* Results of the benchmark mode of test_example, host only.
+ *
+ * The json holds one object per op, dtype and shape:
+ *   {"benchmark": [
+ *   {"op": "cnnlLog", "dtype": "half", "shape": [64, 4096], "prefer": "fast",
+ *    "variant": "MLUBlockKernel3StageLogHalfFast", "warmup": 2, "iters": 10,
+ *    "bytes": 1048576, "min_us": ..., "median_us": ..., "p99_us": ..., "mean_us": ...,
+ *    "gbps": ..., "samples_us": [...]}
+ *   ]}
+ * each result on its own line. bytes are read and written by one call, gbps is bytes over the
+ * median, samples_us is the hardware time of every iteration.
+ */
+struct BenchResult {
+  std::string op;
+  std::string dtype;
+  std::vector<int> shape;
+  std::string prefer;
+  std::string variant;  // the kernel launched by most iterations
+  int warmup   = 0;
+  size_t bytes = 0;
+  std::vector<double> samples_us;
+};
+
+struct LatencySummary {
+  double min_us    = 0;
+  double median_us = 0;
+  double p99_us    = 0;
+  double mean_us   = 0;
+};
+
+// Nearest-rank percentile p in [0, 100] of samples, 0 without samples.
+double latencyPercentile(const std::vector<double> &samples, double p);
+
+LatencySummary summarizeLatency(const std::vector<double> &samples);
+
+// GB/s of bytes moved in us, 0 for a zero time.
+double bandwidthGBps(size_t bytes, double us);
+
+/* "op dtype shape prefer", the key of a result when two result sets are compared. The variant
+ * is not part of it, a change of kernel is compared as the same case.
+ */
+std::string benchKey(const BenchResult &result);
+
+void writeBenchJson(std::ostream &out, const std::vector<BenchResult> &results);
+
+/* Reads the results written by writeBenchJson, the summaries are recomputed from samples_us
+ * and unknown keys are ignored. Returns false with error set for a malformed file.
+ */
+bool readBenchJson(std::istream &in, std::vector<BenchResult> &results, std::string &error);
+
+#endif  // TEST_BENCH_RESULT_H_
@@ -0,0 +1,172 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <math.h>
+#include <algorithm>
+#include <map>
+#include <utility>
+#include "bench_stats.h"
+
+/* Probability that U <= u for n1 and n2 samples without ties. count[j][v] is the number of
+ * orderings of i first and j second samples with U = v, built up over i.
+ */
+static double exactCdf(int n1, int n2, double u) {
+  int max_u = n1 * n2;
+  std::vector<std::vector<double>> count(n2 + 1, std::vector<double>(max_u + 1, 0));
+  for (int j = 0; j <= n2; ++j) {
+    count[j][0] = 1;  // i = 0
+  }
+  for (int i = 1; i <= n1; ++i) {
+    std::vector<std::vector<double>> next(n2 + 1, std::vector<double>(max_u + 1, 0));
+    next[0][0] = 1;
+    for (int j = 1; j <= n2; ++j) {
+      for (int v = 0; v <= i * j; ++v) {
+        // the largest sample is a first one, larger than the j second ones, or a second one
+        next[j][v] = (v >= j ? count[j][v - j] : 0) + next[j - 1][v];
+      }
+    }
+    count.swap(next);
+  }
+  double below = 0, total = 0;
+  for (int v = 0; v <= max_u; ++v) {
+    total += count[n2][v];
+    below += v <= u ? count[n2][v] : 0;
+  }
+  return below / total;
+}
+
+MannWhitneyResult mannWhitneyU(const std::vector<double> &a, const std::vector<double> &b) {
+  MannWhitneyResult result;
+  size_t n1 = a.size(), n2 = b.size(), n = n1 + n2;
+  if (n1 == 0 || n2 == 0) {
+    return result;
+  }
+  // ranks from 1, tied samples take the mean of their ranks
+  std::vector<std::pair<double, int>> samples;
+  for (auto value : a) {
+    samples.push_back(std::make_pair(value, 0));
+  }
+  for (auto value : b) {
+    samples.push_back(std::make_pair(value, 1));
+  }
+  std::sort(samples.begin(), samples.end());
+  double rank_sum = 0, tie_sum = 0;
+  for (size_t i = 0; i < n;) {
+    size_t j = i;
+    while (j < n && samples[j].first == samples[i].first) {
+      j++;
+    }
+    double rank = (i + 1 + j) / 2.0;
+    for (size_t k = i; k < j; ++k) {
+      rank_sum += samples[k].second == 0 ? rank : 0;
+    }
+    double tie = j - i;
+    tie_sum += tie * tie * tie - tie;
+    i = j;
+  }
+  result.u = rank_sum - n1 * (n1 + 1) / 2.0;
+
+  if (tie_sum == 0 && n1 <= MANN_WHITNEY_EXACT_MAX && n2 <= MANN_WHITNEY_EXACT_MAX) {
+    // the distribution of U is symmetric, P(U >= u) = P(U <= n1 * n2 - u)
+    double lower   = exactCdf(n1, n2, result.u);
+    double upper   = exactCdf(n1, n2, n1 * n2 - result.u);
+    result.p_value = std::min(1.0, 2 * std::min(lower, upper));
+    result.exact   = true;
+    return result;
+  }
+  double mean     = n1 * n2 / 2.0;
+  double variance = n1 * n2 / 12.0 * ((n + 1) - tie_sum / (n * (n - 1.0)));
+  if (variance <= 0) {
+    return result;  // every sample is the same
+  }
+  double z       = std::max(0.0, fabs(result.u - mean) - 0.5) / sqrt(variance);
+  result.p_value = std::min(1.0, erfc(z / sqrt(2.0)));
+  return result;
+}
+
+std::vector<CompareEntry> compareBench(const std::vector<BenchResult> &base,
+                                       const std::vector<BenchResult> &cand,
+                                       const CompareParam &param) {
+  std::map<std::string, const BenchResult *> cand_map;
+  for (auto &result : cand) {
+    cand_map[benchKey(result)] = &result;
+  }
+  std::map<std::string, const BenchResult *> base_map;
+  std::vector<std::string> keys;
+  for (auto &result : base) {
+    std::string key = benchKey(result);
+    if (base_map.count(key) == 0) {
+      keys.push_back(key);
+    }
+    base_map[key] = &result;
+  }
+  for (auto &result : cand) {
+    std::string key = benchKey(result);
+    if (base_map.count(key) == 0 && std::find(keys.begin(), keys.end(), key) == keys.end()) {
+      keys.push_back(key);
+    }
+  }
+
+  std::vector<CompareEntry> entries;
+  for (auto &key : keys) {
+    CompareEntry entry;
+    entry.key = key;
+    auto base_it = base_map.find(key);
+    auto cand_it = cand_map.find(key);
+    if (base_it != base_map.end()) {
+      entry.base_variant = base_it->second->variant;
+    }
+    if (cand_it != cand_map.end()) {
+      entry.cand_variant = cand_it->second->variant;
+    }
+    if (base_it == base_map.end() || cand_it == cand_map.end()) {
+      entry.status = base_it == base_map.end() ? COMPARE_ONLY_CAND : COMPARE_ONLY_BASE;
+      entries.push_back(entry);
+      continue;
+    }
+    const std::vector<double> &base_samples = base_it->second->samples_us;
+    const std::vector<double> &cand_samples = cand_it->second->samples_us;
+    entry.base_median = latencyPercentile(base_samples, 50);
+    entry.cand_median = latencyPercentile(cand_samples, 50);
+    entry.change      = entry.base_median > 0 ? entry.cand_median / entry.base_median - 1 : 0;
+    if ((int)base_samples.size() < param.min_samples ||
+        (int)cand_samples.size() < param.min_samples) {
+      entry.status = COMPARE_FEW_SAMPLES;
+      entries.push_back(entry);
+      continue;
+    }
+    entry.p_value = mannWhitneyU(cand_samples, base_samples).p_value;
+    if (entry.p_value < param.alpha && entry.change > param.threshold) {
+      entry.status = COMPARE_REGRESSION;
+    } else if (entry.p_value < param.alpha && entry.change < -param.threshold) {
+      entry.status = COMPARE_IMPROVEMENT;
+    }
+    entries.push_back(entry);
+  }
+  return entries;
+}
+
+const char *compareStatusStr(CompareStatus status) {
+  switch (status) {
+    case COMPARE_REGRESSION:
+      return "REGRESSION";
+    case COMPARE_IMPROVEMENT:
+      return "IMPROVEMENT";
+    case COMPARE_FEW_SAMPLES:
+      return "FEW_SAMPLES";
+    case COMPARE_ONLY_BASE:
+      return "ONLY_BASE";
+    case COMPARE_ONLY_CAND:
+      return "ONLY_CAND";
+    default:
+      return "UNCHANGED";
+  }
+}
@@ -0,0 +1,73 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef TEST_BENCH_STATS_H_
+#define TEST_BENCH_STATS_H_
+
+#include <string>
+#include <vector>
+#include "bench_result.h"
+
+/* Comparison of two benchmark result sets of test_example, host only.
+ *
+ * The samples of a result are the per iteration times, which are skewed and have outliers,
+ * so a baseline and a candidate are compared with the two-sided Mann-Whitney U test rather
+ * than their means. The exact distribution of U is used for small samples without ties,
+ * the normal approximation with tie and continuity corrections otherwise. A change is
+ * reported when it is significant and the medians differ by more than a threshold.
+ */
+#define MANN_WHITNEY_EXACT_MAX 20  // samples of each set for the exact distribution
+
+struct MannWhitneyResult {
+  double u       = 0;  // U of the first samples, the pairs where it is larger, ties as 1/2
+  double p_value = 1;  // two-sided
+  bool exact     = false;
+};
+
+MannWhitneyResult mannWhitneyU(const std::vector<double> &a, const std::vector<double> &b);
+
+struct CompareParam {
+  double alpha     = 0.01;  // the significance level
+  double threshold = 0.05;  // the relative change of the median to report
+  int min_samples  = 5;     // fewer samples in either set are not tested
+};
+
+enum CompareStatus {
+  COMPARE_UNCHANGED   = 0,
+  COMPARE_REGRESSION  = 1,
+  COMPARE_IMPROVEMENT = 2,
+  COMPARE_FEW_SAMPLES = 3,
+  COMPARE_ONLY_BASE   = 4,  // the key is not in the candidate
+  COMPARE_ONLY_CAND   = 5,  // the key is not in the baseline
+};
+
+struct CompareEntry {
+  std::string key;  // benchKey
+  CompareStatus status = COMPARE_UNCHANGED;
+  double base_median   = 0;
+  double cand_median   = 0;
+  double change        = 0;  // cand_median / base_median - 1
+  double p_value       = 1;
+  // the kernels of the key, they differ when the candidate launched another variant
+  std::string base_variant;
+  std::string cand_variant;
+};
+
+/* Compares the results of the same key, in the order of base then of the keys only in cand.
+ * A key appearing twice in a set keeps its last result.
+ */
+std::vector<CompareEntry> compareBench(const std::vector<BenchResult> &base,
+                                       const std::vector<BenchResult> &cand,
+                                       const CompareParam &param);
+
+const char *compareStatusStr(CompareStatus status);
+
+#endif  // TEST_BENCH_STATS_H_
@@ -0,0 +1,50 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Converts binary gen_case files to the prototxt of the text gen_case.
+// usage: ./case_convert a.cnnlcase [b.cnnlcase ...], writes a.prototxt next to a.cnnlcase.
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "include/case_dump.h"
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <case_file" << CASE_DUMP_SUFFIX << "> ...\n";
+    return EXIT_FAILURE;
+  }
+  int failed = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::string case_file(argv[i]);
+    cnnl::case_dump::CaseReader reader;
+    if (!reader.open(case_file)) {
+      failed++;
+      continue;
+    }
+    std::string suffix(CASE_DUMP_SUFFIX);
+    std::string out_file = case_file;
+    if (out_file.size() > suffix.size() &&
+        out_file.compare(out_file.size() - suffix.size(), suffix.size(), suffix) == 0) {
+      out_file.resize(out_file.size() - suffix.size());
+    }
+    out_file += ".prototxt";
+    std::ofstream out(out_file.c_str());
+    if (!out.is_open()) {
+      std::cerr << "open " << out_file << " failed.\n";
+      failed++;
+      continue;
+    }
+    cnnl::case_dump::caseToPrototxt(reader.info(), out);
+    std::cout << case_file << " -> " << out_file << "\n";
+  }
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,170 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "case_list.h"
+
+// arguments of a case, cnnlAdamUpdate takes the most
+#define CASE_MIN_ARGS 2
+#define CASE_MAX_ARGS 12
+
+bool parseCaseLine(const std::string &line, TestCase &test_case) {
+  std::string text = line;
+  text.erase(std::remove(text.begin(), text.end(), '"'), text.end());
+  std::stringstream stream(text);
+  std::vector<std::string> args;
+  std::string arg;
+  while (stream >> arg) {
+    args.push_back(arg);
+  }
+  if (!args.empty() && (args[0] == "./test_example" || args[0] == "test_example")) {
+    args.erase(args.begin());
+  }
+  if (args.empty() || args[0].compare(0, 2, "--") != 0) {
+    return false;
+  }
+
+  // the benchmark runs of test_example are not cases
+  const char *benchmark[] = {"--warmup=", "--iters=", "--shapes=", "--json="};
+  for (auto key : benchmark) {
+    std::string prefix(key);
+    for (auto &value : args) {
+      if (value.compare(0, prefix.size(), prefix) == 0) {
+        return false;
+      }
+    }
+  }
+
+  // the shape and the data type of --input come from its files
+  auto hasKey = [&](const std::string &prefix) {
+    return std::any_of(args.begin(), args.end(), [&](const std::string &value) {
+      return value.compare(0, prefix.size(), prefix) == 0;
+    });
+  };
+  const char *required[] = {"--op_name=", "--input_shape=", "--output_shape=", "--data_type="};
+  int required_num       = hasKey("--input=") ? 1 : 4;
+  for (int i = 0; i < required_num; ++i) {
+    std::string prefix(required[i]);
+    if (!hasKey(prefix)) {
+      throw std::runtime_error("missing " + prefix.substr(0, prefix.size() - 1));
+    }
+  }
+  if (args.size() < CASE_MIN_ARGS || args.size() > CASE_MAX_ARGS) {
+    throw std::runtime_error("a case takes 2 to 12 arguments");
+  }
+
+  std::vector<char *> argv(1, (char *)"test_example");
+  for (auto &value : args) {
+    argv.push_back(&value[0]);
+  }
+  test_case.param = ParamInfo();
+  parseParam(argv.size(), argv.data(), test_case.param);
+  test_case.args = args[0];
+  for (size_t i = 1; i < args.size(); ++i) {
+    test_case.args += " " + args[i];
+  }
+  return true;
+}
+
+std::vector<TestCase> parseCaseFile(const std::string &path) {
+  std::ifstream file(path.c_str());
+  if (!file.is_open()) {
+    throw std::runtime_error("can not open case file " + path);
+  }
+  std::vector<TestCase> cases;
+  std::string line;
+  for (int line_num = 1; std::getline(file, line); ++line_num) {
+    TestCase test_case;
+    try {
+      if (!parseCaseLine(line, test_case)) {
+        continue;
+      }
+    } catch (std::runtime_error &e) {
+      std::stringstream message;
+      message << path << ":" << line_num << ": " << e.what();
+      throw std::runtime_error(message.str());
+    }
+    test_case.file = path;
+    test_case.line = line_num;
+    cases.push_back(test_case);
+  }
+  return cases;
+}
+
+std::vector<size_t> caseBufferBytes(const ParamInfo &param) {
+  size_t element_num = 1;
+  for (int i = 0; i < param.dim_size; ++i) {
+    element_num *= param.input_shape[i];
+  }
+  return std::vector<size_t>(param.input_num + param.output_num,
+                             element_num * getDataTypeSize(param.dtype));
+}
+
+std::vector<size_t> maxBufferBytes(const std::vector<TestCase> &cases) {
+  std::vector<size_t> max_bytes;
+  for (auto &test_case : cases) {
+    std::vector<size_t> bytes = caseBufferBytes(test_case.param);
+    max_bytes.resize(std::max(max_bytes.size(), bytes.size()), 0);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+      max_bytes[i] = std::max(max_bytes[i], bytes[i]);
+    }
+  }
+  return max_bytes;
+}
+
+BufferPool::~BufferPool() {
+  for (auto ptr : ptrs_) {
+    if (ptr != NULL) {
+      release_(ptr);
+    }
+  }
+}
+
+void BufferPool::reserve(const std::vector<size_t> &bytes) {
+  acquire(bytes);
+}
+
+std::vector<void *> BufferPool::acquire(const std::vector<size_t> &bytes) {
+  if (ptrs_.size() < bytes.size()) {
+    ptrs_.resize(bytes.size(), NULL);
+    bytes_.resize(bytes.size(), 0);
+  }
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    if (bytes[i] <= bytes_[i]) {
+      continue;
+    }
+    if (ptrs_[i] != NULL) {
+      release_(ptrs_[i]);
+      ptrs_[i]  = NULL;
+      bytes_[i] = 0;
+    }
+    ptrs_[i] = alloc_(bytes[i]);
+    if (ptrs_[i] == NULL) {
+      std::stringstream message;
+      message << "alloc of " << bytes[i] << " bytes failed";
+      throw std::runtime_error(message.str());
+    }
+    bytes_[i] = bytes[i];
+    alloc_num_++;
+  }
+  return std::vector<void *>(ptrs_.begin(), ptrs_.begin() + bytes.size());
+}
+
+size_t BufferPool::capacity() const {
+  size_t total = 0;
+  for (auto bytes : bytes_) {
+    total += bytes;
+  }
+  return total;
+}
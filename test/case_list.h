@@ -0,0 +1,81 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef TEST_CASE_LIST_H_
+#define TEST_CASE_LIST_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "tool.h"
+
+/* Case files of test_example --case_file.
+ *
+ * Each line holds the arguments of one test_example run, as in run_test_example.sh: a leading
+ * ./test_example is dropped, double quotes are removed, empty lines, # comments, benchmark
+ * runs (--iters and the like) and the lines that are not test_example arguments are skipped.
+ * run_test_example.sh is itself a case file.
+ * Nothing here touches the device.
+ */
+struct TestCase {
+  std::string file;
+  int line = 0;
+  std::string args;  // the arguments as written, for the report
+  ParamInfo param;
+};
+
+/* Parses the case of line into test_case, returns false for a line without one. A line
+ * missing --op_name, or --input_shape, --output_shape or --data_type without --input .npy
+ * files, throws runtime_error.
+ */
+bool parseCaseLine(const std::string &line, TestCase &test_case);
+
+// Parses every case of path up front, throws runtime_error with the line of the first error.
+std::vector<TestCase> parseCaseFile(const std::string &path);
+
+// Bytes of the device buffers of a case, the inputs then the outputs, as prepareTestData.
+std::vector<size_t> caseBufferBytes(const ParamInfo &param);
+
+// The largest bytes of each buffer over the cases, the pool size that runs all of them.
+std::vector<size_t> maxBufferBytes(const std::vector<TestCase> &cases);
+
+/* Device buffers reused across the cases of a batch. Buffer i is reallocated only when a case
+ * needs more than it holds, so a pool reserved with maxBufferBytes never allocates again.
+ * alloc and release are cnrtMalloc and cnrtFree in test_example, host memory in the tests.
+ */
+class BufferPool {
+ public:
+  typedef void *(*AllocFunc)(size_t bytes);
+  typedef void (*ReleaseFunc)(void *ptr);
+
+  BufferPool(AllocFunc alloc, ReleaseFunc release) : alloc_(alloc), release_(release) {}
+  ~BufferPool();
+
+  void reserve(const std::vector<size_t> &bytes);
+
+  // Buffers of at least bytes[i] bytes each, valid until the next acquire.
+  std::vector<void *> acquire(const std::vector<size_t> &bytes);
+
+  size_t allocNum() const { return alloc_num_; }
+  size_t capacity() const;  // bytes held by the pool
+
+ private:
+  BufferPool(const BufferPool &);
+  BufferPool &operator=(const BufferPool &);
+
+  AllocFunc alloc_;
+  ReleaseFunc release_;
+  std::vector<void *> ptrs_;
+  std::vector<size_t> bytes_;
+  size_t alloc_num_ = 0;
+};
+
+#endif  // TEST_CASE_LIST_H_
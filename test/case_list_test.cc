@@ -0,0 +1,181 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Checks the case file parsing and the buffer pool of test_example --case_file on the host,
+// without a device.
+// usage: ./case_list_test
+#include <stdio.h>
+#include <stdlib.h>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "case_list.h"
+#include "npy_file.h"
+
+static int failed_num = 0;
+
+#define EXPECT(cond)                                       \
+  if (!(cond)) {                                           \
+    printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+    failed_num++;                                          \
+  }
+
+static size_t alloc_bytes = 0;
+
+static void *hostAlloc(size_t bytes) {
+  alloc_bytes += bytes;
+  return malloc(bytes);
+}
+
+static void hostRelease(void *ptr) {
+  free(ptr);
+}
+
+static void testParseLine() {
+  TestCase test_case;
+  EXPECT(!parseCaseLine("", test_case));
+  EXPECT(!parseCaseLine("# a comment", test_case));
+  EXPECT(!parseCaseLine("set -e", test_case));
+  EXPECT(!parseCaseLine("./half_sweep --backend=device", test_case));
+  EXPECT(!parseCaseLine("--op_name=cnnlAbs --shapes={8},{16} --data_type=half --iters=10",
+                        test_case));
+
+  EXPECT(parseCaseLine("./test_example --op_name=\"cnnlLog\" --prefer=approx --log_base=10 "
+                       "--input_shape=\"{64-4096}\" --output_shape=\"{64-4096}\" "
+                       "--data_type=float",
+                       test_case));
+  const ParamInfo &param = test_case.param;
+  EXPECT(param.op_name == CNNL_LOG);
+  EXPECT(param.prefer == CNNL_COMPUTATION_APPROX);
+  EXPECT(param.log_base == CNNL_LOG_10);
+  EXPECT(param.dtype == CNNL_DTYPE_FLOAT);
+  EXPECT(param.dim_size == 2 && param.input_shape[0] == 64 && param.input_shape[1] == 4096);
+  EXPECT(test_case.args.compare(0, 17, "--op_name=cnnlLog") == 0);
+
+  // the defaults of a line do not keep the values of the previous one
+  EXPECT(parseCaseLine("--op_name=cnnlDiv --input_shape={2-3-4} --output_shape={2-3-4} "
+                       "--data_type=half",
+                       test_case));
+  EXPECT(test_case.param.op_name == CNNL_DIV && test_case.param.input_num == 2);
+  EXPECT(test_case.param.prefer == CNNL_COMPUTATION_FAST);
+  EXPECT(test_case.param.dim_size == 3 && test_case.param.input_shape[2] == 4);
+
+  bool thrown = false;
+  try {
+    parseCaseLine("--op_name=cnnlAbs --input_shape={8} --output_shape={8}", test_case);
+  } catch (std::runtime_error &e) {
+    thrown = std::string(e.what()) == "missing --data_type";
+  }
+  EXPECT(thrown);
+}
+
+static void testParseFile() {
+  const char *path = "case_list_test.txt";
+  {
+    std::ofstream file(path);
+    file << "#!/bin/sh\n\nset -e\n";
+    file << "./test_example --op_name=\"cnnlAbs\" --input_shape=\"{128}\" "
+            "--output_shape=\"{128}\" --data_type=half\n";
+    file << "# a comment\n";
+    file << "--op_name=cnnlAbsSign --input_shape={64-1024} --output_shape={64-1024} "
+            "--data_type=float\n";
+    file << "--op_name=cnnlDiv --input_shape={256} --output_shape={256} --data_type=int16\n";
+  }
+  std::vector<TestCase> cases = parseCaseFile(path);
+  EXPECT(cases.size() == 3);
+  if (cases.size() == 3) {
+    EXPECT(cases[0].line == 4 && cases[0].param.op_name == CNNL_ABS);
+    EXPECT(cases[1].line == 6 && cases[1].param.output_num == 2);
+    EXPECT(cases[2].line == 7 && cases[2].param.dtype == CNNL_DTYPE_INT16);
+
+    // abs: 2 half buffers of 128, abs_sign: 3 float buffers of 64K, div: 3 int16 of 256
+    std::vector<size_t> bytes = caseBufferBytes(cases[1].param);
+    EXPECT(bytes.size() == 3 && bytes[0] == 64 * 1024 * 4);
+    std::vector<size_t> max_bytes = maxBufferBytes(cases);
+    EXPECT(max_bytes.size() == 3 && max_bytes[0] == 64 * 1024 * 4 && max_bytes[2] == 64 * 1024 * 4);
+  }
+
+  {
+    std::ofstream file(path);
+    file << "# a comment\n";
+    file << "--op_name=cnnlAbs --input_shape={8} --output_shape={8} --data_type=half\n";
+    file << "--op_name=cnnlAbs --output_shape={8} --data_type=half\n";
+  }
+  std::string message;
+  try {
+    parseCaseFile(path);
+  } catch (std::runtime_error &e) {
+    message = e.what();
+  }
+  EXPECT(message == std::string(path) + ":3: missing --input_shape");
+  remove(path);
+}
+
+static void testInputFiles() {
+  // the shape and the data type of a case with --input come from the .npy headers
+  const char *paths[] = {"case_list_test_x.npy", "case_list_test_y.npy"};
+  for (auto path : paths) {
+    MappedNpy npy;
+    std::string error;
+    EXPECT(npy.create(path, "<f2", {16, 32}, error));
+  }
+  TestCase test_case;
+  EXPECT(parseCaseLine("--op_name=cnnlDiv --input=case_list_test_x.npy,case_list_test_y.npy",
+                       test_case));
+  EXPECT(test_case.param.dtype == CNNL_DTYPE_HALF && test_case.param.input_files.size() == 2);
+  EXPECT(test_case.param.dim_size == 2 && test_case.param.input_shape[1] == 32);
+  EXPECT(test_case.param.output_shape[0] == 16 && test_case.param.output_shape[1] == 32);
+  std::vector<size_t> bytes = caseBufferBytes(test_case.param);
+  EXPECT(bytes.size() == 3 && bytes[2] == 16 * 32 * 2);
+
+  EXPECT(parseCaseLine("--op_name=cnnlReduceLastDim --input=case_list_test_x.npy", test_case));
+  EXPECT(test_case.param.output_shape[0] == 16 && test_case.param.output_shape[1] == 1);
+  for (auto path : paths) {
+    remove(path);
+  }
+}
+
+static void testBufferPool() {
+  alloc_bytes = 0;
+  BufferPool pool(hostAlloc, hostRelease);
+  std::vector<void *> ptrs = pool.acquire({256, 256});
+  EXPECT(ptrs.size() == 2 && pool.allocNum() == 2 && pool.capacity() == 512);
+
+  // smaller or equal cases reuse the buffers
+  std::vector<void *> reused = pool.acquire({128, 256});
+  EXPECT(reused == ptrs && pool.allocNum() == 2);
+
+  // a larger buffer and a new buffer are allocated, the others kept
+  std::vector<void *> grown = pool.acquire({256, 1024, 64});
+  EXPECT(grown.size() == 3 && grown[0] == ptrs[0] && pool.allocNum() == 4);
+  EXPECT(pool.capacity() == 256 + 1024 + 64);
+
+  // a pool reserved for the largest case never allocates again
+  BufferPool reserved(hostAlloc, hostRelease);
+  reserved.reserve({4096, 4096, 4096});
+  size_t reserved_num = reserved.allocNum();
+  const std::vector<size_t> sizes[] = {{16, 16}, {4096, 4096, 4096}, {1024, 8, 2048}};
+  for (auto &size : sizes) {
+    reserved.acquire(size);
+  }
+  EXPECT(reserved_num == 3 && reserved.allocNum() == reserved_num);
+  EXPECT(alloc_bytes == 256 * 2 + 1024 + 64 + 4096 * 3);
+}
+
+int main() {
+  testParseLine();
+  testParseFile();
+  testInputFiles();
+  testBufferPool();
+  printf("%s case_list_test\n", failed_num == 0 ? "PASS" : "FAIL");
+  return failed_num == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
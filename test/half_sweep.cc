@@ -0,0 +1,481 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Runs every half value through the half unary operations and reports the error in ulp.
+// usage: ./half_sweep [--backend=device|host] [--threads=N] [--prefer=fast,accuracy,approx]
+// cnnlAbs, cnnlLog of the three bases, cnnlSqrt and cnnlSqrtBackward (diff_y = 1) take the
+// 65536 halves as one tensor, the results are compared with a double reference over the
+// documented input range of the operation and prefer. The max error is checked where a bound
+// is documented: abs is exact, CNNL_COMPUTATION_APPROX has the bounds of kernels/approx_math.h.
+// The host backend, for machines without MLU, only runs the rows it models exactly: cnnlAbs
+// and CNNL_COMPUTATION_APPROX, the polynomials of kernels/approx_math.h rounded down to half
+// as __bang_float2half_rd. The active function rows are reported as not modelled on host.
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "include/gen_case.h"
+#include "kernels/approx_math.h"
+#include "reference.h"
+#include "tool.h"
+
+#define HALF_NUM 65536
+#define HALF_MAX 65504.0
+
+struct SweepParam {
+  bool device = true;
+  int threads = 1;
+  std::vector<cnnlComputationPreference_t> prefers = {
+      CNNL_COMPUTATION_FAST, CNNL_COMPUTATION_HIGH_PRECISION, CNNL_COMPUTATION_APPROX};
+};
+
+struct SweepCase {
+  const char *name;
+  OpName op_name;
+  cnnlLogBase_t log_base;
+  bool has_prefer;  // the api takes a cnnlComputationPreference_t
+};
+
+static const SweepCase sweep_cases[] = {
+    {"cnnlAbs", CNNL_ABS, CNNL_LOG_E, false},
+    {"cnnlLog log_base=e", CNNL_LOG, CNNL_LOG_E, true},
+    {"cnnlLog log_base=2", CNNL_LOG, CNNL_LOG_2, true},
+    {"cnnlLog log_base=10", CNNL_LOG, CNNL_LOG_10, true},
+    {"cnnlSqrt", CNNL_SQRT, CNNL_LOG_E, true},
+    {"cnnlSqrtBackward", CNNL_SQRT_BACKWARD, CNNL_LOG_E, false},
+};
+
+// Error of the inputs of one slice, merged over the threads.
+struct SweepError {
+  size_t input_num     = 0;
+  size_t nonfinite_num = 0;  // inf or nan results where the exact result is finite
+  double max_ulp       = 0;
+  double sum_ulp       = 0;
+  float worst          = 0;  // the input of max_ulp
+};
+
+static void usage(const char *name) {
+  std::cerr << "usage: " << name
+            << " [--backend=device|host] [--threads=N] [--prefer=fast,accuracy,approx]\n";
+  exit(EXIT_FAILURE);
+}
+
+static void parseSweepParam(int argc, char *argv[], SweepParam &param) {
+  param.threads = std::max(1, (int)std::thread::hardware_concurrency());
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    std::string value = arg.substr(arg.find('=') + 1);
+    if (arg.compare(0, 10, "--backend=") == 0 && (value == "device" || value == "host")) {
+      param.device = value == "device";
+    } else if (arg.compare(0, 10, "--threads=") == 0) {
+      param.threads = std::max(1, atoi(value.c_str()));
+    } else if (arg.compare(0, 9, "--prefer=") == 0) {
+      param.prefers.clear();
+      std::stringstream list(value);
+      std::string prefer;
+      while (std::getline(list, prefer, ',')) {
+        if (prefer == "fast") {
+          param.prefers.push_back(CNNL_COMPUTATION_FAST);
+        } else if (prefer == "accuracy") {
+          param.prefers.push_back(CNNL_COMPUTATION_HIGH_PRECISION);
+        } else if (prefer == "approx") {
+          param.prefers.push_back(CNNL_COMPUTATION_APPROX);
+        } else {
+          std::cerr << "unsupported prefer:" << prefer << "\n";
+          usage(argv[0]);
+        }
+      }
+      if (param.prefers.empty()) {
+        usage(argv[0]);
+      }
+    } else {
+      std::cerr << "unsupported param:" << arg << "\n";
+      usage(argv[0]);
+    }
+  }
+}
+
+static const char *preferStr(cnnlComputationPreference_t prefer) {
+  switch (prefer) {
+    case CNNL_COMPUTATION_FAST:
+      return "fast";
+    case CNNL_COMPUTATION_HIGH_PRECISION:
+      return "accuracy";
+    default:
+      return "approx";
+  }
+}
+
+// Calls fn(begin, end, index) on thread_num slices of [0, num) in parallel.
+template <typename Func>
+static void parallelFor(int thread_num, size_t num, Func fn) {
+  std::vector<std::thread> threads;
+  size_t slice = (num + thread_num - 1) / thread_num;
+  for (int i = 0; i < thread_num && i * slice < num; ++i) {
+    threads.push_back(std::thread(fn, i * slice, std::min(num, (i + 1) * slice), i));
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+// The documented input range of cnnl_example.h, the error is only measured there.
+static bool inRange(const SweepCase &sweep_case, cnnlComputationPreference_t prefer, float x) {
+  bool approx = sweep_case.has_prefer && prefer == CNNL_COMPUTATION_APPROX;
+  switch (sweep_case.op_name) {
+    case CNNL_ABS:
+      return std::isfinite(x);
+    case CNNL_LOG:
+      return approx ? x > 0 && std::isfinite(x) : x >= 1 && x <= 60000;
+    case CNNL_SQRT:
+      return approx ? x >= 0 && std::isfinite(x)
+                    : (x >= 1e-3f && x <= 1e-2f) || (x >= 1e-1f && x <= 60000);
+    default:
+      return x >= 0.01f && x <= 500;
+  }
+}
+
+// The max error in ulp where the kernels document one: abs is exact, and the Approx kernels.
+static bool errorBound(const SweepCase &sweep_case,
+                       cnnlComputationPreference_t prefer,
+                       double &bound) {
+  if (sweep_case.op_name == CNNL_ABS) {
+    bound = 0;
+    return true;
+  }
+  if (sweep_case.has_prefer && prefer == CNNL_COMPUTATION_APPROX) {
+    bound = sweep_case.op_name == CNNL_LOG ? APPROX_LOG_MAX_ULP_HALF : APPROX_SQRT_MAX_ULP_HALF;
+    return true;
+  }
+  return false;
+}
+
+static double reference(const SweepCase &sweep_case, double x) {
+  switch (sweep_case.op_name) {
+    case CNNL_ABS:
+      return fabs(x);
+    case CNNL_LOG:
+      return sweep_case.log_base == CNNL_LOG_2
+                 ? log2(x)
+                 : (sweep_case.log_base == CNNL_LOG_10 ? log10(x) : log(x));
+    case CNNL_SQRT:
+      return sqrt(x);
+    default:
+      return 0.5 / x;
+  }
+}
+
+// Spacing of half at the exact value, the subnormal spacing below the normal range.
+static double halfUlp(double exact) {
+  if (exact == 0) {
+    return ldexp(1.0, -24);
+  }
+  int exponent = 0;
+  frexp(exact, &exponent);
+  return ldexp(1.0, std::max(exponent - 1, -14) - 10);
+}
+
+// float to the half below or equal, __bang_float2half_rd of the HighAcc kernels.
+static float roundDownToHalf(float value) {
+  if (!std::isfinite(value) || value == 0) {
+    return value;
+  }
+  double ulp     = halfUlp(value);
+  double rounded = floor(value / ulp) * ulp;
+  return fabs(rounded) > HALF_MAX ? (rounded > 0 ? INFINITY : -INFINITY) : (float)rounded;
+}
+
+// The polynomials of the Approx kernels on [begin, end) of x, in place.
+static void approxHostCompute(const SweepCase &sweep_case, float *x, size_t begin, size_t end) {
+  std::vector<float> scratch(APPROX_SCRATCH_BYTES / sizeof(float));
+  float *t1     = scratch.data() + APPROX_SUB_NUM;
+  float *t2     = t1 + APPROX_SUB_NUM;
+  float *t3     = t2 + APPROX_SUB_NUM;
+  float *t4     = t3 + APPROX_SUB_NUM;
+  float *t5     = t4 + APPROX_SUB_NUM;
+  int32_t *mask = (int32_t *)(t5 + APPROX_SUB_NUM);
+  float *consts = t5 + 2 * APPROX_SUB_NUM;
+  approxSetConsts(mask, consts);
+  // the base factors of kernels/log/log.mlu
+  float coef = sweep_case.log_base == CNNL_LOG_2
+                   ? (float)log2(exp(1))
+                   : (sweep_case.log_base == CNNL_LOG_10 ? (float)log10(exp(1)) : 1.0f);
+  for (size_t i = begin; i < end; i += APPROX_SUB_NUM) {
+    int32_t num = std::min(end - i, (size_t)APPROX_SUB_NUM);
+    if (sweep_case.op_name == CNNL_SQRT) {
+      approxSqrt(x + i, t1, t2, t3, t4, t5, mask, consts, num);
+    } else {
+      approxLog(x + i, t1, t2, t3, t4, t5, mask, consts, num, coef);
+    }
+  }
+}
+
+// The rows the host backend computes as the kernels do, cnnlAbs and the Approx polynomials.
+static bool hostModelled(const SweepCase &sweep_case, cnnlComputationPreference_t prefer) {
+  return sweep_case.op_name == CNNL_ABS ||
+         (sweep_case.has_prefer && prefer == CNNL_COMPUTATION_APPROX &&
+          (sweep_case.op_name == CNNL_LOG || sweep_case.op_name == CNNL_SQRT));
+}
+
+// Computes a sweep of hostModelled on host, returns the wall time in us.
+static double hostSweep(const SweepParam &param,
+                        const SweepCase &sweep_case,
+                        cnnlComputationPreference_t prefer,
+                        const std::vector<float> &x,
+                        const std::vector<float> &diff_y,
+                        std::vector<float> &result) {
+  HostOpParam op_param;
+  op_param.log_base = sweep_case.log_base;
+  bool approx       = sweep_case.op_name != CNNL_ABS;
+  auto host_start = std::chrono::steady_clock::now();
+  parallelFor(param.threads, x.size(), [&](size_t begin, size_t end, int index) {
+    if (approx) {
+      std::copy(x.begin() + begin, x.begin() + end, result.begin() + begin);
+      approxHostCompute(sweep_case, result.data(), begin, end);
+    } else {
+      std::vector<const float *> inputs = {x.data() + begin, diff_y.data() + begin};
+      hostCompute(sweep_case.op_name, op_param, inputs, result.data() + begin, end - begin);
+    }
+    for (size_t i = begin; i < end; ++i) {
+      result[i] = roundDownToHalf(result[i]);
+    }
+  });
+  auto host_end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(host_end - host_start).count();
+}
+
+static void launch(const cnnlHandle_t handle,
+                   const SweepCase &sweep_case,
+                   cnnlComputationPreference_t prefer,
+                   const cnnlTensorDescriptor_t desc,
+                   const std::vector<void *> &ptrs) {
+  switch (sweep_case.op_name) {
+    case CNNL_ABS:
+      CNNL_CHECK(cnnlAbs(handle, desc, ptrs[0], desc, ptrs[2]));
+      break;
+    case CNNL_LOG:
+      CNNL_CHECK(cnnlLog(handle, prefer, sweep_case.log_base, desc, ptrs[0], desc, ptrs[2]));
+      break;
+    case CNNL_SQRT:
+      CNNL_CHECK(cnnlSqrt(handle, prefer, desc, ptrs[0], desc, ptrs[2]));
+      break;
+    default:
+      CNNL_CHECK(cnnlSqrtBackward(handle, desc, ptrs[0], desc, ptrs[1], desc, ptrs[2]));
+      break;
+  }
+}
+
+/* Computes the sweep on device, ptrs are x, diff_y and the output of HALF_NUM halves.
+ * Returns the hardware time of one launch in us, after a warmup launch.
+ */
+static double deviceSweep(const cnnlHandle_t handle,
+                          const cnrtQueue_t queue,
+                          const SweepCase &sweep_case,
+                          cnnlComputationPreference_t prefer,
+                          const cnnlTensorDescriptor_t desc,
+                          const std::vector<void *> &ptrs,
+                          std::vector<float> &result) {
+  cnrtNotifier_t notifier_start = NULL, notifier_end = NULL;
+  launch(handle, sweep_case, prefer, desc, ptrs);
+  CNRT_CHECK(cnrtSyncQueue(queue));
+  CNRT_CHECK(cnrtCreateNotifier(&notifier_start));
+  CNRT_CHECK(cnrtCreateNotifier(&notifier_end));
+  CNRT_CHECK(cnrtPlaceNotifier(notifier_start, queue));
+  launch(handle, sweep_case, prefer, desc, ptrs);
+  CNRT_CHECK(cnrtPlaceNotifier(notifier_end, queue));
+  CNRT_CHECK(cnrtSyncQueue(queue));
+  float device_us = 0;
+  CNRT_CHECK(cnrtNotifierDuration(notifier_start, notifier_end, &device_us));
+  cnrtDestroyNotifier(&notifier_start);
+  cnrtDestroyNotifier(&notifier_end);
+
+  std::vector<int16_t> output(HALF_NUM);
+  CNRT_CHECK(cnrtMemcpy(output.data(), ptrs[2], HALF_NUM * sizeof(int16_t),
+                        CNRT_MEM_TRANS_DIR_DEV2HOST));
+  for (int i = 0; i < HALF_NUM; ++i) {
+    result[i] = cnnl::gen_case::cvtHalfToFloat(output[i]);
+  }
+  return device_us;
+}
+
+static SweepError sweepError(const SweepParam &param,
+                             const SweepCase &sweep_case,
+                             cnnlComputationPreference_t prefer,
+                             const std::vector<float> &x,
+                             const std::vector<float> &result) {
+  std::vector<SweepError> errors(param.threads);
+  parallelFor(param.threads, x.size(), [&](size_t begin, size_t end, int index) {
+    SweepError &error = errors[index];
+    for (size_t i = begin; i < end; ++i) {
+      if (!inRange(sweep_case, prefer, x[i])) {
+        continue;
+      }
+      double exact = reference(sweep_case, x[i]);
+      if (!std::isfinite(exact) || fabs(exact) > HALF_MAX) {
+        continue;
+      }
+      error.input_num++;
+      if (!std::isfinite(result[i])) {
+        error.nonfinite_num++;
+        continue;
+      }
+      double ulp = fabs(result[i] - exact) / halfUlp(exact);
+      error.sum_ulp += ulp;
+      if (ulp > error.max_ulp) {
+        error.max_ulp = ulp;
+        error.worst   = x[i];
+      }
+    }
+  });
+  SweepError total;
+  for (auto &error : errors) {
+    total.input_num += error.input_num;
+    total.nonfinite_num += error.nonfinite_num;
+    total.sum_ulp += error.sum_ulp;
+    if (error.max_ulp > total.max_ulp) {
+      total.max_ulp = error.max_ulp;
+      total.worst   = error.worst;
+    }
+  }
+  return total;
+}
+
+int main(int argc, char *argv[]) {
+  SweepParam param;
+  parseSweepParam(argc, argv, param);
+
+  // every half bit pattern, and a diff_y of ones for cnnlSqrtBackward
+  std::vector<int16_t> x_half(HALF_NUM), ones_half(HALF_NUM, 0x3c00);
+  std::vector<float> x(HALF_NUM), diff_y(HALF_NUM, 1.0f), result(HALF_NUM);
+  for (int i = 0; i < HALF_NUM; ++i) {
+    x_half[i] = (int16_t)i;
+    x[i]      = cnnl::gen_case::cvtHalfToFloat(x_half[i]);
+  }
+
+  cnrtDev_t dev;
+  cnrtQueue_t queue           = NULL;
+  cnnlHandle_t handle         = NULL;
+  cnnlTensorDescriptor_t desc = NULL;
+  std::vector<void *> ptrs;
+  if (param.device) {
+    try {
+      initDevice(dev, queue, handle);
+      int dims[1] = {HALF_NUM};
+      CNNL_CHECK(cnnlCreateTensorDescriptor(&desc));
+      CNNL_CHECK(cnnlSetTensorDescriptor(desc, CNNL_LAYOUT_ARRAY, CNNL_DTYPE_HALF, 1, dims));
+      for (int i = 0; i < 3; ++i) {
+        void *ptr = NULL;
+        CNRT_CHECK(cnrtMalloc(&ptr, HALF_NUM * sizeof(int16_t)));
+        ptrs.push_back(ptr);
+      }
+      CNRT_CHECK(cnrtMemcpy(ptrs[0], x_half.data(), HALF_NUM * sizeof(int16_t),
+                            CNRT_MEM_TRANS_DIR_HOST2DEV));
+      CNRT_CHECK(cnrtMemcpy(ptrs[1], ones_half.data(), HALF_NUM * sizeof(int16_t),
+                            CNRT_MEM_TRANS_DIR_HOST2DEV));
+    } catch (std::runtime_error &e) {
+      std::cerr << "init device failed: " << e.what() << ", use --backend=host without MLU.\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  int passed = 0, failed = 0, reported = 0, skipped = 0;
+  std::cout << std::fixed << std::setprecision(3);
+  for (auto &sweep_case : sweep_cases) {
+    // the apis without a prefer run once
+    std::vector<cnnlComputationPreference_t> prefers =
+        sweep_case.has_prefer ? param.prefers
+                              : std::vector<cnnlComputationPreference_t>(1, CNNL_COMPUTATION_FAST);
+    for (auto prefer : prefers) {
+      if (!param.device && !hostModelled(sweep_case, prefer)) {
+        // the float reference rounded to half would be measured, not the active functions
+        std::cout << "[SKIP] " << sweep_case.name;
+        if (sweep_case.has_prefer) {
+          std::cout << " prefer=" << preferStr(prefer);
+        }
+        std::cout << " (not modelled on host)\n";
+        skipped++;
+        continue;
+      }
+      std::string status, message;
+      double time_us = 0, bound = 0;
+      bool has_bound = errorBound(sweep_case, prefer, bound);
+      try {
+        time_us = param.device
+                      ? deviceSweep(handle, queue, sweep_case, prefer, desc, ptrs, result)
+                      : hostSweep(param, sweep_case, prefer, x, diff_y, result);
+      } catch (std::runtime_error &e) {
+        status  = "FAIL";
+        message = e.what();
+      }
+      SweepError error;
+      if (status.empty()) {
+        error = sweepError(param, sweep_case, prefer, x, result);
+        if (!has_bound) {
+          status = "INFO";
+        } else {
+          bool pass = error.nonfinite_num == 0 && error.max_ulp <= bound;
+          status    = pass ? "PASS" : "FAIL";
+        }
+      }
+      std::cout << "[" << status << "] " << sweep_case.name;
+      if (sweep_case.has_prefer) {
+        std::cout << " prefer=" << preferStr(prefer);
+      }
+      if (message.empty()) {
+        std::cout << ": " << error.input_num << " inputs, max " << error.max_ulp << " ulp at "
+                  << std::defaultfloat << std::setprecision(8) << error.worst << std::fixed
+                  << std::setprecision(3) << ", mean "
+                  << (error.input_num == 0 ? 0 : error.sum_ulp / error.input_num) << " ulp";
+        if (error.nonfinite_num > 0) {
+          std::cout << ", " << error.nonfinite_num << " inf or nan";
+        }
+        if (has_bound) {
+          std::cout << ", bound " << bound << " ulp";
+        }
+        std::cout << ", " << (param.device ? "device " : "host ") << time_us << " us, "
+                  << (time_us > 0 ? HALF_NUM / time_us : 0) << " M elem/s";
+      } else {
+        std::cout << " (" << message << ")";
+      }
+      std::cout << "\n";
+      if (status == "PASS") {
+        passed++;
+      } else if (status == "FAIL") {
+        failed++;
+      } else {
+        reported++;
+      }
+    }
+  }
+  std::cout << passed << " passed, " << failed << " failed, " << reported
+            << " without a documented bound, " << skipped << " not modelled on host, "
+            << (param.device ? "device" : "host") << " with "
+            << param.threads << " host threads\n";
+
+  if (param.device) {
+    cnnlDestroyTensorDescriptor(desc);
+    for (auto ptr : ptrs) {
+      cnrtFree(ptr);
+    }
+    cnrtDestroyQueue(queue);
+    cnnlReleaseHandleStatistics(handle);
+    cnnlDestroy(handle);
+  }
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,295 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Runs the integer division of kernels/div/div_device.mlu on the host in float, one element
+// at a time, against int64 division. int8 is checked exhaustively, int16 and int32 on edge
+// and random pairs, int32 in its 16-bit digits. The reciprocal of the device is modeled with
+// a relative error of 0 and +-2^-12. Also runs the int32 abs of kernels/abs/abs_device.mlu on
+// its 16-bit halves on edge values and the whole range. usage: ./int_div_sim
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+
+#define INT_ROUND_MAGIC 8388608.0f  // 2^23, as kernels/integer_math.h
+#define INT_HALF_SCALE 65536.0f     // 2^16
+#define INT32_MAX_FLOAT 2147483520.0f  // the max of setIntConsts for int32
+
+static int failed_num = 0;
+
+// roundToInteger of kernels/integer_math.h
+static float roundToInteger(float v) {
+  float sign  = (float)(v > 0) - (float)(v < 0);
+  float magic = (float)(v * sign < INT_ROUND_MAGIC) * sign * INT_ROUND_MAGIC;
+  return (v + magic) - magic;
+}
+
+// divInt of kernels/div/div_device.mlu
+static int64_t deviceDivide(int32_t dividend, int32_t divisor, bool floor_mode, float max_value,
+                            float delta) {
+  float x = (float)dividend, y = (float)divisor;
+  if (y == 0) {
+    x = 0;
+    y = 1;
+  }
+  float recip = (1.0f / y) * (1.0f + delta);
+  float q     = roundToInteger(x * recip);
+  float rem   = x - q * y;
+  q += roundToInteger(rem * recip);
+  float sign  = (float)(y > 0) * 2.0f - 1.0f;
+  float abs_y = y * sign;
+  rem         = (x - q * y) * sign;
+  q -= (float)(rem < 0);
+  q += (float)(rem >= abs_y);
+  if (!floor_mode) {
+    rem = (x - q * y) * sign;
+    q += (float)(rem > 0) * (float)(x * sign < 0);
+  }
+  q -= (float)(q > max_value) * (q - max_value);
+  return (int64_t)q;
+}
+
+static int64_t hostDivide(int32_t dividend, int32_t divisor, bool floor_mode, int64_t max_value) {
+  if (divisor == 0) {
+    return 0;
+  }
+  int64_t quotient = (int64_t)dividend / divisor;
+  if (floor_mode && (int64_t)dividend % divisor != 0 && (dividend < 0) != (divisor < 0)) {
+    quotient -= 1;
+  }
+  return quotient < max_value ? quotient : max_value;
+}
+
+// float of the int32 bits of value, as __bang_int322float after a bitwise and
+static float maskedFloat(int32_t value, uint32_t mask) {
+  uint32_t bits = (uint32_t)value & mask;
+  int32_t masked;
+  memcpy(&masked, &bits, sizeof(masked));
+  return (float)masked;
+}
+
+// floor(v * scale) of floorScaled, __bang_float2int32_rd and back
+static float floorScaled(float v, float scale) {
+  return floorf(v * scale);
+}
+
+// |v| of absInt32Halves, hi in units of 2^16 and lo in [0, 2^16), the sign in sign.
+static void absHalves(int32_t v, float &hi, float &lo, float &sign) {
+  hi   = maskedFloat(v, 0xffff0000u);
+  lo   = maskedFloat(v, 0x0000ffffu);
+  sign = (float)(hi < 0) * -2.0f + 1.0f;
+  hi *= sign;
+  lo *= sign;
+  float borrow = (float)(lo < 0) * INT_HALF_SCALE;
+  hi -= borrow;
+  lo += borrow;
+  hi *= 1.0f / INT_HALF_SCALE;
+}
+
+// The divisor limbs of int32Divisor: b = hi * 2^16 + l1 * 2^8 + l0.
+struct Divisor {
+  float hi, lo, l1, l0, recip;
+};
+
+// int32Remainder: (rh * 2^16 + rl) = (th * 2^16 + tl) - q * b
+static void remainder(float th, float tl, float q, const Divisor &b, float &rh, float &rl) {
+  rh         = th - q * b.hi;
+  float p    = q * b.l1;
+  float p_hi = floorScaled(p, 1.0f / 256);
+  rh -= p_hi;
+  rl = tl - (p - p_hi * 256.0f) * 256.0f;
+  p    = q * b.l0;
+  p_hi = floorScaled(p, 1.0f / INT_HALF_SCALE);
+  rh -= p_hi;
+  rl -= p - p_hi * INT_HALF_SCALE;
+}
+
+// int32DivDigit: q = floor((th * 2^16 + tl) / b) in [0, 2^16) and its remainder
+static float divDigit(float th, float tl, const Divisor &b, float &rh, float &rl) {
+  float q = roundToInteger((th * INT_HALF_SCALE + tl) * b.recip);
+  remainder(th, tl, q, b, rh, rl);
+  q -= (float)(rh * INT_HALF_SCALE + rl < 0);
+  q += (float)((rh - b.hi) * INT_HALF_SCALE + (rl - b.lo) >= 0);
+  remainder(th, tl, q, b, rh, rl);
+  return q;
+}
+
+// divInt32 of kernels/div/div_device.mlu
+static int32_t deviceDivideInt32(int32_t dividend, int32_t divisor, bool floor_mode,
+                                 float delta) {
+  float a_hi, a_lo, a_sign, b_sign;
+  Divisor b;
+  absHalves(dividend, a_hi, a_lo, a_sign);
+  absHalves(divisor, b.hi, b.lo, b_sign);
+  float zero = (float)(b.hi + b.lo == 0);
+  b.lo += zero;
+  a_hi *= 1.0f - zero;
+  a_lo *= 1.0f - zero;
+  b.l1 = floorScaled(b.lo, 1.0f / 256);
+  b.l0 = b.lo - b.l1 * 256.0f;
+  // the reciprocal to 2^-12 and a Newton step
+  float b_float = b.hi * INT_HALF_SCALE + b.lo;
+  b.recip       = (1.0f / b_float) * (1.0f + delta);
+  float e       = b_float * b.recip * -1.0f + 1.0f;
+  b.recip += b.recip * e;
+  // long division of |x| by |y| in two 16-bit digits
+  float rh, rl;
+  float q_hi = divDigit(0.0f, a_hi, b, rh, rl);
+  float r_hi = rh * INT_HALF_SCALE + rl;
+  float q_lo = divDigit(r_hi, a_lo, b, rh, rl);
+  float sign = a_sign * b_sign;
+  float hi   = q_hi * INT_HALF_SCALE * sign;
+  float lo   = q_lo * sign;
+  if (floor_mode) {
+    lo -= (float)(sign < 0) * (float)(rh * INT_HALF_SCALE + rl != 0);
+  }
+  float borrow = (float)(lo < 0) * INT_HALF_SCALE;
+  hi -= borrow;
+  lo += borrow;
+  // MIN / -1 to the max
+  float over = (float)(hi > INT32_MAX_FLOAT);
+  lo += over * (INT_HALF_SCALE - 1.0f);
+  hi -= over * INT_HALF_SCALE;
+  return (int32_t)((uint32_t)(int32_t)hi | (uint32_t)(int32_t)lo);
+}
+
+static int64_t checkPair(const char *dtype, int32_t x, int32_t y, float max_value) {
+  const float deltas[] = {0.0f, 1.0f / 4096, -1.0f / 4096};
+  int64_t checked = 0;
+  bool is_int32   = strcmp(dtype, "int32") == 0;
+  for (int mode = 0; mode < 2; ++mode) {
+    int64_t expected = hostDivide(x, y, mode == 1, is_int32 ? INT32_MAX : (int64_t)max_value);
+    for (float delta : deltas) {
+      int64_t result = is_int32 ? deviceDivideInt32(x, y, mode == 1, delta)
+                                : deviceDivide(x, y, mode == 1, max_value, delta);
+      checked++;
+      if (result != expected) {
+        if (failed_num < 20) {
+          printf("FAIL %s %s %d / %d, delta %g: %lld, expected %lld\n", dtype,
+                 mode == 1 ? "floor" : "trunc", x, y, delta, (long long)result,
+                 (long long)expected);
+        }
+        failed_num++;
+      }
+    }
+  }
+  return checked;
+}
+
+// edge and random pairs of [low, high]
+static int64_t checkRange(const char *dtype, int32_t low, int32_t high, float max_value,
+                          int random_num) {
+  std::vector<int32_t> edges = {0, 1, -1, 2, -2, 3, -3, 7, -7, 255, -256, low, low + 1, high,
+                                high - 1, high / 2, low / 2};
+  int64_t checked = 0;
+  for (int32_t x : edges) {
+    for (int32_t y : edges) {
+      checked += checkPair(dtype, x, y, max_value);
+    }
+  }
+  std::mt19937 random(2021);
+  std::uniform_int_distribution<int32_t> dist(low, high);
+  std::uniform_int_distribution<int32_t> small(-300, 300);
+  for (int i = 0; i < random_num; ++i) {
+    int32_t x = dist(random);
+    checked += checkPair(dtype, x, dist(random), max_value);
+    checked += checkPair(dtype, x, small(random), max_value);
+  }
+  return checked;
+}
+
+// int32 edges, the 2^16 digits, 2^24 and MIN / -1, against each other, and random pairs with
+// uniform, small and log-uniform divisors.
+static int64_t checkInt32(int random_num) {
+  std::vector<int32_t> edges = {0, 1, -1, 2, -2, 3, -3, 7, -7, 255, -256, 256, 257, 65535,
+                                -65535, 65536, -65536, 65537, -65537, 131071, 46341, -46341,
+                                (1 << 24) - 1, 1 << 24, (1 << 24) + 1, -(1 << 24) - 1,
+                                (1 << 24) + 3, 1 << 30, -(1 << 30) - 7, 2147418112, 2147483520,
+                                INT32_MAX, INT32_MAX - 1, INT32_MAX / 2, INT32_MIN,
+                                INT32_MIN + 1, INT32_MIN / 2, INT32_MIN + 65535,
+                                INT32_MIN + 65536};
+  int64_t checked = 0;
+  for (int32_t x : edges) {
+    for (int32_t y : edges) {
+      checked += checkPair("int32", x, y, INT32_MAX_FLOAT);
+    }
+  }
+  std::mt19937 random(2021);
+  std::uniform_int_distribution<int32_t> dist(INT32_MIN, INT32_MAX);
+  std::uniform_int_distribution<int32_t> small(-300, 300);
+  std::uniform_int_distribution<int> bits(0, 31);
+  for (int i = 0; i < random_num; ++i) {
+    int32_t x = dist(random);
+    checked += checkPair("int32", x, dist(random), INT32_MAX_FLOAT);
+    checked += checkPair("int32", x, small(random), INT32_MAX_FLOAT);
+    checked += checkPair("int32", x, dist(random) >> bits(random), INT32_MAX_FLOAT);
+  }
+  return checked;
+}
+
+// absInt32 of kernels/abs/abs_device.mlu
+static int32_t deviceAbsInt32(int32_t x) {
+  float hi = maskedFloat(x, 0xffff0000u);
+  float lo = maskedFloat(x, 0x0000ffffu);
+  float t  = (float)(hi < 0) * -2.0f + 1.0f;
+  hi *= t;
+  lo *= t;
+  t = (float)(lo < 0) * INT_HALF_SCALE;
+  hi -= t;
+  lo += t;
+  lo += (float)(hi > INT32_MAX_FLOAT) * (INT_HALF_SCALE - 1.0f);
+  hi -= (float)(hi > INT32_MAX_FLOAT) * INT_HALF_SCALE;
+  // the halves are whole and apart, the bitwise or of joinInt32 is their sum
+  return (int32_t)((uint32_t)(int32_t)hi | (uint32_t)(int32_t)lo);
+}
+
+static int64_t checkAbsInt32() {
+  std::vector<int32_t> values = {0, 1, -1, 65535, -65535, 65536, -65536, 65537, -65537,
+                                 (1 << 24) + 1, -(1 << 24) - 1, (1 << 24) + 3, -(1 << 30) - 7,
+                                 INT32_MAX, INT32_MAX - 1, INT32_MIN, INT32_MIN + 1,
+                                 INT32_MIN + 65536, INT32_MIN + 65535};
+  std::mt19937 random(2021);
+  std::uniform_int_distribution<int32_t> dist(INT32_MIN, INT32_MAX);
+  for (int i = 0; i < 2000000; ++i) {
+    values.push_back(dist(random));
+  }
+  for (int32_t x : values) {
+    int64_t expected = x == INT32_MIN ? INT32_MAX : (x < 0 ? -(int64_t)x : x);
+    int32_t result   = deviceAbsInt32(x);
+    if (result != expected) {
+      if (failed_num < 20) {
+        printf("FAIL int32 abs %d: %d, expected %lld\n", x, result, (long long)expected);
+      }
+      failed_num++;
+    }
+  }
+  return (int64_t)values.size();
+}
+
+int main() {
+  int64_t checked = 0;
+  for (int32_t x = -128; x <= 127; ++x) {
+    for (int32_t y = -128; y <= 127; ++y) {
+      checked += checkPair("int8", x, y, 127.0f);
+    }
+  }
+  checked += checkRange("int16", -32768, 32767, 32767.0f, 500000);
+  checked += checkInt32(500000);
+  int64_t quotient_failed = failed_num;
+  printf("%lld/%lld integer quotients passed\n", (long long)(checked - quotient_failed),
+         (long long)checked);
+  int64_t abs_checked = checkAbsInt32();
+  printf("%lld/%lld int32 abs passed\n", (long long)(abs_checked - (failed_num - quotient_failed)),
+         (long long)abs_checked);
+  return failed_num == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,159 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Prints the NRAM/SRAM use of every kernel variant and pipeline depth as planned by
+// kernels/layout_planner.h, fails if a layout does not fit. usage: ./layout_report [nram_kb]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "kernels/abs/abs_layout.h"
+#include "kernels/adam_update/adam_update_layout.h"
+#include "kernels/div/div_layout.h"
+#include "kernels/log/log_layout.h"
+#include "kernels/reciprocal/reciprocal_layout.h"
+#include "kernels/reduce/reduce_layout.h"
+#include "kernels/rmsprop_update/rmsprop_update_layout.h"
+#include "kernels/sqrt/sqrt_layout.h"
+#include "kernels/sqrt_backward/sqrt_backward_layout.h"
+#include "kernels/pipeline_schedule.h"
+
+#define REPORT_NRAM_KB 384  // MAX_NRAM_SIZE of MLU270
+#define REPORT_CORE_DIM 4   // CORE_DIM of kernels/kernel.h
+
+// optimizer: also abs_sign, reduce: the depth 2 ping-pong only
+enum Stage { STAGE_3, STAGE_5, STAGE_BINARY, STAGE_OPTIMIZER, STAGE_REDUCE };
+
+struct LayoutEntry {
+  const char *op;
+  const char *variant;
+  int elem_size;
+  Stage stage;
+  LayoutSpec spec;                 // 5stage
+  LayoutSpec (*layout)(int, int);  // 3stage, planned for every pipeline depth
+};
+
+static const LayoutEntry entries[] = {
+    {"abs", "3Stage Fast", 4, STAGE_3, {}, abs3FastLayout},
+    {"abs", "3Stage Fast", 2, STAGE_3, {}, abs3FastLayout},
+    {"abs", "5Stage Fast", 4, STAGE_5, abs5FastLayout(4), NULL},
+    {"abs", "5Stage Fast", 2, STAGE_5, abs5FastLayout(2), NULL},
+    {"abs_sign", "3Stage Fast", 4, STAGE_OPTIMIZER, {}, absSign3FastLayout},
+    {"abs_sign", "3Stage Fast", 2, STAGE_OPTIMIZER, {}, absSign3FastLayout},
+    {"abs", "3Stage Int", 4, STAGE_3, {}, absInt3FastLayout},
+    {"abs", "3Stage Int", 2, STAGE_3, {}, absInt3FastLayout},
+    {"abs", "3Stage Int", 1, STAGE_3, {}, absInt3FastLayout},
+    {"log", "3Stage Fast", 4, STAGE_3, {}, log3FastLayout},
+    {"log", "3Stage Fast", 2, STAGE_3, {}, log3FastLayout},
+    {"log", "3Stage HighAcc", 2, STAGE_3, {}, log3HighAccLayout},
+    {"log", "3Stage Approx", 4, STAGE_3, {}, log3ApproxLayout},
+    {"log", "3Stage Approx", 2, STAGE_3, {}, log3ApproxLayout},
+    {"log", "5Stage Fast", 4, STAGE_5, log5FastLayout(4), NULL},
+    {"log", "5Stage Fast", 2, STAGE_5, log5FastLayout(2), NULL},
+    {"log", "5Stage HighAcc", 2, STAGE_5, log5HighAccLayout(2), NULL},
+    {"log", "5Stage Approx", 4, STAGE_5, log5ApproxLayout(4), NULL},
+    {"log", "5Stage Approx", 2, STAGE_5, log5ApproxLayout(2), NULL},
+    {"sqrt", "3Stage Fast", 4, STAGE_3, {}, sqrt3FastLayout},
+    {"sqrt", "3Stage Fast", 2, STAGE_3, {}, sqrt3FastLayout},
+    {"sqrt", "3Stage HighAcc", 2, STAGE_3, {}, sqrt3HighAccLayout},
+    {"sqrt", "3Stage Approx", 4, STAGE_3, {}, sqrt3ApproxLayout},
+    {"sqrt", "3Stage Approx", 2, STAGE_3, {}, sqrt3ApproxLayout},
+    {"sqrt", "5Stage Fast", 4, STAGE_5, sqrt5FastLayout(4), NULL},
+    {"sqrt", "5Stage Fast", 2, STAGE_5, sqrt5FastLayout(2), NULL},
+    {"sqrt", "5Stage HighAcc", 2, STAGE_5, sqrt5HighAccLayout(2), NULL},
+    {"sqrt", "5Stage Approx", 4, STAGE_5, sqrt5ApproxLayout(4), NULL},
+    {"sqrt", "5Stage Approx", 2, STAGE_5, sqrt5ApproxLayout(2), NULL},
+    {"reciprocal", "3Stage Fast", 4, STAGE_3, {}, reciprocal3FastLayout},
+    {"reciprocal", "3Stage Fast", 2, STAGE_3, {}, reciprocal3FastLayout},
+    {"reciprocal", "3Stage HighAcc", 2, STAGE_3, {}, reciprocal3HighAccLayout},
+    {"reciprocal", "5Stage Fast", 4, STAGE_5, reciprocal5FastLayout(4), NULL},
+    {"reciprocal", "5Stage Fast", 2, STAGE_5, reciprocal5FastLayout(2), NULL},
+    {"reciprocal", "5Stage HighAcc", 2, STAGE_5, reciprocal5HighAccLayout(2), NULL},
+    {"div", "3Stage Fast", 4, STAGE_BINARY, {}, div3Layout},
+    {"div", "3Stage Fast", 2, STAGE_BINARY, {}, div3Layout},
+    {"div", "3Stage HighAcc", 2, STAGE_BINARY, {}, div3Layout},
+    {"div", "3Stage Int", 4, STAGE_BINARY, {}, divInt3Layout},
+    {"div", "3Stage Int", 2, STAGE_BINARY, {}, divInt3Layout},
+    {"div", "3Stage Int", 1, STAGE_BINARY, {}, divInt3Layout},
+    {"sqrt_backward", "3Stage Fast", 4, STAGE_BINARY, {}, sqrtBackward3FastLayout},
+    {"sqrt_backward", "3Stage HighAcc", 2, STAGE_BINARY, {}, sqrtBackward3HighAccLayout},
+    {"adam_update", "3Stage Fast", 4, STAGE_OPTIMIZER, {}, adamUpdate3Layout},
+    {"adam_update", "3Stage HighAcc", 2, STAGE_OPTIMIZER, {}, adamUpdate3Layout},
+    {"rmsprop_update", "3Stage Fast", 4, STAGE_OPTIMIZER, {}, rmspropUpdate3Layout},
+    {"rmsprop_update", "3Stage HighAcc", 2, STAGE_OPTIMIZER, {}, rmspropUpdate3Layout},
+    {"reduce_sum", "3Stage Fast", 4, STAGE_REDUCE, {}, reduce3Layout},
+    {"reduce_sum", "3Stage HighAcc", 2, STAGE_REDUCE, {}, reduce3Layout},
+    {"reduce_max", "3Stage Fast", 4, STAGE_REDUCE, {}, reduce3Layout},
+    {"reduce_max", "3Stage HighAcc", 2, STAGE_REDUCE, {}, reduce3Layout},
+    {"logsumexp", "3Stage Fast", 4, STAGE_REDUCE, {}, logSumExp3Layout},
+    {"logsumexp", "3Stage HighAcc", 2, STAGE_REDUCE, {}, logSumExp3Layout},
+};
+
+static const char *dtypeName(const LayoutEntry &entry) {
+  if (strstr(entry.variant, "Int") != NULL) {
+    return entry.elem_size == 1 ? "int8" : entry.elem_size == 2 ? "int16" : "int32";
+  }
+  return entry.elem_size == 4 ? "float" : "half";
+}
+
+int main(int argc, char *argv[]) {
+  int nram_bytes = (argc > 1 ? atoi(argv[1]) : REPORT_NRAM_KB) * 1024;
+  int sram_bytes = REPORT_CORE_DIM * nram_bytes;
+  if (nram_bytes <= 0) {
+    fprintf(stderr, "usage: %s [nram_kb]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  printf("NRAM %d KB, SRAM %d KB, core_dim %d\n", nram_bytes / 1024, sram_bytes / 1024,
+         REPORT_CORE_DIM);
+  printf("%-15s %-15s %-6s %5s %9s %10s %7s %10s %7s\n", "op", "variant", "dtype", "depth",
+         "num_deal", "nram", "nram%", "sram", "sram%");
+  int failed = 0;
+  for (const LayoutEntry &entry : entries) {
+    int depth_num = entry.stage == STAGE_5 || entry.stage == STAGE_REDUCE
+                        ? 1
+                        : PIPELINE_MAX_DEPTH - PIPELINE_MIN_DEPTH + 1;
+    for (int i = 0; i < depth_num; ++i) {
+      int depth     = PIPELINE_MIN_DEPTH + i;
+      int num_deal  = 0;
+      int slot_num  = 0;
+      int sram_used = 0;
+      LayoutSpec spec = entry.spec;
+      if (entry.stage == STAGE_5) {
+        num_deal  = planNumDeal5Stage(spec, nram_bytes, sram_bytes, entry.elem_size,
+                                      REPORT_CORE_DIM);
+        slot_num  = num_deal + spec.align;
+        sram_used = planUsedBytes(sramPipelineLayout(entry.elem_size, REPORT_CORE_DIM),
+                                  entry.elem_size, num_deal);
+      } else {
+        spec     = entry.layout(entry.elem_size, depth);
+        num_deal = planNumDeal(spec, nram_bytes, entry.elem_size);
+        slot_num = num_deal;
+      }
+      int nram_used = planUsedBytes(spec, entry.elem_size, slot_num);
+      bool fit = num_deal > 0 && nram_used <= nram_bytes && sram_used <= sram_bytes;
+      printf("%-15s %-15s %-6s", entry.op, entry.variant, dtypeName(entry));
+      if (entry.stage == STAGE_5) {
+        printf(" %5s", "-");
+      } else {
+        printf(" %5d", depth);
+      }
+      printf(" %9d %10d %6.1f%%", num_deal, nram_used, 100.0 * nram_used / nram_bytes);
+      if (entry.stage == STAGE_5) {
+        printf(" %10d %6.1f%%", sram_used, 100.0 * sram_used / sram_bytes);
+      } else {
+        printf(" %10s %7s", "-", "-");
+      }
+      printf("%s\n", fit ? "" : "  OVERFLOW");
+      failed += fit ? 0 : 1;
+    }
+  }
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,239 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sstream>
+#include "npy_file.h"
+
+#define NPY_MAGIC "\x93NUMPY"
+#define NPY_MAGIC_SIZE 6
+
+size_t NpyHeader::elementNum() const {
+  size_t num = 1;
+  for (auto dim : shape) {
+    num *= dim;
+  }
+  return num;
+}
+
+size_t NpyHeader::itemSize() const {
+  const char *descrs[] = {"<f2", "<f4", "|i1", "<i2", "<i4"};
+  const size_t sizes[] = {2, 4, 1, 2, 4};
+  for (int i = 0; i < 5; ++i) {
+    if (descr == descrs[i]) {
+      return sizes[i];
+    }
+  }
+  return 0;
+}
+
+// the value text of 'key' in the header dict, up to the next ',' or the closing ')' of a tuple
+static bool findValue(const std::string &dict, const std::string &key, std::string &value) {
+  size_t pos = dict.find("'" + key + "'");
+  if (pos == std::string::npos) {
+    return false;
+  }
+  pos = dict.find(':', pos);
+  if (pos == std::string::npos) {
+    return false;
+  }
+  pos = dict.find_first_not_of(' ', pos + 1);
+  if (pos == std::string::npos) {
+    return false;
+  }
+  size_t end = dict[pos] == '(' ? dict.find(')', pos) + 1 : dict.find_first_of(",}", pos);
+  if (end == std::string::npos || end == 0) {
+    return false;
+  }
+  value = dict.substr(pos, end - pos);
+  while (!value.empty() && value[value.size() - 1] == ' ') {
+    value.erase(value.size() - 1);
+  }
+  return true;
+}
+
+bool parseNpyHeader(const char *data, size_t size, NpyHeader &header, std::string &error) {
+  if (size < NPY_MAGIC_SIZE + 4 || memcmp(data, NPY_MAGIC, NPY_MAGIC_SIZE) != 0) {
+    error = "not a npy file";
+    return false;
+  }
+  // version 1.0 has a 2-byte header length, 2.0 and 3.0 a 4-byte one
+  const unsigned char *bytes = (const unsigned char *)data;
+  int major                  = bytes[NPY_MAGIC_SIZE];
+  size_t length_size         = major == 1 ? 2 : 4;
+  if (major < 1 || major > 3 || size < NPY_MAGIC_SIZE + 2 + length_size) {
+    error = "unsupported npy version";
+    return false;
+  }
+  size_t header_size = 0;
+  for (size_t i = 0; i < length_size; ++i) {
+    header_size |= (size_t)bytes[NPY_MAGIC_SIZE + 2 + i] << (8 * i);
+  }
+  header.data_offset = NPY_MAGIC_SIZE + 2 + length_size + header_size;
+  if (header.data_offset > size) {
+    error = "truncated npy header";
+    return false;
+  }
+  std::string dict(data + NPY_MAGIC_SIZE + 2 + length_size, header_size);
+
+  std::string descr, order, shape;
+  if (!findValue(dict, "descr", descr) || !findValue(dict, "fortran_order", order) ||
+      !findValue(dict, "shape", shape)) {
+    error = "npy header misses descr, fortran_order or shape";
+    return false;
+  }
+  if (descr.size() != 5 || (descr[0] != '\'' && descr[0] != '"')) {
+    error = "unsupported npy descr " + descr;
+    return false;
+  }
+  header.descr = descr.substr(1, 3);
+  if (header.descr[0] == '=') {
+    header.descr[0] = '<';
+  }
+  if (header.descr[1] == 'i' && header.descr[2] == '1') {
+    header.descr[0] = '|';
+  }
+  if (header.itemSize() == 0) {
+    error = "unsupported npy descr " + descr + ", only little-endian f2, f4, i1, i2 and i4";
+    return false;
+  }
+  if (order != "False") {
+    error = "fortran order npy is not supported";
+    return false;
+  }
+
+  header.shape.clear();
+  if (shape.size() < 2 || shape[0] != '(' || shape[shape.size() - 1] != ')') {
+    error = "invalid npy shape " + shape;
+    return false;
+  }
+  std::stringstream dims(shape.substr(1, shape.size() - 2));
+  std::string dim;
+  while (std::getline(dims, dim, ',')) {
+    size_t begin = dim.find_first_not_of(' ');
+    if (begin == std::string::npos) {
+      continue;  // the trailing comma of (n,)
+    }
+    char *end  = NULL;
+    long value = strtol(dim.c_str() + begin, &end, 10);
+    if (end == dim.c_str() + begin || value < 0 || value > INT32_MAX) {
+      error = "invalid npy shape " + shape;
+      return false;
+    }
+    header.shape.push_back((int)value);
+  }
+  return true;
+}
+
+std::string formatNpyHeader(const std::string &descr, const std::vector<int> &shape) {
+  std::stringstream dict;
+  dict << "{'descr': '" << descr << "', 'fortran_order': False, 'shape': (";
+  for (size_t i = 0; i < shape.size(); ++i) {
+    dict << shape[i] << (i + 1 < shape.size() ? ", " : (shape.size() == 1 ? "," : ""));
+  }
+  dict << "), }";
+  // the header ends with a newline at the alignment
+  std::string text     = dict.str();
+  size_t prefix_size   = NPY_MAGIC_SIZE + 2 + 2;
+  size_t header_size   = text.size() + 1;
+  header_size          = (prefix_size + header_size + NPY_ALIGN - 1) / NPY_ALIGN * NPY_ALIGN -
+                         prefix_size;
+  text.append(header_size - 1 - text.size(), ' ');
+  text += '\n';
+  std::string prefix(NPY_MAGIC, NPY_MAGIC_SIZE);
+  prefix += (char)1;
+  prefix += (char)0;
+  prefix += (char)(header_size & 0xff);
+  prefix += (char)(header_size >> 8);
+  return prefix + text;
+}
+
+bool MappedNpy::open(const std::string &path, std::string &error) {
+  close();
+  int fd = ::open(path.c_str(), O_RDONLY);
+  struct stat file_stat;
+  if (fd < 0 || fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    error = "can not open " + path + (fd < 0 ? std::string(": ") + strerror(errno) : "");
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    return false;
+  }
+  map_size_ = file_stat.st_size;
+  map_      = mmap(NULL, map_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map_ == MAP_FAILED) {
+    map_ = NULL;
+    error = "can not map " + path + ": " + strerror(errno);
+    return false;
+  }
+  if (!parseNpyHeader((const char *)map_, map_size_, header_, error)) {
+    error = path + ": " + error;
+    close();
+    return false;
+  }
+  if (header_.data_offset + dataBytes() > map_size_) {
+    error = path + ": the data is shorter than the shape";
+    close();
+    return false;
+  }
+  // the data is read once, front to back
+  madvise(map_, map_size_, MADV_SEQUENTIAL);
+  return true;
+}
+
+bool MappedNpy::create(const std::string &path,
+                       const std::string &descr,
+                       const std::vector<int> &shape,
+                       std::string &error) {
+  close();
+  std::string text = formatNpyHeader(descr, shape);
+  if (!parseNpyHeader(text.data(), text.size(), header_, error)) {
+    return false;
+  }
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    error = "can not create " + path + ": " + strerror(errno);
+    return false;
+  }
+  map_size_ = text.size() + dataBytes();
+  if (ftruncate(fd, map_size_) != 0) {
+    error = "can not resize " + path + ": " + strerror(errno);
+    ::close(fd);
+    return false;
+  }
+  map_ = mmap(NULL, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map_ == MAP_FAILED) {
+    map_ = NULL;
+    error = "can not map " + path + ": " + strerror(errno);
+    return false;
+  }
+  memcpy(map_, text.data(), text.size());
+  return true;
+}
+
+void MappedNpy::close() {
+  if (map_ != NULL) {
+    munmap(map_, map_size_);
+  }
+  map_      = NULL;
+  map_size_ = 0;
+  header_   = NpyHeader();
+}
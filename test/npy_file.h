@@ -0,0 +1,76 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef TEST_NPY_FILE_H_
+#define TEST_NPY_FILE_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/* Memory-mapped .npy files of test_example --input and --dump_output, host only.
+ *
+ * A file is the magic "\x93NUMPY", a version, the length of the header and the header, a
+ * python dict such as {'descr': '<f2', 'fortran_order': False, 'shape': (64, 4096), }, padded
+ * with spaces so that the data starts at a multiple of NPY_ALIGN. The data is used where it
+ * is mapped: an input is copied to the device from the file pages and an output is copied
+ * from the device into them, without a host buffer in between.
+ * Only little-endian C order arrays of '<f2', '<f4', '|i1', '<i2' and '<i4' are supported.
+ */
+#define NPY_ALIGN 64
+
+struct NpyHeader {
+  std::string descr;  // '<f2' and the like, a native '=' is written as '<'
+  std::vector<int> shape;
+  size_t data_offset = 0;  // bytes before the data
+
+  size_t elementNum() const;
+  size_t itemSize() const;  // 0 for an unsupported descr
+};
+
+/* Parses the header of a file of size bytes starting at data, returns false with error set
+ * for a malformed or unsupported header.
+ */
+bool parseNpyHeader(const char *data, size_t size, NpyHeader &header, std::string &error);
+
+// The header text of descr and shape, padded to NPY_ALIGN, with the magic and the version 1.0.
+std::string formatNpyHeader(const std::string &descr, const std::vector<int> &shape);
+
+class MappedNpy {
+ public:
+  MappedNpy() {}
+  ~MappedNpy() { close(); }
+
+  // Maps path read only, the whole payload must be in the file.
+  bool open(const std::string &path, std::string &error);
+
+  // Creates path with the header of descr and shape, the data is mapped writable and zero.
+  bool create(const std::string &path,
+              const std::string &descr,
+              const std::vector<int> &shape,
+              std::string &error);
+
+  void close();
+
+  const NpyHeader &header() const { return header_; }
+  void *data() const { return (char *)map_ + header_.data_offset; }
+  size_t dataBytes() const { return header_.elementNum() * header_.itemSize(); }
+
+ private:
+  MappedNpy(const MappedNpy &);
+  MappedNpy &operator=(const MappedNpy &);
+
+  void *map_       = NULL;
+  size_t map_size_ = 0;
+  NpyHeader header_;
+};
+
+#endif  // TEST_NPY_FILE_H_
@@ -0,0 +1,136 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Checks the .npy files of test_example --input and --dump_output on the host.
+// usage: ./npy_file_test
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "npy_file.h"
+
+static int failed_num = 0;
+
+#define EXPECT(cond)                                       \
+  if (!(cond)) {                                           \
+    printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+    failed_num++;                                          \
+  }
+
+// a file as numpy.save writes it, version 1.0 and the dict padded to 64 bytes
+static std::string numpyFile(const std::string &dict, const std::string &data) {
+  std::string header = dict;
+  size_t size        = (10 + header.size() + 1 + 63) / 64 * 64 - 10;
+  header.append(size - 1 - header.size(), ' ');
+  header += '\n';
+  std::string file("\x93NUMPY\x01\x00", 8);
+  file += (char)(size & 0xff);
+  file += (char)(size >> 8);
+  return file + header + data;
+}
+
+static void writeFile(const std::string &path, const std::string &text) {
+  std::ofstream file(path.c_str(), std::ios::binary);
+  file.write(text.data(), text.size());
+}
+
+static void testHeader() {
+  NpyHeader header;
+  std::string error;
+  std::string file =
+      numpyFile("{'descr': '<f2', 'fortran_order': False, 'shape': (64, 4096), }", "");
+  EXPECT(parseNpyHeader(file.data(), file.size(), header, error));
+  EXPECT(header.descr == "<f2" && header.itemSize() == 2 && header.data_offset == 128);
+  EXPECT(header.shape.size() == 2 && header.shape[0] == 64 && header.shape[1] == 4096);
+  EXPECT(header.elementNum() == 64 * 4096);
+
+  file = numpyFile("{'descr': '|i1', 'fortran_order': False, 'shape': (7,), }", "");
+  EXPECT(parseNpyHeader(file.data(), file.size(), header, error));
+  EXPECT(header.descr == "|i1" && header.shape.size() == 1 && header.shape[0] == 7);
+  file = numpyFile("{'descr': '=i4', 'fortran_order': False, 'shape': (2, 3, 4), }", "");
+  EXPECT(parseNpyHeader(file.data(), file.size(), header, error) && header.descr == "<i4");
+  file = numpyFile("{'descr': '<f4', 'fortran_order': False, 'shape': (), }", "");
+  EXPECT(parseNpyHeader(file.data(), file.size(), header, error) && header.shape.empty());
+
+  // the header of formatNpyHeader is the one of numpy
+  std::string formatted = formatNpyHeader("<f4", {3});
+  EXPECT(formatted ==
+         numpyFile("{'descr': '<f4', 'fortran_order': False, 'shape': (3,), }", ""));
+  EXPECT(formatted.size() % NPY_ALIGN == 0);
+  formatted = formatNpyHeader("<i2", {2, 1024, 1024, 3, 5, 7, 11, 13});
+  EXPECT(formatted.size() % NPY_ALIGN == 0 && formatted[formatted.size() - 1] == '\n');
+  EXPECT(parseNpyHeader(formatted.data(), formatted.size(), header, error));
+  EXPECT(header.shape.size() == 8 && header.shape[7] == 13);
+
+  std::string bad_magic = "\x93NUMPZ" + file.substr(6);
+  EXPECT(!parseNpyHeader(bad_magic.data(), bad_magic.size(), header, error));
+  EXPECT(error == "not a npy file");
+  file = numpyFile("{'descr': '>f4', 'fortran_order': False, 'shape': (3,), }", "");
+  EXPECT(!parseNpyHeader(file.data(), file.size(), header, error));
+  file = numpyFile("{'descr': '<f8', 'fortran_order': False, 'shape': (3,), }", "");
+  EXPECT(!parseNpyHeader(file.data(), file.size(), header, error));
+  file = numpyFile("{'descr': '<f4', 'fortran_order': True, 'shape': (3, 2), }", "");
+  EXPECT(!parseNpyHeader(file.data(), file.size(), header, error));
+  EXPECT(error == "fortran order npy is not supported");
+  file = numpyFile("{'descr': '<f4', 'shape': (3,), }", "");
+  EXPECT(!parseNpyHeader(file.data(), file.size(), header, error));
+  EXPECT(!parseNpyHeader(file.data(), 40, header, error) && error == "truncated npy header");
+}
+
+static void testMap() {
+  char path[] = "/tmp/npy_file_test_XXXXXX";
+  int fd      = mkstemp(path);
+  EXPECT(fd >= 0);
+  close(fd);
+  std::string error;
+
+  float values[6] = {1, -2, 3.5f, 0, 1e-3f, 65504};
+  std::string data((const char *)values, sizeof(values));
+  writeFile(path, numpyFile("{'descr': '<f4', 'fortran_order': False, 'shape': (2, 3), }", data));
+  {
+    MappedNpy npy;
+    EXPECT(npy.open(path, error));
+    EXPECT(npy.header().shape.size() == 2 && npy.dataBytes() == sizeof(values));
+    EXPECT(memcmp(npy.data(), values, sizeof(values)) == 0);
+  }
+
+  // a payload shorter than the shape
+  writeFile(path, numpyFile("{'descr': '<f4', 'fortran_order': False, 'shape': (2, 4), }", data));
+  MappedNpy npy;
+  EXPECT(!npy.open(path, error) && error.find("shorter") != std::string::npos);
+  EXPECT(!npy.open("/tmp/npy_file_test_missing.npy", error));
+
+  // a created file reads back, and its header is the one of numpy
+  int16_t halves[4] = {0x3c00, (int16_t)0xbc00, 0x7bff, 0};
+  {
+    MappedNpy output;
+    EXPECT(output.create(path, "<f2", {4}, error));
+    EXPECT(output.dataBytes() == sizeof(halves));
+    memcpy(output.data(), halves, sizeof(halves));
+  }
+  EXPECT(npy.open(path, error));
+  EXPECT(npy.header().descr == "<f2" && npy.header().elementNum() == 4);
+  EXPECT(npy.header().data_offset % NPY_ALIGN == 0);
+  EXPECT(memcmp(npy.data(), halves, sizeof(halves)) == 0);
+  npy.close();
+  unlink(path);
+}
+
+int main() {
+  testHeader();
+  testMap();
+  printf("%s npy_file_test\n", failed_num == 0 ? "PASS" : "FAIL");
+  return failed_num == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
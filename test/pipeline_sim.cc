@@ -0,0 +1,96 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Runs the 3stage schedule of kernels/pipeline_schedule.h on the host for every depth and
+// checks the stage ordering. usage: ./pipeline_sim [max_chunk_num]
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "kernels/pipeline_schedule.h"
+
+enum BufferState { BUFFER_FREE, BUFFER_LOADED, BUFFER_COMPUTED };
+
+struct Buffer {
+  BufferState state = BUFFER_FREE;
+  int chunk         = -1;
+  int step          = -1;  // step of the last transition, visible from step + 1 after sync
+};
+
+static int failed_num = 0;
+
+#define SIM_CHECK(cond, depth, chunk_num, step, msg)                                 \
+  if (!(cond)) {                                                                     \
+    printf("FAIL depth %d chunk_num %d step %d: %s\n", depth, chunk_num, step, msg); \
+    failed_num++;                                                                    \
+    return false;                                                                    \
+  }
+
+// The stages of a step are issued as in the kernels: store, load, compute, then sync.
+static bool simulate(int depth, int chunk_num) {
+  std::vector<Buffer> buffers(depth);
+  std::vector<int> stored(chunk_num, 0);
+  int next_store = 0;
+  int step_num   = pipelineStepNum(chunk_num, depth);
+  for (int step = 0; step < step_num; ++step) {
+    int store   = pipelineStoreChunk(step, chunk_num, depth);
+    int load    = pipelineLoadChunk(step, chunk_num);
+    int compute = pipelineComputeChunk(step, chunk_num, depth);
+    if (store >= 0) {
+      Buffer &buffer = buffers[store % depth];
+      SIM_CHECK(buffer.state == BUFFER_COMPUTED && buffer.chunk == store, depth, chunk_num, step,
+                "store of a chunk not computed");
+      SIM_CHECK(buffer.step < step, depth, chunk_num, step, "store before the compute synced");
+      SIM_CHECK(store == next_store, depth, chunk_num, step, "chunks stored out of order");
+      buffer.state = BUFFER_FREE;
+      buffer.step  = step;
+      stored[store]++;
+      next_store++;
+    }
+    if (load >= 0) {
+      Buffer &buffer = buffers[load % depth];
+      SIM_CHECK(buffer.state == BUFFER_FREE, depth, chunk_num, step,
+                "load into a buffer still in use");
+      // the ping-pong reloads the buffer stored in the same step, the store is issued first
+      SIM_CHECK(buffer.step < step || (depth == 2 && store >= 0 && store % depth == load % depth),
+                depth, chunk_num, step, "load into a buffer stored in the same step");
+      buffer.state = BUFFER_LOADED;
+      buffer.chunk = load;
+      buffer.step  = step;
+    }
+    if (compute >= 0) {
+      Buffer &buffer = buffers[compute % depth];
+      SIM_CHECK(buffer.state == BUFFER_LOADED && buffer.chunk == compute, depth, chunk_num, step,
+                "compute of a chunk not loaded");
+      SIM_CHECK(buffer.step < step, depth, chunk_num, step, "compute before the load synced");
+      SIM_CHECK(load < 0 || load % depth != compute % depth, depth, chunk_num, step,
+                "load and compute share a buffer");
+      buffer.state = BUFFER_COMPUTED;
+      buffer.step  = step;
+    }
+  }
+  for (int chunk = 0; chunk < chunk_num; ++chunk) {
+    SIM_CHECK(stored[chunk] == 1, depth, chunk_num, step_num, "chunk not stored once");
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  int max_chunk_num = argc > 1 ? atoi(argv[1]) : 64;
+  for (int depth = PIPELINE_MIN_DEPTH; depth <= PIPELINE_MAX_DEPTH; ++depth) {
+    int passed_num = 0;
+    for (int chunk_num = 0; chunk_num <= max_chunk_num; ++chunk_num) {
+      passed_num += simulate(depth, chunk_num) ? 1 : 0;
+    }
+    printf("depth %d: %d/%d schedules passed, %d chunks take %d steps\n", depth, passed_num,
+           max_chunk_num + 1, max_chunk_num, pipelineStepNum(max_chunk_num, depth));
+  }
+  return failed_num == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,149 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>  // NOLINT
+#include <vector>
+#include "random_data.h"
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+  uint32_t x[4] = {counter[0], counter[1], counter[2], counter[3]};
+  uint32_t k[2] = {key[0], key[1]};
+  for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+    uint64_t product0 = (uint64_t)PHILOX_M0 * x[0];
+    uint64_t product1 = (uint64_t)PHILOX_M1 * x[2];
+    uint32_t y[4]     = {(uint32_t)(product1 >> 32) ^ x[1] ^ k[0], (uint32_t)product1,
+                         (uint32_t)(product0 >> 32) ^ x[3] ^ k[1], (uint32_t)product0};
+    memcpy(x, y, sizeof(x));
+    k[0] += PHILOX_W0;
+    k[1] += PHILOX_W1;
+  }
+  memcpy(out, x, sizeof(x));
+}
+
+// [0, 1) with the 24 bits of a float
+static float uniform01(uint32_t word) {
+  return (word >> 8) * (1.0f / (1 << 24));
+}
+
+static float clampValue(float value, const RandomParam &param) {
+  return std::min(std::max(value, param.low), param.high);
+}
+
+static float uniformValue(uint32_t word, const RandomParam &param) {
+  float value = param.low + (param.high - param.low) * uniform01(word);
+  // the rounding of a wide range may reach high
+  return value < param.high ? value : std::nextafter(param.high, param.low);
+}
+
+static float specialValue(uint32_t word, const RandomParam &param) {
+  const float inf        = std::numeric_limits<float>::infinity();
+  const float specials[] = {0.0f,
+                            -0.0f,
+                            1.0f,
+                            -1.0f,
+                            param.low,
+                            param.high,
+                            std::numeric_limits<float>::min(),
+                            -std::numeric_limits<float>::min(),
+                            std::numeric_limits<float>::denorm_min(),
+                            65504.0f,  // the largest half
+                            inf,
+                            -inf,
+                            std::numeric_limits<float>::quiet_NaN()};
+  const int finite_num = 10, special_num = sizeof(specials) / sizeof(specials[0]);
+  if (param.finite) {
+    return clampValue(specials[word % finite_num], param);
+  }
+  return specials[word % special_num];
+}
+
+static float randomValue(size_t index, const RandomParam &param) {
+  uint32_t counter[4] = {(uint32_t)index, (uint32_t)((uint64_t)index >> 32), param.stream, 0};
+  uint32_t key[2]     = {(uint32_t)param.seed, (uint32_t)(param.seed >> 32)};
+  uint32_t word[4];
+  philox4x32(counter, key, word);
+  switch (param.dist) {
+    case RANDOM_NORMAL: {
+      // Box-Muller of two uniforms, the first in (0, 1]
+      double u1    = (word[0] + 1.0) / 4294967296.0;
+      double u2    = word[1] / 4294967296.0;
+      double gauss = std::sqrt(-2 * std::log(u1)) * std::cos(2 * M_PI * u2);
+      return clampValue((param.low + param.high) / 2 + gauss * (param.high - param.low) / 6, param);
+    }
+    case RANDOM_LOG_UNIFORM: {
+      float max_abs   = std::max(std::fabs(param.low), std::fabs(param.high));
+      float magnitude = max_abs * std::exp2(-RANDOM_LOG_OCTAVES * uniform01(word[0]));
+      bool negative   = param.high <= 0 || (param.low < 0 && (word[1] & 1));
+      return clampValue(negative ? -magnitude : magnitude, param);
+    }
+    case RANDOM_SPECIAL:
+      if (word[1] % RANDOM_SPECIAL_RATIO == 0) {
+        return specialValue(word[2], param);
+      }
+      return uniformValue(word[0], param);
+    default:
+      return uniformValue(word[0], param);
+  }
+}
+
+static void fillChunk(float *data, size_t begin, size_t end, const RandomParam &param) {
+  for (size_t i = begin; i < end; ++i) {
+    data[i] = randomValue(i, param);
+  }
+}
+
+void fillRandom(float *data, size_t num, const RandomParam &param, int threads) {
+  size_t thread_num = std::max((size_t)1, std::min((size_t)std::max(threads, 1),
+                                                   num / RANDOM_CHUNK_MIN));
+  size_t chunk      = (num + thread_num - 1) / thread_num;
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < thread_num; ++t) {
+    workers.push_back(
+        std::thread(fillChunk, data, t * chunk, std::min(num, (t + 1) * chunk), param));
+  }
+  fillChunk(data, 0, std::min(num, chunk), param);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+bool getRandomDist(const char *name, RandomDist &dist) {
+  for (int i = RANDOM_UNIFORM; i <= RANDOM_SPECIAL; ++i) {
+    if (strcmp(name, randomDistStr((RandomDist)i)) == 0) {
+      dist = (RandomDist)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+const char *randomDistStr(RandomDist dist) {
+  switch (dist) {
+    case RANDOM_NORMAL:
+      return "normal";
+    case RANDOM_LOG_UNIFORM:
+      return "log_uniform";
+    case RANDOM_SPECIAL:
+      return "special";
+    default:
+      return "uniform";
+  }
+}
@@ -0,0 +1,55 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef TEST_RANDOM_DATA_H_
+#define TEST_RANDOM_DATA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Random test data of test_example, host only.
+ *
+ * Element i of a stream is drawn from the Philox4x32-10 block of counter {i, stream} and key
+ * seed, so it does not depend on the other elements: the data is the same for a seed whatever
+ * the number of threads filling it, and the inputs of one case, streams 0, 1, ..., differ.
+ */
+#define RANDOM_CHUNK_MIN (1 << 16)  // elements of a thread at least
+#define RANDOM_LOG_OCTAVES 24       // binades of the log-uniform magnitudes
+#define RANDOM_SPECIAL_RATIO 8      // one element in 8 is special
+
+enum RandomDist {
+  RANDOM_UNIFORM     = 0,  // [low, high)
+  RANDOM_NORMAL      = 1,  // mean (low + high) / 2, (high - low) / 6 sigma, clamped to [low, high]
+  RANDOM_LOG_UNIFORM = 2,  // log-uniform magnitudes below max(|low|, |high|), clamped
+  RANDOM_SPECIAL     = 3,  // uniform, with zeros, ones, the ends, denormals, inf and nan
+};
+
+struct RandomParam {
+  RandomDist dist = RANDOM_UNIFORM;
+  float low       = -1;
+  float high      = 1;
+  bool finite     = false;  // special values clamped to [low, high], no inf or nan
+  uint64_t seed   = 0;
+  uint32_t stream = 0;
+};
+
+// The 4 words of Philox4x32 with 10 rounds for counter and key.
+void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+
+// Fills data[0, num) of param.stream on up to threads host threads.
+void fillRandom(float *data, size_t num, const RandomParam &param, int threads);
+
+// "uniform", "normal", "log_uniform" or "special", false for another name.
+bool getRandomDist(const char *name, RandomDist &dist);
+
+const char *randomDistStr(RandomDist dist);
+
+#endif  // TEST_RANDOM_DATA_H_
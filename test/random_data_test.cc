@@ -0,0 +1,190 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Checks the random test data of test_example on the host.
+// usage: ./random_data_test
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <vector>
+#include "random_data.h"
+
+static int failed_num = 0;
+
+#define EXPECT(cond)                                       \
+  if (!(cond)) {                                           \
+    printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+    failed_num++;                                          \
+  }
+
+static std::vector<float> generate(size_t num, const RandomParam &param, int threads) {
+  std::vector<float> data(num);
+  fillRandom(data.data(), num, param, threads);
+  return data;
+}
+
+// equal bit patterns, nan included
+static bool sameData(const std::vector<float> &a, const std::vector<float> &b) {
+  return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+static void testPhilox() {
+  // the known answers of Philox4x32-10 in Random123
+  uint32_t out[4];
+  const uint32_t zero_counter[4] = {0, 0, 0, 0}, zero_key[2] = {0, 0};
+  philox4x32(zero_counter, zero_key, out);
+  EXPECT(out[0] == 0x6627e8d5 && out[1] == 0xe169c58d && out[2] == 0xbc57ac4c &&
+         out[3] == 0x9b00dbd8);
+  const uint32_t ones_counter[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+  const uint32_t ones_key[2]     = {0xffffffff, 0xffffffff};
+  philox4x32(ones_counter, ones_key, out);
+  EXPECT(out[0] == 0x408f276d && out[1] == 0x41c83b0e && out[2] == 0xa20bc7c6 &&
+         out[3] == 0x6d5451fd);
+  const uint32_t pi_counter[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+  const uint32_t pi_key[2]     = {0xa4093822, 0x299f31d0};
+  philox4x32(pi_counter, pi_key, out);
+  EXPECT(out[0] == 0xd16cfe09 && out[1] == 0x94fdcceb && out[2] == 0x5001e420 &&
+         out[3] == 0x24126ea1);
+}
+
+static void testReproducible() {
+  size_t num = 4 * RANDOM_CHUNK_MIN + 123;
+  RandomParam param;
+  param.seed = 2021;
+  for (int dist = RANDOM_UNIFORM; dist <= RANDOM_SPECIAL; ++dist) {
+    param.dist                = (RandomDist)dist;
+    std::vector<float> single = generate(num, param, 1);
+    EXPECT(sameData(single, generate(num, param, 3)));
+    EXPECT(sameData(single, generate(num, param, 64)));
+    // a prefix is the same data
+    std::vector<float> prefix = generate(1000, param, 1);
+    EXPECT(memcmp(prefix.data(), single.data(), prefix.size() * sizeof(float)) == 0);
+  }
+
+  // the streams of one seed and the seeds of one stream differ
+  param.dist              = RANDOM_UNIFORM;
+  std::vector<float> base = generate(1024, param, 1);
+  param.stream            = 1;
+  std::vector<float> other_stream = generate(1024, param, 1);
+  param.stream                    = 0;
+  param.seed                      = 2022;
+  std::vector<float> other_seed   = generate(1024, param, 1);
+  int same_stream = 0, same_seed = 0;
+  for (size_t i = 0; i < base.size(); ++i) {
+    same_stream += base[i] == other_stream[i];
+    same_seed += base[i] == other_seed[i];
+  }
+  EXPECT(same_stream < 4 && same_seed < 4);
+  param.seed = (uint64_t)2022 << 32;
+  EXPECT(!sameData(other_seed, generate(1024, param, 1)));
+}
+
+static void testDistributions() {
+  size_t num = 1 << 18;
+  RandomParam param;
+  param.seed = 7;
+  param.low  = -2;
+  param.high = 6;
+
+  std::vector<float> data = generate(num, param, 4);
+  double sum = 0, square_sum = 0;
+  bool in_range = true;
+  for (auto value : data) {
+    in_range = in_range && value >= param.low && value < param.high;
+    sum += value;
+  }
+  EXPECT(in_range);
+  EXPECT(std::fabs(sum / num - 2) < 0.02);
+
+  param.dist = RANDOM_NORMAL;
+  data       = generate(num, param, 4);
+  sum        = 0;
+  int within_sigma = 0;
+  for (auto value : data) {
+    in_range = in_range && value >= param.low && value <= param.high;
+    sum += value;
+    square_sum += (value - 2.0) * (value - 2.0);
+    within_sigma += std::fabs(value - 2) < 4.0 / 3;
+  }
+  EXPECT(in_range);
+  EXPECT(std::fabs(sum / num - 2) < 0.01);
+  EXPECT(std::fabs(std::sqrt(square_sum / num) - 4.0 / 3) < 0.02);
+  EXPECT(std::fabs((double)within_sigma / num - 0.6827) < 0.005);
+
+  // every binade below the largest magnitude is about as likely
+  param.dist = RANDOM_LOG_UNIFORM;
+  param.low  = 0;
+  param.high = 1;
+  data       = generate(num, param, 4);
+  std::vector<int> binades(RANDOM_LOG_OCTAVES, 0);
+  for (auto value : data) {
+    int exponent = 0;
+    frexp(value, &exponent);
+    in_range = in_range && value > 0 && value <= 1;
+    if (exponent <= 0 && exponent > -RANDOM_LOG_OCTAVES) {
+      binades[-exponent]++;
+    }
+  }
+  EXPECT(in_range);
+  for (auto count : binades) {
+    EXPECT(std::fabs((double)count / num * RANDOM_LOG_OCTAVES - 1) < 0.05);
+  }
+  param.low = -1;
+  data      = generate(num, param, 4);
+  int negative_num = 0;
+  for (auto value : data) {
+    negative_num += value < 0;
+  }
+  EXPECT(std::fabs((double)negative_num / num - 0.5) < 0.01);
+
+  param.dist = RANDOM_SPECIAL;
+  param.low  = -1;
+  param.high = 1;
+  data       = generate(num, param, 4);
+  int nan_num = 0, inf_num = 0, denormal_num = 0, outside_num = 0;
+  for (auto value : data) {
+    nan_num += std::isnan(value);
+    inf_num += std::isinf(value);
+    denormal_num += std::fpclassify(value) == FP_SUBNORMAL;
+    outside_num += std::isfinite(value) && (value < -1 || value > 1);
+  }
+  EXPECT(nan_num > 0 && inf_num > 0 && denormal_num > 0 && outside_num > 0);
+  EXPECT(nan_num + inf_num + denormal_num + outside_num < (int)num / RANDOM_SPECIAL_RATIO);
+
+  // the special values of integer data stay in the range
+  param.finite = true;
+  param.low    = -128;
+  param.high   = 128;
+  data         = generate(num, param, 4);
+  in_range     = true;
+  for (auto value : data) {
+    in_range = in_range && value >= param.low && value <= param.high;
+  }
+  EXPECT(in_range);
+}
+
+static void testDistName() {
+  RandomDist dist = RANDOM_UNIFORM;
+  EXPECT(getRandomDist("log_uniform", dist) && dist == RANDOM_LOG_UNIFORM);
+  EXPECT(getRandomDist("special", dist) && dist == RANDOM_SPECIAL);
+  EXPECT(!getRandomDist("gauss", dist) && dist == RANDOM_SPECIAL);
+  EXPECT(strcmp(randomDistStr(RANDOM_NORMAL), "normal") == 0);
+}
+
+int main() {
+  testPhilox();
+  testReproducible();
+  testDistributions();
+  testDistName();
+  printf("%s random_data_test\n", failed_num == 0 ? "PASS" : "FAIL");
+  return failed_num == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,199 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Runs the partition and the partial results of kernels/reduce/reduce_partial.h on the host
+// for clusters of 1, 2 and 4 cores, and the packed chunks of short rows, checks every row is
+// reduced once over all its columns and matches a double reference. usage: ./reduce_sim
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+#include "kernels/reduce/reduce_layout.h"
+#include "kernels/reduce/reduce_partial.h"
+
+enum SimOp { SIM_SUM = 0, SIM_MAX = 1, SIM_LOGSUMEXP = 2 };
+static const char *op_names[] = {"sum", "max", "logsumexp"};
+
+static int failed_num = 0;
+
+// Partial of one chunk, as the chunk functions of kernels/reduce/reduce_device.mlu.
+static ReducePartial chunkPartial(SimOp op, const float *x, int32_t num) {
+  ReducePartial part = {0, 0, num};
+  if (op == SIM_SUM) {
+    for (int32_t i = 0; i < num; ++i) {
+      part.value += x[i];
+    }
+  } else {
+    part.value = x[0];
+    for (int32_t i = 1; i < num; ++i) {
+      part.value = x[i] > part.value ? x[i] : part.value;
+    }
+    for (int32_t i = 0; op == SIM_LOGSUMEXP && i < num; ++i) {
+      part.sum_exp += expf(x[i] - part.value);
+    }
+  }
+  return part;
+}
+
+static void merge(SimOp op, ReducePartial &acc, const ReducePartial &part) {
+  if (op == SIM_SUM) {
+    mergeSum(acc, part);
+  } else if (op == SIM_MAX) {
+    mergeMax(acc, part);
+  } else {
+    mergeLogSumExp(acc, part, expf(logSumExpScaleArg(acc, part)));
+  }
+}
+
+// Partial of col_count columns from col_begin of row, chunk by chunk.
+static ReducePartial corePartial(SimOp op, const std::vector<float> &x, int32_t col_num,
+                                 int32_t row, int32_t col_begin, int32_t col_count,
+                                 int32_t num_deal) {
+  ReducePartial acc = {0, 0, 0};
+  for (int32_t begin = 0; begin < col_count; begin += num_deal) {
+    int32_t num = col_count - begin < num_deal ? col_count - begin : num_deal;
+    merge(op, acc, chunkPartial(op, &x[(size_t)row * col_num + col_begin + begin], num));
+  }
+  return acc;
+}
+
+// A column of a transposed packed chunk folded in halves, as foldRowsSum and foldRowsMax.
+static float foldHalves(SimOp op, std::vector<float> x) {
+  for (size_t blocks = x.size(); blocks > 1;) {
+    size_t half_blocks = blocks / 2;
+    blocks -= half_blocks;
+    for (size_t i = 0; i < half_blocks; ++i) {
+      x[i] = op == SIM_SUM ? x[i] + x[blocks + i] : (x[blocks + i] > x[i] ? x[blocks + i] : x[i]);
+    }
+  }
+  return x[0];
+}
+
+// Partial of a whole row of a packed chunk, as the pack functions of reduce_device.mlu.
+static ReducePartial packedPartial(SimOp op, const float *x, int32_t col_num) {
+  std::vector<float> row(x, x + col_num);
+  ReducePartial part = {foldHalves(op == SIM_SUM ? SIM_SUM : SIM_MAX, row), 0, col_num};
+  if (op == SIM_LOGSUMEXP) {
+    for (auto &value : row) {
+      value = expf(value - part.value);
+    }
+    part.sum_exp = foldHalves(SIM_SUM, row);
+  }
+  return part;
+}
+
+// Reduction in double, sum_abs bounds the rounding of a float sum.
+static double reference(SimOp op, const float *x, int32_t num, double &sum_abs) {
+  double max = x[0], sum = 0;
+  sum_abs    = 0;
+  for (int32_t i = 0; i < num; ++i) {
+    max = x[i] > max ? x[i] : max;
+    sum_abs += fabs(x[i]);
+  }
+  for (int32_t i = 0; i < num; ++i) {
+    sum += op == SIM_SUM ? x[i] : exp(x[i] - max);
+  }
+  return op == SIM_SUM ? sum : op == SIM_MAX ? max : max + log(sum);
+}
+
+// Reduces every row as blockReduce on cluster_num clusters of core_dim cores.
+static bool simulate(SimOp op, const std::vector<float> &x, int32_t row_num, int32_t col_num,
+                     int32_t cluster_num, int32_t core_dim, int32_t num_deal) {
+  // the policy never launches more clusters than rows
+  cluster_num       = cluster_num < row_num ? cluster_num : row_num;
+  int32_t task_dim  = cluster_num * core_dim;
+  bool cooperative  = reduceCooperative(row_num, col_num, core_dim, task_dim);
+  int32_t pack_rows = cooperative ? 0 : reducePackRowNum(col_num, num_deal);
+  std::vector<ReducePartial> results(row_num);
+  std::vector<int> reduced(row_num, 0);
+  for (int32_t cluster = 0; cluster < cluster_num; ++cluster) {
+    for (int32_t core = 0; core < core_dim; ++core) {
+      int32_t task      = cluster * core_dim + core;
+      int32_t row_begin = cooperative ? reducePartBegin(row_num, cluster_num, cluster)
+                                      : reducePartBegin(row_num, task_dim, task);
+      int32_t row_count = cooperative ? reducePartNum(row_num, cluster_num, cluster)
+                                      : reducePartNum(row_num, task_dim, task);
+      int32_t col_begin = cooperative ? reducePartBegin(col_num, core_dim, core) : 0;
+      int32_t col_count = cooperative ? reducePartNum(col_num, core_dim, core) : col_num;
+      if (pack_rows > 0) {
+        // the rows of a packed chunk are taken together, their results stored by one step
+        for (int32_t row = row_begin; row < row_begin + row_count; row += pack_rows) {
+          int32_t rows = row_begin + row_count - row < pack_rows ? row_begin + row_count - row
+                                                                 : pack_rows;
+          for (int32_t i = row; i < row + rows; ++i) {
+            results[i] = packedPartial(op, &x[(size_t)i * col_num], col_num);
+            reduced[i]++;
+          }
+        }
+        continue;
+      }
+      for (int32_t row = row_begin; row < row_begin + row_count; ++row) {
+        ReducePartial part = corePartial(op, x, col_num, row, col_begin, col_count, num_deal);
+        if (!cooperative || core == 0) {
+          results[row] = part;
+          reduced[row]++;
+        } else {
+          // core 0 combines the partials of the row in core order
+          merge(op, results[row], part);
+        }
+      }
+    }
+  }
+  for (int32_t row = 0; row < row_num; ++row) {
+    const ReducePartial &acc = results[row];
+    double sum_abs   = 0;
+    double ref       = reference(op, &x[(size_t)row * col_num], col_num, sum_abs);
+    double out       = op == SIM_LOGSUMEXP ? acc.value + log((double)acc.sum_exp) : acc.value;
+    double tolerance = op == SIM_SUM ? 1e-6 * sum_abs : op == SIM_MAX ? 0 : 1e-5 * fabs(ref);
+    if (reduced[row] != 1 || acc.num != col_num || !(fabs(out - ref) <= tolerance)) {
+      printf("FAIL %s rows %d cols %d clusters %d cores %d num_deal %d: row %d reduced %d "
+             "times over %d columns, %.8g vs %.8g\n",
+             op_names[op], row_num, col_num, cluster_num, core_dim, num_deal, row, reduced[row],
+             acc.num, out, ref);
+      failed_num++;
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  const int32_t core_dims[]    = {1, 2, 4};
+  const int32_t cluster_nums[] = {1, 2, 8};
+  const int32_t num_deals[]    = {64, 4096, 49152};  // 49152: float on a 384 KB NRAM
+  const int32_t shapes[][2]    = {{1, 1},   {1, 63},     {3, 100},   {7, 4096},  {1, 100003},
+                                  {33, 17}, {1000, 129}, {5, 20000}, {64, 4097}, {2, 1 << 20}};
+  std::mt19937 random(1234);
+  std::uniform_real_distribution<float> dist(-8, 8);
+  int passed_num = 0, case_num = 0;
+  for (auto &shape : shapes) {
+    std::vector<float> x((size_t)shape[0] * shape[1]);
+    for (auto &value : x) {
+      value = dist(random);
+    }
+    for (int op = SIM_SUM; op <= SIM_LOGSUMEXP; ++op) {
+      for (int32_t core_dim : core_dims) {
+        for (int32_t cluster_num : cluster_nums) {
+          for (int32_t num_deal : num_deals) {
+            passed_num += simulate((SimOp)op, x, shape[0], shape[1], cluster_num, core_dim,
+                                   num_deal)
+                              ? 1
+                              : 0;
+            case_num++;
+          }
+        }
+      }
+    }
+  }
+  printf("%d/%d reductions passed\n", passed_num, case_num);
+  return failed_num == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,187 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#include <cmath>
+#include <algorithm>
+#include "reference.h"
+
+// x / y of integer values as cnnlDivRound, divided in int64.
+static float divideIntegers(float x, float y, const HostOpParam &op_param) {
+  if (y == 0) {
+    return 0.0f;
+  }
+  int64_t dividend = (int64_t)x, divisor = (int64_t)y;
+  int64_t quotient = dividend / divisor;
+  if (op_param.round_mode == CNNL_DIV_ROUND_FLOOR && dividend % divisor != 0 &&
+      (dividend < 0) != (divisor < 0)) {
+    quotient -= 1;
+  }
+  return (float)std::min((double)quotient, op_param.int_max);
+}
+
+// State state of an optimizer update at i after the update, m and v of Adam or ms of RMSProp.
+static float updateState(OpName op_name,
+                         const HostOpParam &op_param,
+                         const std::vector<const float *> &inputs,
+                         int state,
+                         size_t i) {
+  float grad  = inputs[1][i];
+  bool first  = op_name == CNNL_ADAM_UPDATE && state == 0;
+  float decay = op_name == CNNL_RMSPROP_UPDATE ? op_param.rho
+                                               : (first ? op_param.beta1 : op_param.beta2);
+  return decay * inputs[2 + state][i] + (1 - decay) * (first ? grad : grad * grad);
+}
+
+int hostOptimizerStateNum(OpName op_name) {
+  return op_name == CNNL_ADAM_UPDATE ? 2 : (op_name == CNNL_RMSPROP_UPDATE ? 1 : 0);
+}
+
+void hostOptimizerState(OpName op_name,
+                        const HostOpParam &op_param,
+                        const std::vector<const float *> &inputs,
+                        int state,
+                        float *output,
+                        size_t element_num) {
+  for (size_t i = 0; i < element_num; ++i) {
+    output[i] = updateState(op_name, op_param, inputs, state, i);
+  }
+}
+
+void hostCompute(OpName op_name,
+                 const HostOpParam &op_param,
+                 const std::vector<const float *> &inputs,
+                 float *output,
+                 size_t element_num) {
+  const float *x = inputs[0];
+  switch (op_name) {
+    case CNNL_ABS:
+      for (size_t i = 0; i < element_num; ++i) {
+        output[i] = std::fabs(x[i]);
+        if (op_param.int_max > 0) {
+          output[i] = std::min((double)output[i], op_param.int_max);
+        }
+      }
+      break;
+    case CNNL_ABS_SIGN:
+      for (size_t i = 0; i < element_num; ++i) {
+        output[i] = x[i] > 0 ? 1.0f : x[i] < 0 ? -1.0f : 0.0f;
+        if (std::isnan(x[i]) && op_param.int_max == 0) {
+          output[i] = x[i];
+        }
+      }
+      break;
+    case CNNL_LOG:
+      for (size_t i = 0; i < element_num; ++i) {
+        if (op_param.log_base == CNNL_LOG_2) {
+          output[i] = std::log2(x[i]);
+        } else if (op_param.log_base == CNNL_LOG_10) {
+          output[i] = std::log10(x[i]);
+        } else {
+          output[i] = std::log(x[i]);
+        }
+      }
+      break;
+    case CNNL_SQRT:
+      for (size_t i = 0; i < element_num; ++i) {
+        output[i] = std::sqrt(x[i]);
+      }
+      break;
+    case CNNL_DIV:
+      for (size_t i = 0; i < element_num; ++i) {
+        output[i] = op_param.int_max > 0 ? divideIntegers(x[i], inputs[1][i], op_param)
+                                         : x[i] / inputs[1][i];
+      }
+      break;
+    case CNNL_DIV_ROUND:
+      for (size_t i = 0; i < element_num; ++i) {
+        output[i] = divideIntegers(x[i], inputs[1][i], op_param);
+      }
+      break;
+    case CNNL_SQRT_BACKWARD:
+      // diff_x = diff_y * 0.5 / y
+      for (size_t i = 0; i < element_num; ++i) {
+        output[i] = inputs[1][i] * 0.5f / x[i];
+      }
+      break;
+    case CNNL_RECIPROCAL:
+      for (size_t i = 0; i < element_num; ++i) {
+        output[i] = 1.0f / x[i];
+      }
+      break;
+    case CNNL_DIV_EPS:
+      for (size_t i = 0; i < element_num; ++i) {
+        float divisor = inputs[1][i] + op_param.eps;
+        output[i] = op_param.zero_mode == CNNL_DIV_ZERO_AS_ZERO && divisor == 0
+                        ? 0.0f
+                        : x[i] / divisor;
+      }
+      break;
+    case CNNL_ADAM_UPDATE: {
+      // bias corrections folded into lr and eps as cnnlAdamUpdate
+      double correction1 = 1 - std::pow((double)op_param.beta1, op_param.step);
+      double correction2 = std::sqrt(1 - std::pow((double)op_param.beta2, op_param.step));
+      float lr_t  = op_param.lr * correction2 / correction1;
+      float eps_t = op_param.eps * correction2;
+      for (size_t i = 0; i < element_num; ++i) {
+        float m   = updateState(op_name, op_param, inputs, 0, i);
+        float v   = updateState(op_name, op_param, inputs, 1, i);
+        output[i] = x[i] - lr_t * m / (std::sqrt(v) + eps_t);
+      }
+      break;
+    }
+    case CNNL_RMSPROP_UPDATE:
+      for (size_t i = 0; i < element_num; ++i) {
+        float ms  = updateState(op_name, op_param, inputs, 0, i);
+        output[i] = x[i] - op_param.lr * inputs[1][i] / (std::sqrt(ms) + op_param.eps);
+      }
+      break;
+    case CNNL_REDUCE_LAST_DIM:
+      for (size_t i = 0; i < element_num; ++i) {
+        const float *row = x + i * op_param.reduce_num;
+        double max = row[0], sum = 0;
+        for (int j = 1; j < op_param.reduce_num; ++j) {
+          max = std::max(max, (double)row[j]);
+        }
+        for (int j = 0; j < op_param.reduce_num; ++j) {
+          sum += op_param.reduce_op == CNNL_REDUCE_LAST_DIM_SUM ? row[j] : std::exp(row[j] - max);
+        }
+        output[i] = op_param.reduce_op == CNNL_REDUCE_LAST_DIM_SUM   ? sum
+                    : op_param.reduce_op == CNNL_REDUCE_LAST_DIM_MAX ? max
+                                                                     : max + std::log(sum);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+ErrorInfo computeError(const float *result, const float *baseline, size_t element_num) {
+  ErrorInfo error;
+  double sum_abs_diff = 0, sum_abs_base = 0;
+  double sum_square_diff = 0, sum_square_base = 0;
+  for (size_t i = 0; i < element_num; ++i) {
+    double a = result[i];
+    double b = baseline[i];
+    if ((std::isnan(a) && std::isnan(b)) || (std::isinf(a) && a == b)) {
+      continue;
+    }
+    double diff = std::fabs(a - b);
+    sum_abs_diff += diff;
+    sum_abs_base += std::fabs(b);
+    sum_square_diff += diff * diff;
+    sum_square_base += b * b;
+    error.diff3 = std::max(error.diff3, b == 0 ? diff : diff / std::fabs(b));
+  }
+  error.diff1 = sum_abs_base == 0 ? sum_abs_diff : sum_abs_diff / sum_abs_base;
+  error.diff2 = sum_square_base == 0 ? std::sqrt(sum_square_diff)
+                                     : std::sqrt(sum_square_diff / sum_square_base);
+  return error;
+}
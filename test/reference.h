@@ -0,0 +1,70 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+#ifndef TEST_REFERENCE_H_
+#define TEST_REFERENCE_H_
+
+#include <stddef.h>
+#include <vector>
+#include "tool.h"
+
+struct ErrorInfo {
+  double diff1 = 0;  // sum|a - b| / sum|b|
+  double diff2 = 0;  // sqrt(sum(a - b)^2 / sum(b^2))
+  double diff3 = 0;  // max(|a - b| / |b|), |a - b| where b is 0
+};
+
+// Scalar parameters of the operations.
+struct HostOpParam {
+  cnnlLogBase_t log_base             = CNNL_LOG_E;
+  float eps                          = 0;
+  cnnlDivZeroMode_t zero_mode        = CNNL_DIV_ZERO_NONE;
+  float lr                           = 0;  // hyperparameters of the optimizer updates
+  float beta1                        = 0;
+  float beta2                        = 0;
+  float rho                          = 0;
+  int step                           = 1;
+  cnnlReduceLastDimOp_t reduce_op    = CNNL_REDUCE_LAST_DIM_SUM;
+  int reduce_num                     = 1;  // elements reduced into each output
+  cnnlDivRoundMode_t round_mode      = CNNL_DIV_ROUND_TRUNC;
+  double int_max                     = 0;  // the max of an integer data type, 0 for floats
+  cnnlComputationPreference_t prefer = CNNL_COMPUTATION_FAST;  // of the replayed call
+};
+
+/* Computes the operation on host in float, the baseline of the device result. The optimizer
+ * updates take param, grad and the states as inputs and output the new param, the new states
+ * come from hostOptimizerState. cnnlReduceLastDim outputs element_num results of reduce_num
+ * inputs, in double. cnnlAbsSign outputs the sign, the abs output is the one of cnnlAbs. The
+ * sign of nan is nan, 0 for an int8 sign, that is with int_max.
+ * With int_max, cnnlAbs and cnnlDiv follow the integer types: the quotient is rounded as
+ * round_mode, trunc for cnnlDiv, a zero divisor gives 0 and overflow saturates to int_max.
+ */
+void hostCompute(OpName op_name,
+                 const HostOpParam &op_param,
+                 const std::vector<const float *> &inputs,
+                 float *output,
+                 size_t element_num);
+
+// States of the optimizer update: 2 for Adam, m and v, 1 for RMSProp, ms, else 0.
+int hostOptimizerStateNum(OpName op_name);
+
+// The new state, 0 to hostOptimizerStateNum - 1, of the optimizer update, it is input state + 2.
+void hostOptimizerState(OpName op_name,
+                        const HostOpParam &op_param,
+                        const std::vector<const float *> &inputs,
+                        int state,
+                        float *output,
+                        size_t element_num);
+
+// Compares result with baseline, elements where both are the same inf or nan are skipped.
+ErrorInfo computeError(const float *result, const float *baseline, size_t element_num);
+
+#endif  // TEST_REFERENCE_H_
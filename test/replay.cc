@@ -0,0 +1,626 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Replays the binary gen_case files of a directory as a benchmark suite.
+// usage: ./replay --case_dir=gen_case [--iters=10] [--warmup=2] [--backend=device|host]
+//                 [--prefer=fast|accuracy|approx]
+// The calls take the prefer recorded in the case, --prefer is for the cases without one.
+// Every case is run warmup + iters times on one handle and queue, the last output is compared
+// with the host reference against the diff thresholds captured by GEN_CASE_TEST_PARAM. The
+// optimizer updates compare their new states too.
+// The host backend times the host reference itself, for machines without MLU. Its cases are
+// reported as TIME: there is no kernel output to compare, the reference would be compared
+// with itself.
+#include <dirent.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "include/case_dump.h"
+#include "include/gen_case.h"
+#include "reference.h"
+#include "tool.h"
+
+using cnnl::case_dump::CaseInfo;
+using cnnl::case_dump::CaseReader;
+using cnnl::case_dump::CaseTensor;
+
+struct ReplayParam {
+  std::string case_dir;
+  int iters   = 10;
+  int warmup  = 2;
+  bool device = true;
+  cnnlComputationPreference_t prefer = CNNL_COMPUTATION_FAST;
+};
+
+struct ReplayResult {
+  std::string status;  // PASS, FAIL, SKIP or TIME (host backend, timing only)
+  std::string message;
+  double device_us = 0;  // hardware time of one call, 0 for the host backend
+  double host_us   = 0;  // wall time of one call, launch to sync
+  ErrorInfo error;
+};
+
+static void usage(const char *name) {
+  std::cerr << "usage: " << name
+            << " --case_dir=<dir> [--iters=10] [--warmup=2] [--backend=device|host]"
+               " [--prefer=fast|accuracy|approx]\n";
+  exit(EXIT_FAILURE);
+}
+
+static void parseReplayParam(int argc, char *argv[], ReplayParam &param) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg(argv[i]);
+    std::string value = arg.substr(arg.find('=') + 1);
+    if (arg.compare(0, 11, "--case_dir=") == 0) {
+      param.case_dir = value;
+    } else if (arg.compare(0, 8, "--iters=") == 0) {
+      getItersValue(value.c_str(), param.iters);
+    } else if (arg.compare(0, 9, "--warmup=") == 0) {
+      param.warmup = std::max(0, atoi(value.c_str()));
+    } else if (arg.compare(0, 10, "--backend=") == 0 && (value == "device" || value == "host")) {
+      param.device = value == "device";
+    } else if (arg.compare(0, 9, "--prefer=") == 0 &&
+               (value == "fast" || value == "accuracy" || value == "approx")) {
+      param.prefer = value == "fast" ? CNNL_COMPUTATION_FAST
+                                     : (value == "accuracy" ? CNNL_COMPUTATION_HIGH_PRECISION
+                                                            : CNNL_COMPUTATION_APPROX);
+    } else {
+      std::cerr << "unsupported param:" << arg << "\n";
+      usage(argv[0]);
+    }
+  }
+  if (param.case_dir.empty()) {
+    usage(argv[0]);
+  }
+}
+
+// Collects the case files under dir recursively, sorted to keep the order stable.
+static void listCaseFiles(const std::string &dir, std::vector<std::string> &files) {
+  DIR *handle = opendir(dir.c_str());
+  if (handle == NULL) {
+    return;
+  }
+  std::string suffix(CASE_DUMP_SUFFIX);
+  struct dirent *entry = NULL;
+  while ((entry = readdir(handle)) != NULL) {
+    std::string name(entry->d_name);
+    if (name == "." || name == "..") {
+      continue;
+    }
+    std::string path = dir + "/" + name;
+    struct stat path_stat;
+    if (stat(path.c_str(), &path_stat) != 0) {
+      continue;
+    }
+    if (S_ISDIR(path_stat.st_mode)) {
+      listCaseFiles(path, files);
+    } else if (name.size() > suffix.size() &&
+               name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+      files.push_back(path);
+    }
+  }
+  closedir(handle);
+  std::sort(files.begin(), files.end());
+}
+
+// op_name of GEN_CASE_START to the api, op_param.prefer is kept when the case has none.
+static bool getReplayOp(const CaseInfo &info, OpName &op_name, HostOpParam &op_param) {
+  for (auto &param : info.params) {
+    if (param.param_name == "prefer") {
+      op_param.prefer = (cnnlComputationPreference_t)atoi(param.str_value.c_str());
+    }
+  }
+  if (info.op_name == "abs") {
+    op_name = CNNL_ABS;
+  } else if (info.op_name == "abs_sign") {
+    op_name = CNNL_ABS_SIGN;
+  } else if (info.op_name == "log") {
+    op_name = CNNL_LOG;
+    for (auto &param : info.params) {
+      if (param.param_name == "log_base") {
+        op_param.log_base = (cnnlLogBase_t)atoi(param.str_value.c_str());
+      }
+    }
+  } else if (info.op_name == "sqrt") {
+    op_name = CNNL_SQRT;
+  } else if (info.op_name == "div") {
+    op_name = CNNL_DIV;
+  } else if (info.op_name == "div_round") {
+    op_name = CNNL_DIV_ROUND;
+    for (auto &param : info.params) {
+      if (param.param_name == "round_mode") {
+        op_param.round_mode = (cnnlDivRoundMode_t)atoi(param.str_value.c_str());
+      }
+    }
+  } else if (info.op_name == "sqrt_backward") {
+    op_name = CNNL_SQRT_BACKWARD;
+  } else if (info.op_name == "reciprocal") {
+    op_name = CNNL_RECIPROCAL;
+  } else if (info.op_name == "div_eps") {
+    op_name = CNNL_DIV_EPS;
+    for (auto &param : info.params) {
+      if (param.param_name == "eps" && !param.float_values.empty()) {
+        op_param.eps = param.float_values[0];
+      } else if (param.param_name == "zero_mode") {
+        op_param.zero_mode = (cnnlDivZeroMode_t)atoi(param.str_value.c_str());
+      }
+    }
+  } else if (info.op_name == "adam_update" || info.op_name == "rmsprop_update") {
+    op_name = info.op_name == "adam_update" ? CNNL_ADAM_UPDATE : CNNL_RMSPROP_UPDATE;
+    for (auto &param : info.params) {
+      float value = param.float_values.empty() ? 0 : param.float_values[0];
+      if (param.param_name == "lr") {
+        op_param.lr = value;
+      } else if (param.param_name == "beta1") {
+        op_param.beta1 = value;
+      } else if (param.param_name == "beta2") {
+        op_param.beta2 = value;
+      } else if (param.param_name == "rho") {
+        op_param.rho = value;
+      } else if (param.param_name == "eps") {
+        op_param.eps = value;
+      } else if (param.param_name == "step") {
+        op_param.step = atoi(param.str_value.c_str());
+      }
+    }
+  } else if (info.op_name == "reduce_last_dim") {
+    op_name = CNNL_REDUCE_LAST_DIM;
+    for (auto &param : info.params) {
+      if (param.param_name == "reduce_op") {
+        op_param.reduce_op = (cnnlReduceLastDimOp_t)atoi(param.str_value.c_str());
+      }
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// The optimizer updates write param in place, the case output is the new param.
+static bool isInPlaceOp(OpName op_name) {
+  return op_name == CNNL_ADAM_UPDATE || op_name == CNNL_RMSPROP_UPDATE;
+}
+
+static size_t elementNum(const CaseTensor &tensor) {
+  size_t num = 1;
+  for (auto dim : tensor.dims) {
+    num *= dim;
+  }
+  return num;
+}
+
+static size_t dtypeSize(cnnlDataType_t dtype) {
+  switch (dtype) {
+    case CNNL_DTYPE_HALF:
+      return 2;
+    case CNNL_DTYPE_FLOAT:
+      return 4;
+    case CNNL_DTYPE_INT8:
+      return 1;
+    case CNNL_DTYPE_INT16:
+      return 2;
+    case CNNL_DTYPE_INT32:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+// the saturation of the integer results, 0 for the floating types
+static double integerMax(cnnlDataType_t dtype) {
+  switch (dtype) {
+    case CNNL_DTYPE_INT8:
+      return 127;
+    case CNNL_DTYPE_INT16:
+      return 32767;
+    case CNNL_DTYPE_INT32:
+      return 2147483647;
+    default:
+      return 0;
+  }
+}
+
+static const char *dtypeStr(cnnlDataType_t dtype) {
+  switch (dtype) {
+    case CNNL_DTYPE_HALF:
+      return "half";
+    case CNNL_DTYPE_INT8:
+      return "int8";
+    case CNNL_DTYPE_INT16:
+      return "int16";
+    case CNNL_DTYPE_INT32:
+      return "int32";
+    default:
+      return "float";
+  }
+}
+
+static void toFloat(const void *data, cnnlDataType_t dtype, size_t num, float *out) {
+  if (dtype == CNNL_DTYPE_HALF) {
+    const int16_t *half_data = (const int16_t *)data;
+    for (size_t i = 0; i < num; ++i) {
+      out[i] = cnnl::gen_case::cvtHalfToFloat(half_data[i]);
+    }
+  } else if (dtype == CNNL_DTYPE_INT8) {
+    const int8_t *int8_data = (const int8_t *)data;
+    for (size_t i = 0; i < num; ++i) {
+      out[i] = int8_data[i];
+    }
+  } else if (dtype == CNNL_DTYPE_INT16) {
+    const int16_t *int16_data = (const int16_t *)data;
+    for (size_t i = 0; i < num; ++i) {
+      out[i] = int16_data[i];
+    }
+  } else if (dtype == CNNL_DTYPE_INT32) {
+    const int32_t *int32_data = (const int32_t *)data;
+    for (size_t i = 0; i < num; ++i) {
+      out[i] = int32_data[i];
+    }
+  } else {
+    memcpy(out, data, num * sizeof(float));
+  }
+}
+
+static void launch(const cnnlHandle_t handle,
+                   const ReplayParam &param,
+                   OpName op_name,
+                   const HostOpParam &op_param,
+                   const std::vector<cnnlTensorDescriptor_t> &descs,
+                   const std::vector<void *> &ptrs) {
+  switch (op_name) {
+    case CNNL_ABS:
+      CNNL_CHECK(cnnlAbs(handle, descs[0], ptrs[0], descs[1], ptrs[1]));
+      break;
+    case CNNL_ABS_SIGN:
+      CNNL_CHECK(cnnlAbsSign(handle, descs[0], ptrs[0], descs[1], ptrs[1], descs[2], ptrs[2]));
+      break;
+    case CNNL_LOG:
+      CNNL_CHECK(cnnlLog(handle, op_param.prefer, op_param.log_base, descs[0], ptrs[0],
+                         descs[1], ptrs[1]));
+      break;
+    case CNNL_SQRT:
+      CNNL_CHECK(cnnlSqrt(handle, op_param.prefer, descs[0], ptrs[0], descs[1], ptrs[1]));
+      break;
+    case CNNL_DIV:
+      CNNL_CHECK(cnnlDiv(handle, op_param.prefer, descs[0], ptrs[0], descs[1], ptrs[1],
+                         descs[2], ptrs[2]));
+      break;
+    case CNNL_DIV_ROUND:
+      CNNL_CHECK(cnnlDivRound(handle, op_param.round_mode, descs[0], ptrs[0], descs[1], ptrs[1],
+                              descs[2], ptrs[2]));
+      break;
+    case CNNL_SQRT_BACKWARD:
+      CNNL_CHECK(
+          cnnlSqrtBackward(handle, descs[0], ptrs[0], descs[1], ptrs[1], descs[2], ptrs[2]));
+      break;
+    case CNNL_RECIPROCAL:
+      CNNL_CHECK(
+          cnnlReciprocal(handle, op_param.prefer, descs[0], ptrs[0], descs[1], ptrs[1]));
+      break;
+    case CNNL_DIV_EPS:
+      CNNL_CHECK(cnnlDivEps(handle, op_param.prefer, op_param.eps, op_param.zero_mode, descs[0],
+                            ptrs[0], descs[1], ptrs[1], descs[2], ptrs[2]));
+      break;
+    case CNNL_ADAM_UPDATE:
+      CNNL_CHECK(cnnlAdamUpdate(handle, op_param.lr, op_param.beta1, op_param.beta2, op_param.eps,
+                                op_param.step, descs[0], ptrs[0], descs[1], ptrs[1], descs[2],
+                                ptrs[2], descs[3], ptrs[3]));
+      break;
+    case CNNL_RMSPROP_UPDATE:
+      CNNL_CHECK(cnnlRmspropUpdate(handle, op_param.lr, op_param.rho, op_param.eps, descs[0],
+                                   ptrs[0], descs[1], ptrs[1], descs[2], ptrs[2]));
+      break;
+    case CNNL_REDUCE_LAST_DIM:
+      CNNL_CHECK(cnnlReduceLastDim(handle, op_param.reduce_op, descs[0], ptrs[0], descs[1],
+                                   ptrs[1]));
+      break;
+    default:
+      break;
+  }
+}
+
+// Copies the device data of tensor back to host in float.
+static void copyToFloat(const CaseTensor &tensor, const void *ptr, std::vector<float> &values) {
+  std::vector<char> data(elementNum(tensor) * dtypeSize(tensor.dtype));
+  CNRT_CHECK(cnrtMemcpy(data.data(), (void *)ptr, data.size(), CNRT_MEM_TRANS_DIR_DEV2HOST));
+  values.resize(elementNum(tensor));
+  toFloat(data.data(), tensor.dtype, values.size(), values.data());
+}
+
+/* Runs the case on device, result receives the output in float. states receives the new
+ * states of an optimizer update, see hostOptimizerState.
+ */
+static void deviceReplay(const cnnlHandle_t handle,
+                         const cnrtQueue_t queue,
+                         const ReplayParam &param,
+                         OpName op_name,
+                         const HostOpParam &op_param,
+                         const std::vector<const CaseTensor *> &tensors,
+                         std::vector<float> &result,
+                         std::vector<std::vector<float>> &states,
+                         ReplayResult &replay) {
+  std::vector<cnnlTensorDescriptor_t> descs;
+  std::vector<void *> ptrs;
+  cnrtNotifier_t notifier_start = NULL, notifier_end = NULL;
+  try {
+    for (auto tensor : tensors) {
+      cnnlTensorDescriptor_t desc;
+      CNNL_CHECK(cnnlCreateTensorDescriptor(&desc));
+      descs.push_back(desc);
+      CNNL_CHECK(cnnlSetTensorDescriptor(desc, tensor->layout, tensor->dtype,
+                                         tensor->dims.size(), tensor->dims.data()));
+      size_t bytes = elementNum(*tensor) * dtypeSize(tensor->dtype);
+      void *ptr    = NULL;
+      CNRT_CHECK(cnrtMalloc(&ptr, std::max(bytes, (size_t)1)));
+      ptrs.push_back(ptr);
+      if (tensor->is_input) {
+        CNRT_CHECK(cnrtMemcpy(ptr, (void *)tensor->data, bytes, CNRT_MEM_TRANS_DIR_HOST2DEV));
+      }
+    }
+    for (int i = 0; i < param.warmup; ++i) {
+      launch(handle, param, op_name, op_param, descs, ptrs);
+    }
+    CNRT_CHECK(cnrtSyncQueue(queue));
+
+    CNRT_CHECK(cnrtCreateNotifier(&notifier_start));
+    CNRT_CHECK(cnrtCreateNotifier(&notifier_end));
+    auto host_start = std::chrono::steady_clock::now();
+    CNRT_CHECK(cnrtPlaceNotifier(notifier_start, queue));
+    for (int i = 0; i < param.iters; ++i) {
+      launch(handle, param, op_name, op_param, descs, ptrs);
+    }
+    CNRT_CHECK(cnrtPlaceNotifier(notifier_end, queue));
+    CNRT_CHECK(cnrtSyncQueue(queue));
+    auto host_end = std::chrono::steady_clock::now();
+    float device_us = 0;
+    CNRT_CHECK(cnrtNotifierDuration(notifier_start, notifier_end, &device_us));
+    replay.device_us = device_us / param.iters;
+    replay.host_us =
+        std::chrono::duration<double, std::micro>(host_end - host_start).count() / param.iters;
+
+    void *output_ptr = ptrs.back();
+    if (isInPlaceOp(op_name)) {
+      // every launch updated the inputs, the result is one update of the case inputs
+      for (size_t i = 0; tensors[i]->is_input; ++i) {
+        size_t bytes = elementNum(*tensors[i]) * dtypeSize(tensors[i]->dtype);
+        CNRT_CHECK(cnrtMemcpy(ptrs[i], (void *)tensors[i]->data, bytes,
+                              CNRT_MEM_TRANS_DIR_HOST2DEV));
+      }
+      launch(handle, param, op_name, op_param, descs, ptrs);
+      CNRT_CHECK(cnrtSyncQueue(queue));
+      output_ptr = ptrs[0];
+      states.resize(hostOptimizerStateNum(op_name));
+      for (size_t s = 0; s < states.size(); ++s) {
+        copyToFloat(*tensors[2 + s], ptrs[2 + s], states[s]);
+      }
+    }
+    copyToFloat(*tensors.back(), output_ptr, result);
+  } catch (std::runtime_error &e) {
+    replay.status  = "FAIL";
+    replay.message = e.what();
+  }
+  if (notifier_start != NULL) {
+    cnrtDestroyNotifier(&notifier_start);
+  }
+  if (notifier_end != NULL) {
+    cnrtDestroyNotifier(&notifier_end);
+  }
+  for (auto desc : descs) {
+    cnnlDestroyTensorDescriptor(desc);
+  }
+  for (auto ptr : ptrs) {
+    cnrtFree(ptr);
+  }
+}
+
+// Fails replay where an enabled diff of error is above its threshold, name tells the tensor.
+static void checkDiffs(const ErrorInfo &error,
+                       const cnnl::case_dump::CaseTestParam &test_param,
+                       const std::string &name,
+                       ReplayResult &replay) {
+  double diffs[3] = {error.diff1, error.diff2, error.diff3};
+  for (int i = 0; i < 3; ++i) {
+    // written as !(a <= b) so that a nan diff fails
+    if (test_param.is_diff[i] && !(diffs[i] <= test_param.threshold[i])) {
+      replay.status = "FAIL";
+      std::stringstream message;
+      message << name << "diff" << i + 1 << " " << diffs[i] << " > " << test_param.threshold[i];
+      replay.message = message.str();
+      return;
+    }
+  }
+}
+
+static ReplayResult replayCase(const cnnlHandle_t handle,
+                               const cnrtQueue_t queue,
+                               const ReplayParam &param,
+                               const CaseInfo &info) {
+  ReplayResult replay;
+  replay.status = "SKIP";
+  OpName op_name;
+  HostOpParam op_param;
+  op_param.prefer = param.prefer;
+  if (!getReplayOp(info, op_name, op_param)) {
+    replay.message = "unsupported op " + info.op_name;
+    return replay;
+  }
+  // inputs in the order of the api, then the outputs, the last output is compared
+  std::vector<const CaseTensor *> tensors;
+  for (auto &tensor : info.tensors) {
+    if (tensor.is_input) {
+      tensors.push_back(&tensor);
+    }
+  }
+  size_t input_num = tensors.size();
+  for (auto &tensor : info.tensors) {
+    if (!tensor.is_input) {
+      tensors.push_back(&tensor);
+    }
+  }
+  if (input_num == 0 || input_num == tensors.size()) {
+    replay.message = "no input or output tensor";
+    return replay;
+  }
+  const CaseTensor *output = tensors.back();
+  // elements reduced into each output of cnnlReduceLastDim
+  if (!tensors[0]->dims.empty()) {
+    op_param.reduce_num = tensors[0]->dims.back();
+  }
+  op_param.int_max = integerMax(output->dtype);
+
+  size_t element_num = elementNum(*output);
+  std::vector<std::vector<float>> input_values;
+  std::vector<const float *> inputs;
+  for (size_t i = 0; i < input_num; ++i) {
+    const CaseTensor *tensor = tensors[i];
+    size_t bytes = elementNum(*tensor) * dtypeSize(tensor->dtype);
+    if (bytes == 0 || tensor->data == NULL || tensor->payload_size != bytes) {
+      replay.message = "no data of " + tensor->id;
+      return replay;
+    }
+    input_values.push_back(std::vector<float>(elementNum(*tensor)));
+    toFloat(tensor->data, tensor->dtype, input_values.back().size(), input_values.back().data());
+    inputs.push_back(input_values.back().data());
+  }
+
+  std::vector<float> baseline(element_num);
+  std::vector<float> result(element_num);
+  std::vector<std::vector<float>> states;
+  replay.status = "PASS";
+  if (param.device) {
+    deviceReplay(handle, queue, param, op_name, op_param, tensors, result, states, replay);
+    if (replay.status != "PASS") {
+      return replay;
+    }
+    hostCompute(op_name, op_param, inputs, baseline.data(), element_num);
+  } else {
+    for (int i = 0; i < param.warmup; ++i) {
+      hostCompute(op_name, op_param, inputs, result.data(), element_num);
+    }
+    auto host_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < param.iters; ++i) {
+      hostCompute(op_name, op_param, inputs, result.data(), element_num);
+    }
+    auto host_end = std::chrono::steady_clock::now();
+    replay.host_us =
+        std::chrono::duration<double, std::micro>(host_end - host_start).count() / param.iters;
+    replay.status = "TIME";
+    return replay;
+  }
+
+  replay.error = computeError(result.data(), baseline.data(), element_num);
+  checkDiffs(replay.error, info.test_param, "", replay);
+  // the states of an optimizer update are written in place as param, with its thresholds
+  for (size_t s = 0; s < states.size() && replay.status == "PASS"; ++s) {
+    std::vector<float> state_baseline(states[s].size());
+    hostOptimizerState(op_name, op_param, inputs, s, state_baseline.data(), states[s].size());
+    ErrorInfo error = computeError(states[s].data(), state_baseline.data(), states[s].size());
+    checkDiffs(error, info.test_param, tensors[2 + s]->id + " ", replay);
+  }
+  return replay;
+}
+
+static std::string shapeStr(const CaseInfo &info) {
+  std::stringstream shape;
+  for (auto &tensor : info.tensors) {
+    if (!tensor.is_input) {
+      continue;
+    }
+    shape << dtypeStr(tensor.dtype) << "[";
+    for (size_t i = 0; i < tensor.dims.size(); ++i) {
+      shape << (i == 0 ? "" : ",") << tensor.dims[i];
+    }
+    shape << "] ";
+  }
+  return shape.str();
+}
+
+int main(int argc, char *argv[]) {
+  ReplayParam param;
+  parseReplayParam(argc, argv, param);
+  std::vector<std::string> files;
+  listCaseFiles(param.case_dir, files);
+  if (files.empty()) {
+    std::cerr << "no " << CASE_DUMP_SUFFIX << " file in " << param.case_dir << "\n";
+    return EXIT_FAILURE;
+  }
+
+  cnrtDev_t dev;
+  cnrtQueue_t queue   = NULL;
+  cnnlHandle_t handle = NULL;
+  if (param.device) {
+    try {
+      initDevice(dev, queue, handle);
+    } catch (std::runtime_error &e) {
+      std::cerr << "init device failed: " << e.what() << ", use --backend=host without MLU.\n";
+      return EXIT_FAILURE;
+    }
+  }
+
+  int passed = 0, failed = 0, skipped = 0, timed = 0;
+  double total_us = 0;
+  std::cout << std::fixed << std::setprecision(3);
+  for (auto &file : files) {
+    CaseReader reader;
+    ReplayResult replay;
+    if (!reader.open(file)) {
+      replay.status  = "SKIP";
+      replay.message = "invalid case file";
+    } else {
+      replay = replayCase(handle, queue, param, reader.info());
+    }
+    std::cout << "[" << replay.status << "] " << file;
+    if (replay.status != "SKIP") {
+      std::cout << " " << shapeStr(reader.info());
+      if (param.device) {
+        std::cout << "device " << replay.device_us << " us, ";
+      }
+      std::cout << "host " << replay.host_us << " us";
+      if (replay.status != "TIME") {
+        std::cout << ", diff1 " << replay.error.diff1 << " diff2 " << replay.error.diff2
+                  << " diff3 " << replay.error.diff3;
+      }
+      total_us += param.device ? replay.device_us : replay.host_us;
+    }
+    if (!replay.message.empty()) {
+      std::cout << " (" << replay.message << ")";
+    }
+    std::cout << "\n";
+    if (replay.status == "PASS") {
+      passed++;
+    } else if (replay.status == "FAIL") {
+      failed++;
+    } else if (replay.status == "TIME") {
+      timed++;
+    } else {
+      skipped++;
+    }
+  }
+  std::cout << files.size() << " cases, " << passed << " passed, " << failed << " failed, "
+            << skipped << " skipped, " << timed << " timed only, "
+            << (param.device ? "device" : "host")
+            << " time of one pass " << total_us << " us\n";
+
+  if (param.device) {
+    cnrtDestroyQueue(queue);
+    cnnlReleaseHandleStatistics(handle);
+    cnnlDestroy(handle);
+  }
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -6,13 +6,41 @@ set -e
 # op_name: the test operation, value should be same with the interface in cnnl_example.h
 # input_shape: the shape of input tensor, each number means a dim value of input tensor and split with '-', the max supported len is 8
 # output_shape: the shape of output tensor, output shape should be same with input shape of element-wise operations
-# data_type: the data type of tensor, support values: half, float
-# prefer: the chosen algorithm used for implementation of activation and accumulation operations, support values: fast, accuracy
+# data_type: the data type of tensor, support values: half, float, int8, int16, int32 (cnnlAbs, cnnlDiv and cnnlDivRound)
+# prefer: the chosen algorithm used for implementation of activation and accumulation operations, support values: fast, accuracy, approx (the polynomial cnnlLog and cnnlSqrt)
 # log_base: the base of log algorithm, support values: 2, 10, e
+# eps: the scalar added to the divisor of cnnlDivEps, cnnlAdamUpdate and cnnlRmspropUpdate, default 0
+# zero_mode: the result of cnnlDivEps where the divisor is zero, support values: none, zero
+# lr, beta1, beta2, step: the hyperparameters of cnnlAdamUpdate, default 0.001, 0.9, 0.999, 1
+# rho: the decay of the mean square of cnnlRmspropUpdate, lr is shared, default 0.99
+# reduce_op: the reduction of cnnlReduceLastDim, support values: sum, max, logsumexp, the output shape has a last dim of 1
+# sign_type: the data type of the sign of cnnlAbsSign, support values: same (the data type of x), int8
+# round_mode: the rounding of the integer quotient of cnnlDivRound, support values: trunc, floor
+# warmup, iters: the benchmark mode, iters > 0 times each launch with queue notifiers after warmup launches, default 2, 0
+# shapes: the input shapes of the benchmark, split with ',', such as {1024},{64-4096}, instead of input_shape and output_shape
+# json: the file of the benchmark results, see bench_result.h, the results are printed without it
+# seed: the seed of the random input data, a random seed is printed without it
+# dist: the distribution of the input data, support values: uniform, normal, log_uniform, special (zeros, ones, denormals, inf and nan among uniform values), default uniform
+# input: .npy files of the inputs split with ',', instead of the random data, input_shape, output_shape and data_type come from their headers (little-endian C order f2, f4, i1, i2, i4)
+# dump_output: the .npy file the output is written to, in the data type of the device
+
+# The examples below can also run on one device context: ./test_example --case_file=run_test_example.sh
+# (each line holding test_example arguments is a case, the other lines are skipped)
 
 # Examples:
-./test_example --op_name="cnnlAbs" --input_shape="{128}" --output_shape="{128}" --data_type=half
+./test_example --op_name="cnnlAbsSign" --sign_type=int8 --input_shape="{64-1024}" --output_shape="{64-1024}" --data_type=float
 ./test_example --op_name="cnnlSqrt" --prefer=fast --input_shape="{12-224-64}" --output_shape="{12-224-64}" --data_type=float
 ./test_example --op_name="cnnlDiv" --prefer=accuracy --input_shape="{1-112-112-3}" --output_shape="{1-112-112-3}" --data_type=float
-./test_example --op_name="cnnlSqrtBackward" --input_shape="{2-3-4-5-6-7}" --output_shape="{2-3-4-5-6-7}" --data_type=half
-./test_example --op_name="cnnlLog" --prefer=fast --log_base=2 --input_shape="{3-4-5-6-7-8-9-10}" --output_shape="{3-4-5-6-7-8-9-10}" --data_type=half
+./test_example --op_name="cnnlDivRound" --round_mode=floor --input_shape="{256-1024}" --output_shape="{256-1024}" --data_type=int16
+./test_example --op_name="cnnlLog" --prefer=approx --log_base=10 --input_shape="{64-4096}" --output_shape="{64-4096}" --data_type=float
+./test_example --op_name="cnnlReciprocal" --prefer=accuracy --input_shape="{16-1024}" --output_shape="{16-1024}" --data_type=half
+./test_example --op_name="cnnlDivEps" --prefer=fast --eps=1e-6 --zero_mode=zero --input_shape="{64-512}" --output_shape="{64-512}" --data_type=float
+./test_example --op_name="cnnlDiv" --prefer=fast --seed=2021 --dist=special --input_shape="{1024-1024}" --output_shape="{1024-1024}" --data_type=half
+# ./test_example --op_name="cnnlDiv" --prefer=accuracy --input=x.npy,y.npy --dump_output=z.npy
+./test_example --op_name="cnnlAdamUpdate" --lr=0.001 --beta1=0.9 --beta2=0.999 --eps=1e-8 --step=10 --input_shape="{1024-1024}" --output_shape="{1024-1024}" --data_type=float
+./test_example --op_name="cnnlRmspropUpdate" --lr=0.01 --rho=0.99 --eps=1e-8 --input_shape="{256-256}" --output_shape="{256-256}" --data_type=half
+./test_example --op_name="cnnlReduceLastDim" --reduce_op=logsumexp --input_shape="{128-30522}" --output_shape="{128-1}" --data_type=float
+./test_example --op_name="cnnlLog" --prefer=fast --log_base=e --shapes="{1024},{64-4096},{16-1024-1024}" --data_type=half --warmup=2 --iters=20 --json=bench_log.json
+
+# Every half value through cnnlAbs, cnnlLog, cnnlSqrt and cnnlSqrtBackward, for each prefer:
+./half_sweep --backend=device --prefer=fast,accuracy,approx
@@ -9,17 +9,148 @@
  * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  *************************************************************************/
+#include <string.h>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <iomanip>
 #include <stdexcept>
 #include <iostream>
+#include "case_list.h"
 #include "tool.h"
 #include "log.h"
 
+static void *deviceAlloc(size_t bytes) {
+  void *ptr = NULL;
+  return cnrtMalloc(&ptr, bytes) == CNRT_RET_SUCCESS ? ptr : NULL;
+}
+
+static void deviceRelease(void *ptr) {
+  cnrtFree(ptr);
+}
+
+/* Runs the cases of a case file back to back on one handle and queue. The device buffers come
+ * from a pool reserved for the largest case, a failed case is reported and the next one runs.
+ */
+static int runCaseFile(const std::string &path) {
+  std::vector<TestCase> cases = parseCaseFile(path);
+  if (cases.empty()) {
+    ERROR("no case in " + path);
+  }
+  cnrtDev_t dev;
+  cnrtQueue_t queue = NULL;
+  cnnlHandle_t handle = NULL;
+  initDevice(dev, queue, handle);
+
+  int passed = 0, failed = 0;
+  double total_us = 0;
+  std::cout << std::fixed << std::setprecision(3);
+  {
+    BufferPool pool(deviceAlloc, deviceRelease);
+    pool.reserve(maxBufferBytes(cases));
+    for (auto &test_case : cases) {
+      BaseOp base_op;
+      std::string message;
+      double case_us = 0;
+      try {
+        createDeviceDesc(test_case.param, base_op);
+        std::vector<void *> buffers = pool.acquire(caseBufferBytes(test_case.param));
+        prepareTestData(test_case.param, base_op, &buffers);
+        auto start = std::chrono::steady_clock::now();
+        deviceCompute(handle, queue, test_case.param, base_op);
+        auto end = std::chrono::steady_clock::now();
+        case_us = std::chrono::duration<double, std::micro>(end - start).count();
+        copyResultOut(test_case.param, base_op);
+      } catch (std::runtime_error &e) {
+        message = e.what();
+      }
+      freeTestData(base_op);
+      std::cout << (message.empty() ? "[PASS] " : "[FAIL] ") << test_case.file << ":"
+                << test_case.line << " " << test_case.args;
+      if (message.empty()) {
+        std::cout << " " << case_us << " us\n";
+        total_us += case_us;
+        passed++;
+      } else {
+        std::cout << " (" << message << ", seed " << test_case.param.seed << ")\n";
+        failed++;
+      }
+    }
+    std::cout << cases.size() << " cases, " << passed << " passed, " << failed << " failed, "
+              << "compute " << total_us / 1000 << " ms, device pool " << pool.capacity()
+              << " bytes in " << pool.allocNum() << " allocations\n";
+  }
+
+  CNRT_CHECK(cnrtDestroyQueue(queue));
+  CNNL_CHECK(cnnlReleaseHandleStatistics(handle));
+  CNNL_CHECK(cnnlDestroy(handle));
+  return failed == 0 ? 0 : -1;
+}
+
+/* Benchmarks the operation on each shape of --shapes, or on --input_shape, and writes the
+ * results as json, see bench_result.h.
+ */
+static int runBenchmark(const ParamInfo &param_info) {
+  std::vector<std::vector<int>> shapes = param_info.shapes;
+  if (shapes.empty() && param_info.dim_size <= 0) {
+    ERROR("the benchmark needs --shapes or --input_shape");
+  }
+  if (shapes.empty()) {
+    shapes.push_back(std::vector<int>(param_info.input_shape,
+                                      param_info.input_shape + param_info.dim_size));
+  }
+  cnrtDev_t dev;
+  cnrtQueue_t queue = NULL;
+  cnnlHandle_t handle = NULL;
+  initDevice(dev, queue, handle);
+
+  std::vector<BenchResult> results;
+  std::cout << std::fixed << std::setprecision(3);
+  for (auto &shape : shapes) {
+    ParamInfo param = param_info;
+    setCaseShape(shape, param);
+    BaseOp base_op;
+    BenchResult result;
+    createDeviceDesc(param, base_op);
+    prepareTestData(param, base_op);
+    benchmarkCompute(handle, queue, param, base_op, result);
+    freeTestData(base_op);
+
+    LatencySummary summary = summarizeLatency(result.samples_us);
+    std::cout << "[BENCH] " << benchKey(result) << " min " << summary.min_us << " us, median "
+              << summary.median_us << " us, p99 " << summary.p99_us << " us, "
+              << bandwidthGBps(result.bytes, summary.median_us) << " GB/s\n";
+    results.push_back(result);
+  }
+
+  if (param_info.json_path.empty()) {
+    writeBenchJson(std::cout, results);
+  } else {
+    std::ofstream json(param_info.json_path.c_str());
+    writeBenchJson(json, results);
+    if (!json.good()) {
+      ERROR("can not write " + param_info.json_path);
+    }
+  }
+  CNRT_CHECK(cnrtDestroyQueue(queue));
+  CNNL_CHECK(cnnlReleaseHandleStatistics(handle));
+  CNNL_CHECK(cnnlDestroy(handle));
+  return 0;
+}
+
 int main(int argc, char *argv[]) {
   try {
+    // --case_file=<path> runs every case of the file on one device context
+    if (argc == 2 && strncmp(argv[1], "--case_file=", 12) == 0) {
+      return runCaseFile(argv[1] + 12);
+    }
+
     BaseOp base_op;
-    ParamInfo param_info;
+    ParamInfo param_info = ParamInfo();
     parseParam(argc, argv, param_info);
     printTestParam(param_info);
+    if (param_info.iters > 0) {
+      return runBenchmark(param_info);
+    }
 
     // step1: init device
     LOG("init device:dev, handle and queue.");
@@ -9,12 +9,16 @@
  * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  *************************************************************************/
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <random>
 #include <limits>
+#include <thread>  // NOLINT
 #include "cnnl_example.h"
 #include "string.h"
 #include "log.h"
+#include "npy_file.h"
 #include "tool.h"
 
 bool isBeginWith(const char *str1, const char *str2) {
@@ -39,13 +43,10 @@ bool isBeginWith(const char *str1, const char *str2) {
   return true;
 }
 
-float *mallocDataRandf(int size, int low, int height) {
+// random data of param, filled on every host thread
+float *mallocDataRandf(size_t size, const RandomParam &param) {
   float *data = (float *)malloc(size * sizeof(float));
-  std::uniform_real_distribution<float> dist(low, height);
-  std::default_random_engine random(time(NULL));
-  for (int i = 0; i < size; i++) {
-    data[i] = dist(random);
-  }
+  fillRandom(data, size, param, std::thread::hardware_concurrency());
   return data;
 }
 
@@ -61,6 +62,20 @@ std::string name2Str(const OpName &op_name) {
       return "cnnlSqrt";
     case CNNL_SQRT_BACKWARD:
       return "cnnlSqrtBackward";
+    case CNNL_RECIPROCAL:
+      return "cnnlReciprocal";
+    case CNNL_DIV_EPS:
+      return "cnnlDivEps";
+    case CNNL_ADAM_UPDATE:
+      return "cnnlAdamUpdate";
+    case CNNL_RMSPROP_UPDATE:
+      return "cnnlRmspropUpdate";
+    case CNNL_REDUCE_LAST_DIM:
+      return "cnnlReduceLastDim";
+    case CNNL_ABS_SIGN:
+      return "cnnlAbsSign";
+    case CNNL_DIV_ROUND:
+      return "cnnlDivRound";
     default:
       return "unkonw";
   }
@@ -83,6 +98,28 @@ void getOpName(const char *name_str, ParamInfo &param_info) {
   } else if (strcmp(name_str, "cnnlSqrtBackward") == 0) {
     param_info.op_name = CNNL_SQRT_BACKWARD;
     param_info.input_num = 2;
+  } else if (strcmp(name_str, "cnnlReciprocal") == 0) {
+    param_info.op_name = CNNL_RECIPROCAL;
+    param_info.input_num = 1;
+  } else if (strcmp(name_str, "cnnlDivEps") == 0) {
+    param_info.op_name = CNNL_DIV_EPS;
+    param_info.input_num = 2;
+  } else if (strcmp(name_str, "cnnlAdamUpdate") == 0) {
+    param_info.op_name = CNNL_ADAM_UPDATE;
+    param_info.input_num = 4;
+  } else if (strcmp(name_str, "cnnlRmspropUpdate") == 0) {
+    param_info.op_name = CNNL_RMSPROP_UPDATE;
+    param_info.input_num = 3;
+  } else if (strcmp(name_str, "cnnlReduceLastDim") == 0) {
+    param_info.op_name = CNNL_REDUCE_LAST_DIM;
+    param_info.input_num = 1;
+  } else if (strcmp(name_str, "cnnlAbsSign") == 0) {
+    param_info.op_name = CNNL_ABS_SIGN;
+    param_info.input_num = 1;
+    param_info.output_num = 2;
+  } else if (strcmp(name_str, "cnnlDivRound") == 0) {
+    param_info.op_name = CNNL_DIV_ROUND;
+    param_info.input_num = 2;
   } else {
     std::string name = name_str;
     std::string msg = "unsupprt name:" + name;
@@ -92,8 +129,9 @@ void getOpName(const char *name_str, ParamInfo &param_info) {
 
 // get --input_shape and --output_shape argument's value
 void getShape(const char *argv, const bool is_input, ParamInfo &param_info) {
-  char *p1 = (char *)malloc(strlen(argv));
+  char *p1 = (char *)calloc(strlen(argv), 1);
   p1 = strncpy(p1, argv + 1, strlen(argv) - 2);  // remove "{" and "}"
+  char *shape = p1;
   char *begin = p1;
   char number[20];
   int index = 0;
@@ -119,6 +157,7 @@ void getShape(const char *argv, const bool is_input, ParamInfo &param_info) {
     param_info.output_shape[index] = atol(begin);
   }
   param_info.dim_size = index + 1;
+  free(shape);
 }
 
 // get --data_type argument's value
@@ -127,6 +166,12 @@ void getDataType(const char *data_type, cnnlDataType_t &dtype) {
     dtype = CNNL_DTYPE_HALF;
   } else if (strcmp(data_type, "float") == 0) {
     dtype = CNNL_DTYPE_FLOAT;
+  } else if (strcmp(data_type, "int8") == 0) {
+    dtype = CNNL_DTYPE_INT8;
+  } else if (strcmp(data_type, "int16") == 0) {
+    dtype = CNNL_DTYPE_INT16;
+  } else if (strcmp(data_type, "int32") == 0) {
+    dtype = CNNL_DTYPE_INT32;
   } else {
     std::string type = data_type;
     std::string msg = "unsupported data type:" + type;
@@ -134,12 +179,46 @@ void getDataType(const char *data_type, cnnlDataType_t &dtype) {
   }
 }
 
+std::string dtype2Str(const cnnlDataType_t dtype) {
+  switch (dtype) {
+    case CNNL_DTYPE_HALF:
+      return "half";
+    case CNNL_DTYPE_INT8:
+      return "int8";
+    case CNNL_DTYPE_INT16:
+      return "int16";
+    case CNNL_DTYPE_INT32:
+      return "int32";
+    default:
+      return "float";
+  }
+}
+
+// get --shapes argument's value, shapes split with ',' such as {64-4096},{1024}
+void getShapes(const char *shapes_str, ParamInfo &param_info) {
+  std::string shapes = shapes_str;
+  size_t begin = 0;
+  while (begin < shapes.size()) {
+    size_t end = shapes.find('}', begin);
+    if (shapes[begin] != '{' || end == std::string::npos) {
+      ERROR("unsupported shapes:" + shapes);
+    }
+    ParamInfo shape_info;
+    getShape(shapes.substr(begin, end + 1 - begin).c_str(), true, shape_info);
+    param_info.shapes.push_back(
+        std::vector<int>(shape_info.input_shape, shape_info.input_shape + shape_info.dim_size));
+    begin = end + 1 < shapes.size() && shapes[end + 1] == ',' ? end + 2 : end + 1;
+  }
+}
+
 // get --prefer argument's value
 void getPreferValue(const char *prefer_value, cnnlComputationPreference_t &prefer) {
   if (strcmp(prefer_value, "fast") == 0) {
     prefer = CNNL_COMPUTATION_FAST;
   } else if (strcmp(prefer_value, "accuracy") == 0) {
     prefer = CNNL_COMPUTATION_HIGH_PRECISION;
+  } else if (strcmp(prefer_value, "approx") == 0) {
+    prefer = CNNL_COMPUTATION_APPROX;
   } else {
     std::string param = prefer_value;
     std::string msg = "unsupported prefer mode:" + param;
@@ -162,9 +241,155 @@ void getLogBaseValue(const char *log_base, cnnlLogBase_t &base_value) {
   }
 }
 
+// get --zero_mode argument's value
+void getZeroModeValue(const char *zero_mode, cnnlDivZeroMode_t &mode) {
+  if (strcmp(zero_mode, "none") == 0) {
+    mode = CNNL_DIV_ZERO_NONE;
+  } else if (strcmp(zero_mode, "zero") == 0) {
+    mode = CNNL_DIV_ZERO_AS_ZERO;
+  } else {
+    std::string param = zero_mode;
+    std::string msg = "unsupported zero mode:" + param;
+    ERROR(msg);
+  }
+}
+
+// get --reduce_op argument's value
+void getReduceOpValue(const char *reduce_op, cnnlReduceLastDimOp_t &op) {
+  if (strcmp(reduce_op, "sum") == 0) {
+    op = CNNL_REDUCE_LAST_DIM_SUM;
+  } else if (strcmp(reduce_op, "max") == 0) {
+    op = CNNL_REDUCE_LAST_DIM_MAX;
+  } else if (strcmp(reduce_op, "logsumexp") == 0) {
+    op = CNNL_REDUCE_LAST_DIM_LOGSUMEXP;
+  } else {
+    std::string param = reduce_op;
+    std::string msg = "unsupported reduce op:" + param;
+    ERROR(msg);
+  }
+}
+
+// get --sign_type argument's value
+void getSignTypeValue(const char *sign_type, bool &sign_int8) {
+  if (strcmp(sign_type, "int8") == 0) {
+    sign_int8 = true;
+  } else if (strcmp(sign_type, "same") == 0) {
+    sign_int8 = false;
+  } else {
+    std::string param = sign_type;
+    std::string msg = "unsupported sign type:" + param;
+    ERROR(msg);
+  }
+}
+
+// get --round_mode argument's value
+void getRoundModeValue(const char *round_mode, cnnlDivRoundMode_t &mode) {
+  if (strcmp(round_mode, "trunc") == 0) {
+    mode = CNNL_DIV_ROUND_TRUNC;
+  } else if (strcmp(round_mode, "floor") == 0) {
+    mode = CNNL_DIV_ROUND_FLOOR;
+  } else {
+    std::string param = round_mode;
+    std::string msg = "unsupported round mode:" + param;
+    ERROR(msg);
+  }
+}
+
+// get --input argument's value, .npy files split with ','
+void getInputFiles(const char *files, ParamInfo &param_info) {
+  std::stringstream list(files);
+  std::string file;
+  while (std::getline(list, file, ',')) {
+    param_info.input_files.push_back(file);
+  }
+}
+
+// the data type of the descr of a .npy file
+static cnnlDataType_t npyDataType(const std::string &descr) {
+  if (descr == "<f2") {
+    return CNNL_DTYPE_HALF;
+  } else if (descr == "|i1") {
+    return CNNL_DTYPE_INT8;
+  } else if (descr == "<i2") {
+    return CNNL_DTYPE_INT16;
+  } else if (descr == "<i4") {
+    return CNNL_DTYPE_INT32;
+  }
+  return CNNL_DTYPE_FLOAT;
+}
+
+static std::string npyDescr(const cnnlDataType_t dtype) {
+  switch (dtype) {
+    case CNNL_DTYPE_HALF:
+      return "<f2";
+    case CNNL_DTYPE_INT8:
+      return "|i1";
+    case CNNL_DTYPE_INT16:
+      return "<i2";
+    case CNNL_DTYPE_INT32:
+      return "<i4";
+    default:
+      return "<f4";
+  }
+}
+
+// the shape and the data type of the case come from the headers of the --input files
+static void setInputFileParam(ParamInfo &param_info) {
+  if ((int)param_info.input_files.size() != param_info.input_num) {
+    std::stringstream msg;
+    msg << name2Str(param_info.op_name) << " takes " << param_info.input_num << " --input files";
+    ERROR(msg.str());
+  }
+  if (!param_info.shapes.empty()) {
+    ERROR("--input takes the shape of its files, not --shapes");
+  }
+  std::vector<int> shape;
+  for (size_t i = 0; i < param_info.input_files.size(); ++i) {
+    MappedNpy npy;
+    std::string error;
+    if (!npy.open(param_info.input_files[i], error)) {
+      ERROR(error);
+    }
+    cnnlDataType_t dtype = npyDataType(npy.header().descr);
+    if (i == 0) {
+      shape = npy.header().shape;
+      if (shape.empty() || shape.size() > MAX_DIM) {
+        ERROR(param_info.input_files[i] + ": the dim size of an input is 1 to 8");
+      }
+      param_info.dtype = dtype;
+      setCaseShape(shape, param_info);
+    } else if (dtype != param_info.dtype || npy.header().shape != shape) {
+      ERROR(param_info.input_files[i] + ": the data type or the shape differs from " +
+            param_info.input_files[0]);
+    }
+  }
+}
+
+// get --dist argument's value
+void getDistValue(const char *dist_name, RandomDist &dist) {
+  if (!getRandomDist(dist_name, dist)) {
+    std::string param = dist_name;
+    std::string msg = "unsupported dist:" + param;
+    ERROR(msg);
+  }
+}
+
+// get --iters argument's value, the benchmark times at least one launch
+void getItersValue(const char *iters, int &value) {
+  char *end = NULL;
+  long parsed = strtol(iters, &end, 10);
+  if (end == iters || *end != '\0' || parsed < 1 ||
+      parsed > std::numeric_limits<int>::max()) {
+    std::string param = iters;
+    std::string msg = "unsupported iters:" + param + ", --iters must be an integer of at least 1";
+    ERROR(msg);
+  }
+  value = (int)parsed;
+}
+
 // parse command line arguments
 void parseParam(int argc, char *argv[], ParamInfo &param_info) {
-  if (argc != 5 && argc != 6 && argc != 7) {
+  if (argc < 3 || argc > 17) {
     std::stringstream error_msg;
     error_msg
         << "wrong command line arguments, please reference to the example in run_test_example.sh!"
@@ -173,6 +398,8 @@ void parseParam(int argc, char *argv[], ParamInfo &param_info) {
   }
   argc -= 1;
   argv++;
+  // a case reproduces with the --seed it prints
+  param_info.seed = ((uint64_t)std::random_device()() << 32) | std::random_device()();
   while (argc) {
     if (isBeginWith(argv[0], "--op_name")) {
       getOpName(argv[0] + 10, param_info);
@@ -186,6 +413,42 @@ void parseParam(int argc, char *argv[], ParamInfo &param_info) {
       getPreferValue(argv[0] + 9, param_info.prefer);
     } else if (isBeginWith(argv[0], "--log_base")) {
       getLogBaseValue(argv[0] + 11, param_info.log_base);
+    } else if (isBeginWith(argv[0], "--eps")) {
+      param_info.eps = atof(argv[0] + 6);
+    } else if (isBeginWith(argv[0], "--zero_mode")) {
+      getZeroModeValue(argv[0] + 12, param_info.zero_mode);
+    } else if (isBeginWith(argv[0], "--lr")) {
+      param_info.lr = atof(argv[0] + 5);
+    } else if (isBeginWith(argv[0], "--beta1")) {
+      param_info.beta1 = atof(argv[0] + 8);
+    } else if (isBeginWith(argv[0], "--beta2")) {
+      param_info.beta2 = atof(argv[0] + 8);
+    } else if (isBeginWith(argv[0], "--rho")) {
+      param_info.rho = atof(argv[0] + 6);
+    } else if (isBeginWith(argv[0], "--step")) {
+      param_info.step = atoi(argv[0] + 7);
+    } else if (isBeginWith(argv[0], "--reduce_op")) {
+      getReduceOpValue(argv[0] + 12, param_info.reduce_op);
+    } else if (isBeginWith(argv[0], "--sign_type")) {
+      getSignTypeValue(argv[0] + 12, param_info.sign_int8);
+    } else if (isBeginWith(argv[0], "--round_mode")) {
+      getRoundModeValue(argv[0] + 13, param_info.round_mode);
+    } else if (isBeginWith(argv[0], "--warmup")) {
+      param_info.warmup = std::max(0, atoi(argv[0] + 9));
+    } else if (isBeginWith(argv[0], "--iters")) {
+      getItersValue(argv[0] + 8, param_info.iters);
+    } else if (isBeginWith(argv[0], "--shapes")) {
+      getShapes(argv[0] + 9, param_info);
+    } else if (isBeginWith(argv[0], "--json")) {
+      param_info.json_path = argv[0] + 7;
+    } else if (isBeginWith(argv[0], "--seed")) {
+      param_info.seed = strtoull(argv[0] + 7, NULL, 10);
+    } else if (isBeginWith(argv[0], "--dist")) {
+      getDistValue(argv[0] + 7, param_info.dist);
+    } else if (isBeginWith(argv[0], "--input=")) {
+      getInputFiles(argv[0] + 8, param_info);
+    } else if (isBeginWith(argv[0], "--dump_output")) {
+      param_info.dump_path = argv[0] + 14;
     } else {
       std::string opt_param = argv[0];
       std::string error_message = "unsupported param:" + opt_param;
@@ -194,23 +457,69 @@ void parseParam(int argc, char *argv[], ParamInfo &param_info) {
     argc -= 1;
     argv++;
   }
+  if (!param_info.input_files.empty()) {
+    setInputFileParam(param_info);
+  }
+  if (!param_info.dump_path.empty() && param_info.iters > 0) {
+    ERROR("--dump_output is not supported by the benchmark");
+  }
 }
 
 // show case info
 void printTestParam(const ParamInfo &param_info) {
   std::stringstream case_info;
-  std::string dtype = param_info.dtype == 1 ? "CNNL_DTYPE_HALF" : "CNNL_DTYPE_FLOAT";
+  std::string dtype;
+  switch (param_info.dtype) {
+    case CNNL_DTYPE_HALF: dtype = "CNNL_DTYPE_HALF"; break;
+    case CNNL_DTYPE_INT8: dtype = "CNNL_DTYPE_INT8"; break;
+    case CNNL_DTYPE_INT16: dtype = "CNNL_DTYPE_INT16"; break;
+    case CNNL_DTYPE_INT32: dtype = "CNNL_DTYPE_INT32"; break;
+    default: dtype = "CNNL_DTYPE_FLOAT"; break;
+  }
   case_info << "-----------------test case info-----------------" << std::endl;
   case_info << "op name:" << name2Str(param_info.op_name) << std::endl;
   case_info << "data type:" << dtype << std::endl;
-  case_info << "tensor shape:" << param_info.input_shape[0];
-  for (int i = 1; i < param_info.dim_size; ++i) {
-    case_info << ", " << param_info.input_shape[i];
+  if (param_info.shapes.empty()) {
+    case_info << "tensor shape:" << param_info.input_shape[0];
+    for (int i = 1; i < param_info.dim_size; ++i) {
+      case_info << ", " << param_info.input_shape[i];
+    }
+  } else {
+    case_info << "tensor shapes:";
+    for (size_t i = 0; i < param_info.shapes.size(); ++i) {
+      case_info << (i == 0 ? "{" : ", {");
+      for (size_t j = 0; j < param_info.shapes[i].size(); ++j) {
+        case_info << (j == 0 ? "" : ", ") << param_info.shapes[i][j];
+      }
+      case_info << "}";
+    }
   }
   case_info << std::endl;
+  if (param_info.input_files.empty()) {
+    case_info << "input data:" << randomDistStr(param_info.dist) << ", seed " << param_info.seed
+              << std::endl;
+  } else {
+    case_info << "input files:" << param_info.input_files[0];
+    for (size_t i = 1; i < param_info.input_files.size(); ++i) {
+      case_info << ", " << param_info.input_files[i];
+    }
+    case_info << std::endl;
+  }
   std::cout << case_info.str();
 }
 
+void setCaseShape(const std::vector<int> &shape, ParamInfo &param_info) {
+  param_info.dim_size = shape.size();
+  for (size_t i = 0; i < shape.size(); ++i) {
+    param_info.input_shape[i]  = shape[i];
+    param_info.output_shape[i] = shape[i];
+  }
+  // cnnlReduceLastDim reduces the last dim to 1
+  if (param_info.op_name == CNNL_REDUCE_LAST_DIM && !shape.empty()) {
+    param_info.output_shape[shape.size() - 1] = 1;
+  }
+}
+
 // init device resources
 void initDevice(cnrtDev_t &dev, cnrtQueue_t &queue, cnnlHandle_t &handle) {
   CNRT_CHECK(cnrtInit(0));
@@ -240,10 +549,14 @@ void createDeviceDesc(const ParamInfo &param_info, BaseOp &base_op) {
     base_op.inputs.push_back(temp_desc);
   }
   for (int i = 0; i < param_info.output_num; i++) {
+    // the sign of cnnlAbsSign may be int8, its buffer keeps the size of the data type
+    cnnlDataType_t dtype = param_info.op_name == CNNL_ABS_SIGN && i == 1 && param_info.sign_int8
+                               ? CNNL_DTYPE_INT8
+                               : param_info.dtype;
     cnnlTensorDescriptor_t temp_desc;
     CNNL_CHECK(cnnlCreateTensorDescriptor(&temp_desc));
-    CNNL_CHECK(cnnlSetTensorDescriptor(temp_desc, CNNL_LAYOUT_ARRAY, param_info.dtype,
-                                       param_info.dim_size, param_info.output_shape));
+    CNNL_CHECK(cnnlSetTensorDescriptor(temp_desc, CNNL_LAYOUT_ARRAY, dtype, param_info.dim_size,
+                                       param_info.output_shape));
     base_op.outputs.push_back(temp_desc);
   }
 }
@@ -254,32 +567,117 @@ size_t getDataTypeSize(const cnnlDataType_t dtype) {
       return 2;
     case CNNL_DTYPE_FLOAT:
       return 4;
+    case CNNL_DTYPE_INT8:
+      return 1;
+    case CNNL_DTYPE_INT16:
+      return 2;
+    case CNNL_DTYPE_INT32:
+      return 4;
     default:
       return -1;
   }
 }
 
+bool isIntegerType(const cnnlDataType_t dtype) {
+  return dtype == CNNL_DTYPE_INT8 || dtype == CNNL_DTYPE_INT16 || dtype == CNNL_DTYPE_INT32;
+}
+
+// random integers of prepareTestData, the range of the type. The data is drawn in float, the
+// int32 high end is the largest float below 2^31.
+void getIntegerRange(const cnnlDataType_t dtype, int &low, int &height) {
+  height = dtype == CNNL_DTYPE_INT8 ? 127 : dtype == CNNL_DTYPE_INT16 ? 32767 : 2147483520;
+  low    = dtype == CNNL_DTYPE_INT32 ? INT32_MIN : -height - 1;
+}
+
+// copies host float data of integer values from or to the device buffer of the integer type
+template <typename T>
+void copyInteger(float *host, void *device, size_t element_num, bool to_device) {
+  std::vector<T> data(element_num);
+  if (to_device) {
+    std::copy(host, host + element_num, data.begin());
+    CNRT_CHECK(cnrtMemcpy(device, data.data(), element_num * sizeof(T),
+                          CNRT_MEM_TRANS_DIR_HOST2DEV));
+  } else {
+    CNRT_CHECK(cnrtMemcpy(data.data(), device, element_num * sizeof(T),
+                          CNRT_MEM_TRANS_DIR_DEV2HOST));
+    std::copy(data.begin(), data.end(), host);
+  }
+}
+
+void copyIntegerData(cnnlDataType_t dtype, float *host, void *device, size_t element_num,
+                     bool to_device) {
+  if (dtype == CNNL_DTYPE_INT8) {
+    copyInteger<int8_t>(host, device, element_num, to_device);
+  } else if (dtype == CNNL_DTYPE_INT16) {
+    copyInteger<int16_t>(host, device, element_num, to_device);
+  } else {
+    copyInteger<int32_t>(host, device, element_num, to_device);
+  }
+}
+
 // perpare test data and device memory, then copy data to device
-void prepareTestData(const ParamInfo &param_info, BaseOp &base_op) {
+void prepareTestData(const ParamInfo &param_info,
+                     BaseOp &base_op,
+                     const std::vector<void *> *device_buffers) {
   int low = -1, height = 1;
+  bool is_integer = isIntegerType(param_info.dtype);
+  if (is_integer) {
+    getIntegerRange(param_info.dtype, low, height);
+  }
   size_t element_num = 1;
   for (int i = 0; i < param_info.dim_size; ++i) {
     element_num *= param_info.input_shape[i];
   }
-  int tensor_size = element_num * getDataTypeSize(param_info.dtype);
+  size_t tensor_size = element_num * getDataTypeSize(param_info.dtype);
 
+  RandomParam random_param;
+  random_param.dist   = param_info.dist;
+  random_param.low    = low;
+  random_param.high   = is_integer ? height + 1 : height;
+  random_param.finite = is_integer;
+  random_param.seed   = param_info.seed;
   for (int i = 0; i < param_info.input_num + param_info.output_num; i++) {
     DataAddrInfo data_node;
     data_node.size = tensor_size;
-    data_node.host_ptr = mallocDataRandf(element_num, low, height);
-    CNRT_CHECK(cnrtMalloc(&(data_node.device_ptr), tensor_size));
+    // the --input files and a --dump_output need no host data
+    bool from_file = i < (int)param_info.input_files.size();
+    bool to_file   = i >= param_info.input_num && !param_info.dump_path.empty();
+    if (!from_file && !to_file) {
+      // every tensor is its own stream, the inputs of cnnlDiv differ
+      random_param.stream = i;
+      data_node.host_ptr  = mallocDataRandf(element_num, random_param);
+      // the second moment of adam and the mean square of rmsprop are not negative
+      bool is_square_state = (param_info.op_name == CNNL_ADAM_UPDATE && i == 3) ||
+                             (param_info.op_name == CNNL_RMSPROP_UPDATE && i == 2);
+      for (size_t j = 0; is_square_state && j < element_num; ++j) {
+        data_node.host_ptr[j] = fabs(data_node.host_ptr[j]);
+      }
+      for (size_t j = 0; is_integer && j < element_num; ++j) {
+        data_node.host_ptr[j] = std::min(std::floor(data_node.host_ptr[j]), (float)height);
+      }
+    }
+    if (device_buffers != NULL) {
+      data_node.device_ptr = (*device_buffers)[i];
+    } else {
+      CNRT_CHECK(cnrtMalloc(&(data_node.device_ptr), tensor_size));
+    }
     CNRT_CHECK(cnrtMemset(data_node.device_ptr, 0, tensor_size));
     base_op.datas.push_back(data_node);
   }
+  base_op.device_pooled = device_buffers != NULL;
 
   // copy input from host to device
   for (int i = 0; i < param_info.input_num; ++i) {
-    if (param_info.dtype == CNNL_DTYPE_HALF) {
+    if (i < (int)param_info.input_files.size()) {
+      // the payload is in the data type of the device, copied from the mapped pages
+      MappedNpy npy;
+      std::string error;
+      if (!npy.open(param_info.input_files[i], error)) {
+        throw std::runtime_error(error);
+      }
+      CNRT_CHECK(cnrtMemcpy(base_op.datas[i].device_ptr, npy.data(), npy.dataBytes(),
+                            CNRT_MEM_TRANS_DIR_HOST2DEV));
+    } else if (param_info.dtype == CNNL_DTYPE_HALF) {
       // convert float32 data to half type for device compute
       char *temp_half = (char *)malloc(element_num * 2 * sizeof(char));
       CNRT_CHECK(cnrtCastDataType(base_op.datas[i].host_ptr, CNRT_FLOAT32, temp_half, CNRT_FLOAT16,
@@ -287,6 +685,9 @@ void prepareTestData(const ParamInfo &param_info, BaseOp &base_op) {
       CNRT_CHECK(cnrtMemcpy(base_op.datas[i].device_ptr, temp_half, tensor_size,
                             CNRT_MEM_TRANS_DIR_HOST2DEV));
       free(temp_half);
+    } else if (is_integer) {
+      copyIntegerData(param_info.dtype, base_op.datas[i].host_ptr, base_op.datas[i].device_ptr,
+                      element_num, true);
     } else {
       CNRT_CHECK(cnrtMemcpy(base_op.datas[i].device_ptr, base_op.datas[i].host_ptr, tensor_size,
                             CNRT_MEM_TRANS_DIR_HOST2DEV));
@@ -294,63 +695,179 @@ void prepareTestData(const ParamInfo &param_info, BaseOp &base_op) {
   }
 }
 
-// call operation compute interface and sync task queue
-void deviceCompute(const cnnlHandle_t &handle,
-                   const cnrtQueue_t &queue,
+// call operation compute interface
+void launchCompute(const cnnlHandle_t &handle,
                    const ParamInfo &param_info,
                    const BaseOp &base_op) {
   switch (param_info.op_name) {
     case CNNL_ABS:
       CNNL_CHECK(cnnlAbs(handle, base_op.inputs[0], base_op.datas[0].device_ptr, base_op.outputs[0],
                          base_op.datas[1].device_ptr));
-      CNRT_CHECK(cnrtSyncQueue(queue));
+      break;
+    case CNNL_ABS_SIGN:
+      CNNL_CHECK(cnnlAbsSign(handle, base_op.inputs[0], base_op.datas[0].device_ptr,
+                             base_op.outputs[0], base_op.datas[1].device_ptr, base_op.outputs[1],
+                             base_op.datas[2].device_ptr));
       break;
     case CNNL_LOG:
       CNNL_CHECK(cnnlLog(handle, param_info.prefer, param_info.log_base, base_op.inputs[0],
                          base_op.datas[0].device_ptr, base_op.outputs[0],
                          base_op.datas[1].device_ptr));
-      CNRT_CHECK(cnrtSyncQueue(queue));
       break;
     case CNNL_SQRT:
       CNNL_CHECK(cnnlSqrt(handle, param_info.prefer, base_op.inputs[0], base_op.datas[0].device_ptr,
                           base_op.outputs[0], base_op.datas[1].device_ptr));
-      CNRT_CHECK(cnrtSyncQueue(queue));
       break;
     case CNNL_DIV:
       CNNL_CHECK(cnnlDiv(handle, param_info.prefer, base_op.inputs[0], base_op.datas[0].device_ptr,
                          base_op.inputs[1], base_op.datas[1].device_ptr, base_op.outputs[0],
                          base_op.datas[2].device_ptr));
-      CNRT_CHECK(cnrtSyncQueue(queue));
+      break;
+    case CNNL_DIV_ROUND:
+      CNNL_CHECK(cnnlDivRound(handle, param_info.round_mode, base_op.inputs[0],
+                              base_op.datas[0].device_ptr, base_op.inputs[1],
+                              base_op.datas[1].device_ptr, base_op.outputs[0],
+                              base_op.datas[2].device_ptr));
       break;
     case CNNL_SQRT_BACKWARD:
       CNNL_CHECK(cnnlSqrtBackward(handle, base_op.inputs[0], base_op.datas[0].device_ptr,
                                   base_op.inputs[1], base_op.datas[1].device_ptr,
                                   base_op.outputs[0], base_op.datas[2].device_ptr));
-      CNRT_CHECK(cnrtSyncQueue(queue));
+      break;
+    case CNNL_RECIPROCAL:
+      CNNL_CHECK(cnnlReciprocal(handle, param_info.prefer, base_op.inputs[0],
+                                base_op.datas[0].device_ptr, base_op.outputs[0],
+                                base_op.datas[1].device_ptr));
+      break;
+    case CNNL_DIV_EPS:
+      CNNL_CHECK(cnnlDivEps(handle, param_info.prefer, param_info.eps, param_info.zero_mode,
+                            base_op.inputs[0], base_op.datas[0].device_ptr, base_op.inputs[1],
+                            base_op.datas[1].device_ptr, base_op.outputs[0],
+                            base_op.datas[2].device_ptr));
+      break;
+    case CNNL_ADAM_UPDATE:
+      CNNL_CHECK(cnnlAdamUpdate(handle, param_info.lr, param_info.beta1, param_info.beta2,
+                                param_info.eps, param_info.step, base_op.inputs[0],
+                                base_op.datas[0].device_ptr, base_op.inputs[1],
+                                base_op.datas[1].device_ptr, base_op.inputs[2],
+                                base_op.datas[2].device_ptr, base_op.inputs[3],
+                                base_op.datas[3].device_ptr));
+      break;
+    case CNNL_RMSPROP_UPDATE:
+      CNNL_CHECK(cnnlRmspropUpdate(handle, param_info.lr, param_info.rho, param_info.eps,
+                                   base_op.inputs[0], base_op.datas[0].device_ptr,
+                                   base_op.inputs[1], base_op.datas[1].device_ptr,
+                                   base_op.inputs[2], base_op.datas[2].device_ptr));
+      break;
+    case CNNL_REDUCE_LAST_DIM:
+      CNNL_CHECK(cnnlReduceLastDim(handle, param_info.reduce_op, base_op.inputs[0],
+                                   base_op.datas[0].device_ptr, base_op.outputs[0],
+                                   base_op.datas[1].device_ptr));
       break;
     default:
       return;
   }
 }
 
+// call operation compute interface and sync task queue
+void deviceCompute(const cnnlHandle_t &handle,
+                   const cnrtQueue_t &queue,
+                   const ParamInfo &param_info,
+                   const BaseOp &base_op) {
+  launchCompute(handle, param_info, base_op);
+  if (param_info.op_name == CNNL_ADAM_UPDATE || param_info.op_name == CNNL_RMSPROP_UPDATE) {
+    // the update is in place, the new param is the output
+    CNRT_CHECK(cnrtMemcpy(base_op.datas[param_info.input_num].device_ptr,
+                          base_op.datas[0].device_ptr, base_op.datas[0].size,
+                          CNRT_MEM_TRANS_DIR_DEV2DEV));
+  }
+  CNRT_CHECK(cnrtSyncQueue(queue));
+}
+
+void benchmarkCompute(const cnnlHandle_t &handle,
+                      const cnrtQueue_t &queue,
+                      const ParamInfo &param_info,
+                      const BaseOp &base_op,
+                      BenchResult &result) {
+  for (int i = 0; i < param_info.warmup; ++i) {
+    launchCompute(handle, param_info, base_op);
+  }
+  CNRT_CHECK(cnrtSyncQueue(queue));
+  CNNL_CHECK(cnnlResetHandleStatistics(handle));
+
+  cnrtNotifier_t notifier_start = NULL, notifier_end = NULL;
+  CNRT_CHECK(cnrtCreateNotifier(&notifier_start));
+  CNRT_CHECK(cnrtCreateNotifier(&notifier_end));
+  result.samples_us.clear();
+  for (int i = 0; i < param_info.iters; ++i) {
+    CNRT_CHECK(cnrtPlaceNotifier(notifier_start, queue));
+    launchCompute(handle, param_info, base_op);
+    CNRT_CHECK(cnrtPlaceNotifier(notifier_end, queue));
+    CNRT_CHECK(cnrtSyncQueue(queue));
+    float device_us = 0;
+    CNRT_CHECK(cnrtNotifierDuration(notifier_start, notifier_end, &device_us));
+    result.samples_us.push_back(device_us);
+  }
+  CNRT_CHECK(cnrtDestroyNotifier(&notifier_start));
+  CNRT_CHECK(cnrtDestroyNotifier(&notifier_end));
+
+  result.op     = name2Str(param_info.op_name);
+  result.dtype  = dtype2Str(param_info.dtype);
+  result.shape  = std::vector<int>(param_info.input_shape,
+                                  param_info.input_shape + param_info.dim_size);
+  result.prefer = param_info.prefer == CNNL_COMPUTATION_HIGH_PRECISION
+                      ? "accuracy"
+                      : (param_info.prefer == CNNL_COMPUTATION_APPROX ? "approx" : "fast");
+  result.warmup = param_info.warmup;
+  cnnlHandleStatistics_t stats;
+  CNNL_CHECK(cnnlGetHandleStatistics(handle, &stats));
+  for (int i = 0; i < stats.op_num; ++i) {
+    const cnnlOpStatistics_t &op = stats.ops[i];
+    if (result.op != op.op_name || op.calls == 0) {
+      continue;
+    }
+    result.bytes = op.bytes / op.calls;
+    uint64_t max_launches = 0;
+    for (int j = 0; j < op.kernel_num; ++j) {
+      if (op.kernels[j].launches > max_launches) {
+        max_launches   = op.kernels[j].launches;
+        result.variant = op.kernels[j].kernel_name;
+      }
+    }
+  }
+}
+
 // copy result from device memory to host
 void copyResultOut(const ParamInfo &param_info, BaseOp &base_op) {
   DataAddrInfo output_node = base_op.datas[param_info.input_num];
-  if (param_info.dtype == CNNL_DTYPE_HALF) {
+  if (!param_info.dump_path.empty()) {
+    MappedNpy npy;
+    std::string error;
+    std::vector<int> shape(param_info.output_shape, param_info.output_shape + param_info.dim_size);
+    if (!npy.create(param_info.dump_path, npyDescr(param_info.dtype), shape, error)) {
+      throw std::runtime_error(error);
+    }
+    CNRT_CHECK(cnrtMemcpy(npy.data(), output_node.device_ptr, npy.dataBytes(),
+                          CNRT_MEM_TRANS_DIR_DEV2HOST));
+  } else if (param_info.dtype == CNNL_DTYPE_HALF) {
     // convert device half result to float32
     char *temp_half = (char *)malloc(output_node.size);
     CNRT_CHECK(cnrtMemcpy(temp_half, output_node.device_ptr, output_node.size,
                           CNRT_MEM_TRANS_DIR_DEV2HOST));
     CNRT_CHECK(cnrtCastDataType(temp_half, CNRT_FLOAT16, output_node.host_ptr, CNRT_FLOAT32,
                                 output_node.size / 2, NULL));
+    free(temp_half);
+  } else if (isIntegerType(param_info.dtype)) {
+    copyIntegerData(param_info.dtype, output_node.host_ptr, output_node.device_ptr,
+                    output_node.size / getDataTypeSize(param_info.dtype), false);
   } else {
     CNRT_CHECK(cnrtMemcpy(output_node.host_ptr, output_node.device_ptr, output_node.size,
                           CNRT_MEM_TRANS_DIR_DEV2HOST));
   }
 }
 
-// free resources after compute
-void deviceAndHostFree(cnnlHandle_t &handle, cnrtQueue_t &queue, BaseOp &base_op) {
+// free the resources of a case after compute
+void freeTestData(BaseOp &base_op) {
   // destroy tensor descriptor
   for (auto &tensor : base_op.inputs) {
     CNNL_CHECK(cnnlDestroyTensorDescriptor(tensor));
@@ -358,14 +875,25 @@ void deviceAndHostFree(cnnlHandle_t &handle, cnrtQueue_t &queue, BaseOp &base_op
   for (auto &tensor : base_op.outputs) {
     CNNL_CHECK(cnnlDestroyTensorDescriptor(tensor));
   }
+  base_op.inputs.clear();
+  base_op.outputs.clear();
 
   // free device and host memory
   for (auto &data : base_op.datas) {
-    CNRT_CHECK(cnrtFree(data.device_ptr));
+    if (!base_op.device_pooled) {
+      CNRT_CHECK(cnrtFree(data.device_ptr));
+    }
     free(data.host_ptr);
   }
+  base_op.datas.clear();
+}
+
+// free resources after compute
+void deviceAndHostFree(cnnlHandle_t &handle, cnrtQueue_t &queue, BaseOp &base_op) {
+  freeTestData(base_op);
 
   // destroy queue and runtime context
   CNRT_CHECK(cnrtDestroyQueue(queue));
+  CNNL_CHECK(cnnlReleaseHandleStatistics(handle));
   CNNL_CHECK(cnnlDestroy(handle));
 }
@@ -12,13 +12,29 @@
 #ifndef TEST_TOOL_H_
 #define TEST_TOOL_H_
 
+#include <string>
 #include <vector>
+#include "bench_result.h"
 #include "cnnl_example.h"
+#include "random_data.h"
 #define PARAM_NUM 22
 #define MAX_DIM 8
 #define ARGC_NUM 5
 
-enum OpName { CNNL_ABS = 0, CNNL_LOG = 1, CNNL_SQRT = 2, CNNL_SQRT_BACKWARD = 3, CNNL_DIV = 4 };
+enum OpName {
+  CNNL_ABS             = 0,
+  CNNL_LOG             = 1,
+  CNNL_SQRT            = 2,
+  CNNL_SQRT_BACKWARD   = 3,
+  CNNL_DIV             = 4,
+  CNNL_RECIPROCAL      = 5,
+  CNNL_DIV_EPS         = 6,
+  CNNL_ADAM_UPDATE     = 7,
+  CNNL_RMSPROP_UPDATE  = 8,
+  CNNL_REDUCE_LAST_DIM = 9,
+  CNNL_ABS_SIGN        = 10,
+  CNNL_DIV_ROUND       = 11
+};
 
 struct ParamInfo {
   int input_shape[MAX_DIM];
@@ -29,7 +45,25 @@ struct ParamInfo {
   cnnlDataType_t dtype;
   OpName op_name;
   cnnlLogBase_t log_base;
+  float eps                       = 0;
+  cnnlDivZeroMode_t zero_mode     = CNNL_DIV_ZERO_NONE;
+  float lr                        = 0.001;  // hyperparameters of the optimizer updates
+  float beta1                     = 0.9;
+  float beta2                     = 0.999;
+  float rho                       = 0.99;
+  int step                        = 1;
+  cnnlReduceLastDimOp_t reduce_op = CNNL_REDUCE_LAST_DIM_SUM;
+  bool sign_int8                  = false;  // the sign of cnnlAbsSign in int8
+  cnnlDivRoundMode_t round_mode   = CNNL_DIV_ROUND_TRUNC;
   cnnlComputationPreference_t prefer;
+  int warmup = 2;  // benchmark mode when iters > 0, see benchmarkCompute
+  int iters  = 0;
+  std::vector<std::vector<int>> shapes;  // --shapes, the input shapes of the benchmark sweep
+  std::string json_path;                 // --json, the benchmark results, stdout if empty
+  uint64_t seed   = 0;                   // --seed of the input data, random when not given
+  RandomDist dist = RANDOM_UNIFORM;      // --dist of the input data
+  std::vector<std::string> input_files;  // --input, .npy files instead of the random data
+  std::string dump_path;                 // --dump_output, the .npy file of the output
 };
 
 struct DataAddrInfo {
@@ -42,24 +76,60 @@ struct BaseOp {
   std::vector<cnnlTensorDescriptor_t> inputs;
   std::vector<cnnlTensorDescriptor_t> outputs;
   std::vector<DataAddrInfo> datas;
+  bool device_pooled = false;  // the device_ptr of datas belong to a BufferPool, see case_list.h
 };
 
 void parseParam(int argc, char *argv[], ParamInfo &param_info);
 
+// Parses an --iters value, aborts with an error below 1.
+void getItersValue(const char *iters, int &value);
+
 void printTestParam(const ParamInfo &param_info);
 
+std::string name2Str(const OpName &op_name);
+
+// the --data_type value of dtype
+std::string dtype2Str(const cnnlDataType_t dtype);
+
+// sets the input shape, and the output shape of the operation for it
+void setCaseShape(const std::vector<int> &shape, ParamInfo &param_info);
+
 void initDevice(cnrtDev_t &dev, cnrtQueue_t &queue, cnnlHandle_t &handle);
 
 void createDeviceDesc(const ParamInfo &param_info, BaseOp &base_op);
 
-void prepareTestData(const ParamInfo &param_info, BaseOp &base_op);
+size_t getDataTypeSize(const cnnlDataType_t dtype);
+
+// device_buffers, when given, are used instead of allocating the device memory of the case
+void prepareTestData(const ParamInfo &param_info,
+                     BaseOp &base_op,
+                     const std::vector<void *> *device_buffers = NULL);
+
+// launches the operation on the queue of handle without waiting for it
+void launchCompute(const cnnlHandle_t &handle,
+                   const ParamInfo &param_info,
+                   const BaseOp &base_op);
 
 void deviceCompute(const cnnlHandle_t &handle,
                    const cnrtQueue_t &queue,
                    const ParamInfo &param_info,
                    const BaseOp &base_op);
 
+/* Launches the operation param_info.warmup times, then times param_info.iters launches one by
+ * one with queue notifiers. The kernel variant and the bytes moved come from the counters of
+ * cnnlGetHandleStatistics over the timed launches.
+ */
+void benchmarkCompute(const cnnlHandle_t &handle,
+                      const cnrtQueue_t &queue,
+                      const ParamInfo &param_info,
+                      const BaseOp &base_op,
+                      BenchResult &result);
+
+// copies the output to host, or with --dump_output from the device into the mapped file
 void copyResultOut(const ParamInfo &param_info, BaseOp &base_op);
 
+// frees the descriptors and the data of a case, the handle and the queue are kept
+void freeTestData(BaseOp &base_op);
+
 void deviceAndHostFree(cnnlHandle_t &handle, cnrtQueue_t &queue, BaseOp &base_op);
 #endif  // TEST_TOOL_H_
@@ -0,0 +1,116 @@
+/*************************************************************************
+ * Copyright (C) 2021 Cambricon.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *************************************************************************/
+// Runs the partition of kernels/union_partition.h on the host for UNION1, UNION2 and
+// UNION4 launches of the 5stage and 3stage kernels, checks that every element is covered
+// exactly once. usage: ./union_partition_sim
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "kernels/union_partition.h"
+
+#define SIM_CORE_DIM 4  // CORE_DIM of kernels/kernel.h
+
+typedef std::vector<std::pair<int64_t, int64_t> > Ranges;  // [begin, end) of each copy
+
+static int failed_num = 0;
+
+static bool checkCover(Ranges &ranges, int32_t num_total, const char *pipeline, int width,
+                       int cluster_num) {
+  std::sort(ranges.begin(), ranges.end());
+  int64_t next = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (ranges[i].first == ranges[i].second) {
+      continue;
+    }
+    if (ranges[i].first != next) {
+      printf("FAIL %s UNION%d clusters %d num %d: element %lld %s\n", pipeline, width,
+             cluster_num, num_total, (long long)next,
+             ranges[i].first > next ? "not covered" : "covered twice");
+      failed_num++;
+      return false;
+    }
+    next = ranges[i].second;
+  }
+  if (next != num_total) {
+    printf("FAIL %s UNION%d clusters %d num %d: covered up to %lld\n", pipeline, width,
+           cluster_num, num_total, (long long)next);
+    failed_num++;
+    return false;
+  }
+  return true;
+}
+
+// Elements computed by each core of block5Unary, kernels/unary_op/unary_op_5pipeline.h.
+static bool simulate5Stage(int32_t num_total, int width, int task_dim_y, int32_t num_deal) {
+  Ranges ranges;
+  int32_t cluster_num = task_dim_y * width;
+  for (int task_y = 0; task_y < task_dim_y; ++task_y) {
+    for (int cluster = 0; cluster < width; ++cluster) {
+      int32_t cluster_idx     = task_y * width + cluster;
+      int64_t base            = partitionBegin(num_total, cluster_num, cluster_idx);
+      int32_t num_per_cluster = partitionNum(num_total, cluster_num, cluster_idx);
+      int32_t num_pong        = num_deal * SIM_CORE_DIM;
+      int32_t repeat          = num_per_cluster / num_pong;
+      int32_t rem             = num_per_cluster % num_pong;
+      for (int core = 0; core < SIM_CORE_DIM; ++core) {
+        for (int32_t i = 0; i < repeat; ++i) {
+          int64_t begin = base + (int64_t)i * num_pong + core * num_deal;
+          ranges.push_back(std::make_pair(begin, begin + num_deal));
+        }
+        int64_t begin = base + (int64_t)repeat * num_pong + partitionBegin(rem, SIM_CORE_DIM, core);
+        ranges.push_back(std::make_pair(begin, begin + partitionNum(rem, SIM_CORE_DIM, core)));
+      }
+    }
+  }
+  return checkCover(ranges, num_total, "5stage", width, cluster_num);
+}
+
+// Elements of each task of block3Unary, which splits over taskDim whatever the union.
+static bool simulate3Stage(int32_t num_total, int width, int task_dim_y) {
+  Ranges ranges;
+  int32_t task_dim     = task_dim_y * width * SIM_CORE_DIM;
+  int32_t num_per_core = num_total / task_dim;
+  for (int32_t task = 0; task < task_dim; ++task) {
+    int64_t begin = (int64_t)task * num_per_core;
+    int32_t num   = num_per_core + (task == task_dim - 1 ? num_total % task_dim : 0);
+    ranges.push_back(std::make_pair(begin, begin + num));
+  }
+  return checkCover(ranges, num_total, "3stage", width, task_dim_y * width);
+}
+
+int main() {
+  const int cluster_limits[] = {1, 2, 4, 8, 16};
+  const int32_t num_deals[]  = {64, 49152};
+  const int32_t num_totals[] = {1, 255, 4096, 196608 * 4 + 17, 1 << 22, (1 << 24) + 3,
+                                (1 << 26) + 1000, 1 << 28};
+  int passed_num = 0, case_num = 0;
+  int width_count[5] = {0};
+  for (int cluster_limit : cluster_limits) {
+    for (int32_t num_total : num_totals) {
+      // the policies widen the union when the tensor fills every cluster
+      int width      = partitionUnionWidth((int64_t)num_total * 4, cluster_limit);
+      int task_dim_y = cluster_limit / width;
+      width_count[width]++;
+      for (int32_t num_deal : num_deals) {
+        passed_num += simulate5Stage(num_total, width, task_dim_y, num_deal) ? 1 : 0;
+        case_num++;
+      }
+      passed_num += simulate3Stage(num_total, width, task_dim_y) ? 1 : 0;
+      case_num++;
+    }
+  }
+  printf("%d/%d partitions passed, launches UNION1 %d, UNION2 %d, UNION4 %d\n", passed_num,
+         case_num, width_count[1], width_count[2], width_count[4]);
+  return failed_num == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}